@@ -0,0 +1,217 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file ModelProblems.hpp
+ * \brief Generators for the sparse model problems used in the
+ * benchmarks: Poisson, convection-diffusion, Helmholtz and linear
+ * elasticity on regular 2D/3D grids, with Dirichlet boundary
+ * conditions.
+ */
+#ifndef STRUMPACK_BENCHMARK_MODEL_PROBLEMS_HPP
+#define STRUMPACK_BENCHMARK_MODEL_PROBLEMS_HPP
+
+#include <cmath>
+#include <vector>
+#include <string>
+#include <complex>
+#include <functional>
+
+#include "sparse/CSRMatrix.hpp"
+
+namespace strumpack {
+  namespace bench {
+
+    /**
+     * A generated model problem: the matrix and the grid information
+     * needed for the geometric nested dissection.
+     */
+    template<typename scalar_t,typename integer_t>
+    struct ModelProblem {
+      CSRMatrix<scalar_t,integer_t> A;
+      int nx = 1, ny = 1, nz = 1, components = 1, width = 1;
+    };
+
+    /*
+     * Build a CSR matrix row by row. For every row, the stencil
+     * function is called with an add(col, value) callback.
+     */
+    template<typename scalar_t,typename integer_t> CSRMatrix<scalar_t,integer_t>
+    build_csr(integer_t n, integer_t nnz_est,
+              const std::function<void(integer_t,std::function
+                                       <void(integer_t,scalar_t)>)>& row,
+              bool symm_sparse=true) {
+      std::vector<integer_t> ptr(n+1), ind;
+      std::vector<scalar_t> val;
+      ind.reserve(nnz_est);
+      val.reserve(nnz_est);
+      ptr[0] = 0;
+      for (integer_t i=0; i<n; i++) {
+        row(i, [&](integer_t j, scalar_t v) {
+                 ind.push_back(j);
+                 val.push_back(v);
+               });
+        ptr[i+1] = ind.size();
+      }
+      CSRMatrix<scalar_t,integer_t> A
+        (n, ptr.data(), ind.data(), val.data(), symm_sparse);
+      return A;
+    }
+
+    /**
+     * 5-point (2D, nz == 1) or 7-point (3D) finite difference
+     * Laplacian, scaled by h^2, plus an optional (complex) shift:
+     * -h^2 Delta u + shift u.
+     */
+    template<typename scalar_t,typename integer_t>
+    ModelProblem<scalar_t,integer_t>
+    laplacian(int nx, int ny, int nz, scalar_t shift=scalar_t(0.)) {
+      ModelProblem<scalar_t,integer_t> p;
+      p.nx = nx; p.ny = ny; p.nz = nz;
+      int d = (nz > 1) ? 3 : 2;
+      integer_t n = integer_t(nx) * ny * nz;
+      p.A = build_csr<scalar_t,integer_t>
+        (n, (2*d+1)*n, [&](integer_t i, std::function
+                           <void(integer_t,scalar_t)> add) {
+          integer_t x = i % nx, y = (i / nx) % ny, z = i / (nx*ny);
+          add(i, scalar_t(2.*d) + shift);
+          if (x > 0)    add(i-1, scalar_t(-1.));
+          if (x < nx-1) add(i+1, scalar_t(-1.));
+          if (y > 0)    add(i-nx, scalar_t(-1.));
+          if (y < ny-1) add(i+nx, scalar_t(-1.));
+          if (z > 0)    add(i-nx*ny, scalar_t(-1.));
+          if (z < nz-1) add(i+nx*ny, scalar_t(-1.));
+        });
+      return p;
+    }
+
+    /**
+     * Convection-diffusion, -Delta u + beta . grad u, with first
+     * order upwinding for the convection term, scaled by h^2. The
+     * velocity is beta in every direction. The matrix is
+     * nonsymmetric, but has a symmetric sparsity pattern.
+     */
+    template<typename scalar_t,typename integer_t>
+    ModelProblem<scalar_t,integer_t>
+    convection_diffusion(int nx, int ny, int nz, double beta) {
+      ModelProblem<scalar_t,integer_t> p;
+      p.nx = nx; p.ny = ny; p.nz = nz;
+      int d = (nz > 1) ? 3 : 2;
+      integer_t n = integer_t(nx) * ny * nz;
+      // h * beta, with h = 1 / (nx+1)
+      double hb = std::abs(beta) / (nx + 1);
+      scalar_t up(-1. - hb), down(-1.);
+      if (beta < 0) std::swap(up, down);
+      p.A = build_csr<scalar_t,integer_t>
+        (n, (2*d+1)*n, [&](integer_t i, std::function
+                           <void(integer_t,scalar_t)> add) {
+          integer_t x = i % nx, y = (i / nx) % ny, z = i / (nx*ny);
+          add(i, scalar_t(2.*d + d*hb));
+          if (x > 0)    add(i-1, up);
+          if (x < nx-1) add(i+1, down);
+          if (y > 0)    add(i-nx, up);
+          if (y < ny-1) add(i+nx, down);
+          if (d == 3) {
+            if (z > 0)    add(i-nx*ny, up);
+            if (z < nz-1) add(i+nx*ny, down);
+          }
+        });
+      return p;
+    }
+
+    /**
+     * 3D Helmholtz equation, -Delta u - k^2 (1 + i eps) u, with a
+     * fixed number of points per wavelength (the wavenumber grows
+     * with the grid size) and a small damping eps.
+     */
+    template<typename real_t,typename integer_t>
+    ModelProblem<std::complex<real_t>,integer_t>
+    helmholtz(int nx, int ny, int nz, double ppw=10., double eps=0.01) {
+      const double pi = 3.14159265358979323846;
+      // (k h)^2, with k h = 2 pi / ppw
+      double kh2 = std::pow(2. * pi / ppw, 2);
+      return laplacian<std::complex<real_t>,integer_t>
+        (nx, ny, nz, std::complex<real_t>(-kh2, -kh2 * eps));
+    }
+
+    /**
+     * 3D linear elasticity, -mu Delta u - (lambda + mu) grad div u,
+     * finite differences on a regular grid with 3 degrees of freedom
+     * per grid point (interleaved), scaled by h^2. The mixed
+     * derivatives use the 4 diagonal neighbors, giving a 19-point
+     * stencil per component. The matrix is symmetric positive
+     * definite.
+     */
+    template<typename scalar_t,typename integer_t>
+    ModelProblem<scalar_t,integer_t>
+    elasticity(int nx, int ny, int nz, double lambda=1., double mu=1.) {
+      ModelProblem<scalar_t,integer_t> p;
+      p.nx = nx; p.ny = ny; p.nz = nz; p.components = 3;
+      int ld[3] = {nx, ny, nz};
+      integer_t n = 3 * integer_t(nx) * ny * nz;
+      p.A = build_csr<scalar_t,integer_t>
+        (n, 19*n, [&](integer_t i, std::function
+                      <void(integer_t,scalar_t)> add) {
+          int a = i % 3;
+          integer_t g = i / 3;
+          int c[3] = {int(g % nx), int((g / nx) % ny), int(g / (nx*ny))};
+          auto dof = [&](int dx, int dy, int dz, int comp) -> integer_t {
+            int q[3] = {c[0]+dx, c[1]+dy, c[2]+dz};
+            for (int k=0; k<3; k++)
+              if (q[k] < 0 || q[k] >= ld[k]) return -1;
+            return comp + 3 * (q[0] + integer_t(nx) * (q[1] + integer_t(ny) * q[2]));
+          };
+          add(i, scalar_t(6. * mu + 2. * (lambda + mu)));
+          for (int k=0; k<3; k++) {
+            double v = (k == a) ? -(lambda + 2. * mu) : -mu;
+            int o[3] = {0, 0, 0};
+            for (int s : {-1, 1}) {
+              o[k] = s;
+              auto j = dof(o[0], o[1], o[2], a);
+              if (j >= 0) add(j, scalar_t(v));
+            }
+          }
+          // coupling to the other components, d^2 u_b / dx_a dx_b
+          for (int b=0; b<3; b++) {
+            if (b == a) continue;
+            for (int sa : {-1, 1})
+              for (int sb : {-1, 1}) {
+                int o[3] = {0, 0, 0};
+                o[a] = sa; o[b] = sb;
+                auto j = dof(o[0], o[1], o[2], b);
+                if (j >= 0) add(j, scalar_t(-(lambda + mu) * sa * sb / 4.));
+              }
+          }
+        });
+      return p;
+    }
+
+  } // end namespace bench
+} // end namespace strumpack
+
+#endif // STRUMPACK_BENCHMARK_MODEL_PROBLEMS_HPP
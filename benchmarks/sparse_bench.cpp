@@ -0,0 +1,385 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <complex>
+#include <cmath>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "StrumpackSparseSolver.hpp"
+#include "ModelProblems.hpp"
+
+using namespace strumpack;
+
+/*
+ * Benchmark driver for the sparse solver. Generates model problems
+ * in-process, runs reorder/factor/solve for every combination of the
+ * requested problems, grid sizes, compression types, outer solvers
+ * and thread counts, and writes the results as JSON or CSV.
+ *
+ * Example:
+ *   ./sparse_bench --problem poisson3d,elasticity3d --n 40,60 \
+ *       --compression none,blr --krylov auto --threads 1,8 \
+ *       --format json --output results.json --sp_blr_rel_tol 1e-4
+ *
+ * Options not recognized by the driver are passed on to the solver,
+ * see SPOptions.
+ */
+
+namespace {
+
+  std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> l;
+    std::istringstream iss(s);
+    std::string w;
+    while (std::getline(iss, w, ','))
+      if (!w.empty()) l.push_back(w);
+    return l;
+  }
+
+  struct Config {
+    std::string problem;
+    int n = 0;
+    std::string compression, krylov;
+    int threads = 1, run = 0;
+  };
+
+  // one line of output, values are kept in insertion order
+  class Record {
+  public:
+    void add(const std::string& k, const std::string& v)
+    { kv_.push_back({k, "\"" + v + "\""}); str_.push_back(true); }
+    template<typename T> void add(const std::string& k, T v) {
+      std::ostringstream os;
+      os << std::setprecision(10);
+      if (std::isfinite(double(v))) os << v;
+      else os << "null";
+      kv_.push_back({k, os.str()});
+      str_.push_back(false);
+    }
+    void add(const std::string& k, bool v)
+    { kv_.push_back({k, v ? "true" : "false"}); str_.push_back(false); }
+
+    void json(std::ostream& os) const {
+      os << "    {";
+      for (std::size_t i=0; i<kv_.size(); i++)
+        os << (i ? ", " : "") << "\"" << kv_[i].first << "\": "
+           << kv_[i].second;
+      os << "}";
+    }
+    void csv_header(std::ostream& os) const {
+      for (std::size_t i=0; i<kv_.size(); i++)
+        os << (i ? "," : "") << kv_[i].first;
+      os << std::endl;
+    }
+    void csv(std::ostream& os) const {
+      for (std::size_t i=0; i<kv_.size(); i++) {
+        auto v = kv_[i].second;
+        if (str_[i]) v = v.substr(1, v.size()-2);
+        else if (v == "null") v = "";
+        os << (i ? "," : "") << v;
+      }
+      os << std::endl;
+    }
+  private:
+    std::vector<std::pair<std::string,std::string>> kv_;
+    std::vector<bool> str_;
+  };
+
+  bool set_compression(SPOptions<double>& o, const std::string& s) {
+    for (auto c : {CompressionType::NONE, CompressionType::HSS,
+                   CompressionType::BLR, CompressionType::HODLR,
+                   CompressionType::BLR_HODLR,
+                   CompressionType::ZFP_BLR_HODLR,
+                   CompressionType::LOSSY, CompressionType::LOSSLESS})
+      if (get_name(c) == s) { o.set_compression(c); return true; }
+    return false;
+  }
+  template<typename scalar_t> bool
+  set_compression(SPOptions<scalar_t>& o, const std::string& s) {
+    SPOptions<double> d;
+    if (!set_compression(d, s)) return false;
+    o.set_compression(d.compression());
+    return true;
+  }
+
+  template<typename scalar_t> bool
+  set_Krylov_solver(SPOptions<scalar_t>& o, const std::string& s) {
+    // same names as the --sp_Krylov_solver option
+    const std::pair<const char*,KrylovSolver> names[] =
+      {{"auto", KrylovSolver::AUTO}, {"direct", KrylovSolver::DIRECT},
+       {"refinement", KrylovSolver::REFINE},
+       {"pgmres", KrylovSolver::PREC_GMRES},
+       {"gmres", KrylovSolver::GMRES},
+       {"pbicgstab", KrylovSolver::PREC_BICGSTAB},
+       {"bicgstab", KrylovSolver::BICGSTAB}};
+    for (auto& k : names)
+      if (s == k.first) { o.set_Krylov_solver(k.second); return true; }
+    return false;
+  }
+
+  // params::memory and params::peak_memory are process wide, reset
+  // them so the peak reported for a configuration does not include
+  // the solvers of earlier configurations
+  void reset_memory_counters() {
+#if defined(STRUMPACK_COUNT_FLOPS)
+    params::memory = 0;
+    params::peak_memory = 0;
+#endif
+  }
+
+  template<typename scalar_t> Record
+  run(bench::ModelProblem<scalar_t,int>& p, const Config& c,
+      const std::vector<const char*>& sp_args) {
+    reset_memory_counters();
+    Record r;
+    r.add("problem", c.problem);
+    r.add("n", c.n);
+    r.add("N", p.A.size());
+    r.add("nnz", p.A.nnz());
+    r.add("scalar", std::string
+          (std::is_same<scalar_t,double>::value ? "double" : "complex"));
+    r.add("compression", c.compression);
+    r.add("krylov", c.krylov);
+    r.add("threads", c.threads);
+    r.add("run", c.run);
+
+#if defined(_OPENMP)
+    omp_set_num_threads(c.threads);
+    params::num_threads = c.threads;
+#endif
+    SparseSolver<scalar_t,int> sp(false);
+    auto& o = sp.options();
+    o.set_matching(MatchingJob::NONE);
+    o.set_reordering_method(ReorderingStrategy::GEOMETRIC);
+    set_compression(o, c.compression);
+    set_Krylov_solver(o, c.krylov);
+    o.set_from_command_line(sp_args.size(), sp_args.data());
+
+    int N = p.A.size();
+    DenseMatrix<scalar_t> b(N, 1), x(N, 1), x_exact(N, 1);
+    x_exact.fill(scalar_t(1.));
+    p.A.spmv(x_exact, b);
+
+    sp.set_matrix(p.A);
+    auto ierr = sp.reorder(p.nx, p.ny, p.nz, p.components, p.width);
+    if (ierr == ReturnCode::SUCCESS) ierr = sp.factor();
+    if (ierr == ReturnCode::SUCCESS) ierr = sp.solve(b, x);
+    std::ostringstream code;
+    code << ierr;
+    r.add("return_code", code.str());
+
+    auto s = sp.statistics();
+    r.add("reorder_time", s.reorder.time);
+    r.add("symbolic_time", s.symbolic.time);
+    r.add("separator_reorder_time", s.separator_reordering.time);
+    r.add("factor_time", s.factor.time);
+    r.add("solve_time", s.solve.time);
+    r.add("factor_flops", s.factor.flops);
+    r.add("factor_dense_flops", s.factor_dense_flops);
+    r.add("factor_compressed_flops", s.factor_compressed_flops);
+    for (auto f : {std::make_pair("dense", &s.factor_fronts.dense),
+                   std::make_pair("half", &s.factor_fronts.half),
+                   std::make_pair("lossy", &s.factor_fronts.lossy),
+                   std::make_pair("lossless", &s.factor_fronts.lossless),
+                   std::make_pair("BLR", &s.factor_fronts.BLR),
+                   std::make_pair("HSS", &s.factor_fronts.HSS),
+                   std::make_pair("HODLR", &s.factor_fronts.HODLR)}) {
+      std::string k = std::string("fronts_") + f.first;
+      r.add(k + "_count", f.second->fronts);
+      r.add(k + "_time", f.second->time);
+      r.add(k + "_flops", f.second->flops);
+    }
+    r.add("factor_gflops", s.factor.gflops());
+    r.add("solve_flops", s.solve.flops);
+    r.add("solve_bytes", s.solve.bytes);
+    r.add("factor_nonzeros", s.factor_nonzeros);
+    r.add("factor_memory", s.factor_memory);
+    r.add("peak_memory", s.peak_memory);
+    r.add("maximum_rank", ierr == ReturnCode::SUCCESS ?
+          sp.maximum_rank() : 0);
+    r.add("krylov_iterations", s.Krylov_iterations);
+    if (ierr == ReturnCode::SUCCESS) {
+      r.add("scaled_residual",
+            double(p.A.max_scaled_residual(x.data(), b.data())));
+      x.scaled_add(scalar_t(-1.), x_exact);
+      r.add("relative_error", double(x.normF() / x_exact.normF()));
+    } else {
+      r.add("scaled_residual", std::nan(""));
+      r.add("relative_error", std::nan(""));
+    }
+    return r;
+  }
+
+  void usage() {
+    std::cout
+      << "Usage: sparse_bench [options] [solver options]\n"
+      << "  --problem p1,p2,..    poisson2d, poisson3d, convdiff2d,\n"
+      << "                        convdiff3d, helmholtz3d, elasticity3d\n"
+      << "                        (default poisson3d)\n"
+      << "  --n n1,n2,..          grid points per dimension (default 30)\n"
+      << "  --compression c1,..   none, hss, blr, hodlr, blr_hodlr,\n"
+      << "                        zfp_blr_hodlr, lossy, lossless"
+      << " (default none)\n"
+      << "  --krylov k1,..        auto, direct, refinement, pgmres, gmres,\n"
+      << "                        pbicgstab, bicgstab (default auto)\n"
+      << "  --threads t1,..       number of OpenMP threads"
+      << " (default: all)\n"
+      << "  --repeat r            number of runs per configuration"
+      << " (default 1)\n"
+      << "  --beta b              convection velocity (default 100)\n"
+      << "  --format json|csv     output format (default json)\n"
+      << "  --output file         output file (default stdout)\n"
+      << "  -h, --help            print this message\n"
+      << "All other options are passed to the sparse solver, see\n"
+      << "--sp_help.\n" << std::endl;
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> problems = {"poisson3d"},
+    compressions = {"none"}, krylovs = {"auto"};
+  std::vector<int> ns = {30}, threads;
+  int repeat = 1;
+  double beta = 100.;
+  std::string format = "json", output;
+  std::vector<const char*> sp_args = {argv[0]};
+  for (int i=1; i<argc; i++) {
+    std::string a = argv[i];
+    if (a == "-h" || a == "--help") { usage(); return 0; }
+    if (i+1 < argc) {
+      std::string v = argv[i+1];
+      bool used = true;
+      if (a == "--problem") problems = split(v);
+      else if (a == "--n") {
+        ns.clear();
+        for (auto& w : split(v)) ns.push_back(std::stoi(w));
+      } else if (a == "--compression") compressions = split(v);
+      else if (a == "--krylov") krylovs = split(v);
+      else if (a == "--threads") {
+        threads.clear();
+        for (auto& w : split(v)) threads.push_back(std::stoi(w));
+      } else if (a == "--repeat") repeat = std::stoi(v);
+      else if (a == "--beta") beta = std::stod(v);
+      else if (a == "--format") format = v;
+      else if (a == "--output") output = v;
+      else used = false;
+      if (used) { i++; continue; }
+    }
+    sp_args.push_back(argv[i]);
+  }
+  if (threads.empty()) threads.push_back(params::num_threads);
+  if (format != "json" && format != "csv") {
+    std::cerr << "ERROR: unknown output format " << format << std::endl;
+    return 1;
+  }
+  SPOptions<double> check;
+  for (auto& c : compressions)
+    if (!set_compression(check, c)) {
+      std::cerr << "ERROR: unknown compression type " << c << std::endl;
+      return 1;
+    }
+  for (auto& k : krylovs)
+    if (!set_Krylov_solver(check, k)) {
+      std::cerr << "ERROR: unknown Krylov solver " << k << std::endl;
+      return 1;
+    }
+
+  std::vector<Record> results;
+  for (auto& pname : problems)
+    for (auto n : ns) {
+      bench::ModelProblem<double,int> pd;
+      bench::ModelProblem<std::complex<double>,int> pz;
+      bool cplx = false;
+      if (pname == "poisson2d")
+        pd = bench::laplacian<double,int>(n, n, 1);
+      else if (pname == "poisson3d")
+        pd = bench::laplacian<double,int>(n, n, n);
+      else if (pname == "convdiff2d")
+        pd = bench::convection_diffusion<double,int>(n, n, 1, beta);
+      else if (pname == "convdiff3d")
+        pd = bench::convection_diffusion<double,int>(n, n, n, beta);
+      else if (pname == "elasticity3d")
+        pd = bench::elasticity<double,int>(n, n, n);
+      else if (pname == "helmholtz3d") {
+        pz = bench::helmholtz<double,int>(n, n, n);
+        cplx = true;
+      } else {
+        std::cerr << "ERROR: unknown problem " << pname << std::endl;
+        return 1;
+      }
+      for (auto& c : compressions)
+        for (auto& k : krylovs)
+          for (auto t : threads)
+            for (int r=0; r<repeat; r++) {
+              Config cfg;
+              cfg.problem = pname; cfg.n = n; cfg.compression = c;
+              cfg.krylov = k; cfg.threads = t; cfg.run = r;
+              std::cerr << "# " << pname << " n=" << n << " " << c
+                        << " " << k << " threads=" << t
+                        << " run=" << r << std::endl;
+              results.push_back
+                (cplx ? run(pz, cfg, sp_args) : run(pd, cfg, sp_args));
+              // the solver of this run has been destroyed
+              reset_memory_counters();
+            }
+    }
+
+  std::ofstream f;
+  if (!output.empty()) f.open(output);
+  std::ostream& os = output.empty() ? std::cout : f;
+  if (format == "json") {
+    os << "{" << std::endl
+       << "  \"strumpack_version\": \"" << STRUMPACK_VERSION_MAJOR << "."
+       << STRUMPACK_VERSION_MINOR << "." << STRUMPACK_VERSION_PATCH
+       << "\"," << std::endl
+#if defined(STRUMPACK_COUNT_FLOPS)
+       << "  \"count_flops\": true," << std::endl
+#else
+       << "  \"count_flops\": false," << std::endl
+#endif
+       << "  \"results\": [" << std::endl;
+    for (std::size_t i=0; i<results.size(); i++) {
+      results[i].json(os);
+      os << (i+1 < results.size() ? "," : "") << std::endl;
+    }
+    os << "  ]" << std::endl << "}" << std::endl;
+  } else {
+    if (!results.empty()) results[0].csv_header(os);
+    for (auto& r : results) r.csv(os);
+  }
+  return 0;
+}
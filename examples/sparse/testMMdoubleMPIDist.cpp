@@ -37,14 +37,12 @@
 using namespace strumpack;
 
 template<typename scalar,typename integer> void
-test(int argc, char* argv[], CSRMatrix<scalar,integer>& A) {
+test(int argc, char* argv[], CSRMatrixMPI<scalar,integer>& Adist) {
   int rank;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   StrumpackSparseSolverMPIDist<scalar,integer> spss(MPI_COMM_WORLD);
   spss.options().set_from_command_line(argc, argv);
 
-  // distribute/scatter the matrix A from the root
-  CSRMatrixMPI<scalar,integer> Adist(&A, MPI_COMM_WORLD, true);
   auto N = Adist.size();
   auto n_local = Adist.local_rows();
   std::vector<scalar> b(n_local), x(n_local), x_exact(n_local);
@@ -121,27 +119,25 @@ int main(int argc, char* argv[]) {
 
   std::string f(argv[1]);
 
-  CSRMatrix<double,int> A;
-  CSRMatrix<std::complex<double>,int> Acomplex;
+  // every process reads its own block of rows, using MPI-IO
+  CSRMatrixMPI<double,int> A;
+  CSRMatrixMPI<std::complex<double>,int> Acomplex;
   //---- For 64bit integers use this instead: --------
-  // CSRMatrix<double,int64_t> A;
-  // CSRMatrix<std::complex<double>,int64_t> Acomplex;
+  // CSRMatrixMPI<double,int64_t> A;
+  // CSRMatrixMPI<std::complex<double>,int64_t> Acomplex;
   //--------------------------------------------------
 
   bool is_complex = false;
-  if (rank == 0) {
-    if (A.read_binary(f)) {
-      if (A.read_matrix_market(f)) {
-        is_complex = true;
-        if (Acomplex.read_matrix_market(f)) {
+  if (A.read_binary(f)) {
+    if (A.read_matrix_market(f)) {
+      is_complex = true;
+      if (Acomplex.read_matrix_market(f)) {
+        if (!rank)
           std::cerr << "Could not read matrix from file." << std::endl;
-          return 1;
-        }
+        return 1;
       }
     }
-
   }
-  MPI_Bcast(&is_complex, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
   if (!is_complex)
     test(argc, argv, A);
   else
@@ -29,6 +29,7 @@
 #include <iostream>
 #include "StrumpackSparseSolver.hpp"
 #include "sparse/CSRMatrix.hpp"
+#include "misc/TaskTimer.hpp"
 
 typedef double scalar;
 typedef int integer;
@@ -93,5 +94,24 @@ int main(int argc, char* argv[]) {
   std::cout << "# COMPONENTWISE SCALED RESIDUAL = "
             << A.max_scaled_residual(x.data(), b.data()) << std::endl;
 
+#if defined(_OPENMP)
+  // solve scaling, time the solve phase with 1, 2, 4, ... threads
+  spss.options().set_verbose(false);
+  int T = omp_get_max_threads();
+  double t1 = 0.;
+  for (int t=1; ; t=std::min(2*t, T)) {
+    omp_set_num_threads(t);
+    TaskTimer timer("solve");
+    timer.start();
+    spss.solve(b, x);
+    timer.stop();
+    if (t == 1) t1 = timer.elapsed();
+    std::cout << "# solve time with " << t << " thread(s) = "
+              << timer.elapsed() << " sec, speedup = "
+              << t1 / timer.elapsed() << std::endl;
+    if (t == T) break;
+  }
+  omp_set_num_threads(T);
+#endif
   return 0;
 }
@@ -0,0 +1,114 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+#include "StrumpackSparseSolver.hpp"
+
+typedef double scalar;
+typedef int integer;
+
+using namespace strumpack;
+
+/*
+ * 2D Poisson problem on a randomly numbered and perturbed grid, to
+ * mimic an unstructured mesh. The nested dissection ordering is
+ * computed from the node coordinates, see SparseSolver::reorder.
+ */
+int main(int argc, char* argv[]) {
+  int n = 30;
+  if (argc > 1) n = atoi(argv[1]); // get grid size
+  else std::cout << "# please provide grid size" << std::endl;
+  std::cout << "solving 2D " << n << "x" << n
+            << " Poisson problem, with coordinates" << std::endl;
+
+  StrumpackSparseSolver<scalar,integer> spss;
+  spss.options().set_matching(MatchingJob::NONE);
+  spss.options().set_from_command_line(argc, argv);
+
+  integer N = n * n;
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> perturb(-.25, .25);
+  // random numbering of the grid points, and their coordinates
+  std::vector<integer> id(N);
+  std::iota(id.begin(), id.end(), 0);
+  std::shuffle(id.begin(), id.end(), gen);
+  DenseMatrix<double> coords(2, N);
+  for (integer row=0; row<n; row++)
+    for (integer col=0; col<n; col++) {
+      coords(0, id[col+n*row]) = col + perturb(gen);
+      coords(1, id[col+n*row]) = row + perturb(gen);
+    }
+
+  std::vector<std::vector<integer>> adj(N);
+  for (integer row=0; row<n; row++)
+    for (integer col=0; col<n; col++) {
+      auto& a = adj[id[col+n*row]];
+      a.push_back(id[col+n*row]);
+      if (col > 0)   a.push_back(id[col-1+n*row]); // left
+      if (col < n-1) a.push_back(id[col+1+n*row]); // right
+      if (row > 0)   a.push_back(id[col+n*(row-1)]); // up
+      if (row < n-1) a.push_back(id[col+n*(row+1)]); // down
+      std::sort(a.begin(), a.end());
+    }
+  integer nnz = 5 * N - 4 * n;
+  CSRMatrix<scalar,integer> A(N, nnz);
+  integer* ptr = A.ptr();
+  integer* ind = A.ind();
+  scalar* val = A.val();
+  ptr[0] = nnz = 0;
+  for (integer i=0; i<N; i++) {
+    for (auto j : adj[i]) {
+      val[nnz] = (i == j) ? 4.0 : -1.0;
+      ind[nnz++] = j;
+    }
+    ptr[i+1] = nnz;
+  }
+  A.set_symm_sparse();
+
+  DenseMatrix<scalar> b(N, 1), x(N, 1), x_exact(N, 1);
+  x_exact.random();
+  A.spmv(x_exact, b);
+
+  spss.set_csr_matrix(N, ptr, ind, val, true);
+  if (spss.reorder(coords) != ReturnCode::SUCCESS) {
+    std::cout << "problem with reordering of the matrix." << std::endl;
+    return 1;
+  }
+  spss.solve(b, x);
+
+  std::cout << "# COMPONENTWISE SCALED RESIDUAL = "
+            << A.max_scaled_residual(x, b) << std::endl;
+  x.scaled_add(-1., x_exact);
+  std::cout << "# relative error = ||x-x_exact||_F/||x_exact||_F = "
+            << x.normF() / x_exact.normF() << std::endl;
+  return 0;
+}
@@ -59,7 +59,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::setup_tree() {
     tree_.reset(new EliminationTree<scalar_t,integer_t>
-                (opts_, *mat_, nd_->tree()));
+                (opts_, *mat_, nd_->tree(), !schur_.empty()));
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -70,10 +70,15 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   SparseSolver<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
-    if (p) return nd_->set_permutation(opts_, *mat_, p, base);
-    return nd_->nested_dissection
-      (opts_, *mat_, nx, ny, nz, components, width);
+   int components, int width, const DenseMatrix<real_t>* coords) {
+    int ierr;
+    if (p) ierr = nd_->set_permutation(opts_, *mat_, p, base);
+    else if (coords) ierr = nd_->nested_dissection(opts_, *mat_, *coords);
+    else ierr = nd_->nested_dissection
+           (opts_, *mat_, nx, ny, nz, components, width);
+    if (!ierr && !schur_.empty())
+      nd_->move_to_root(schur_);
+    return ierr;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -81,10 +86,30 @@ namespace strumpack {
     nd_->separator_reordering(opts_, *mat_, tree_->root());
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::write_analysis(std::ostream& os) const {
+    nd_->write(os);
+    tree_->write_analysis(os);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::read_analysis(std::istream& is) {
+    setup_reordering();
+    nd_->read(is);
+    tree_.reset(new EliminationTree<scalar_t,integer_t>
+                (opts_, *mat_, nd_->tree(), is));
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::set_matrix
   (const CSRMatrix<scalar_t,integer_t>& A) {
-    mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
+    set_matrix(std::make_unique<CSRMatrix<scalar_t,integer_t>>(A));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::set_matrix
+  (std::unique_ptr<CSRMatrix<scalar_t,integer_t>> A) {
+    mat_ = std::move(A);
     factored_ = reordered_ = false;
   }
 
@@ -126,6 +151,18 @@ namespace strumpack {
     permute_matrix_values();
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::update_matrix_values
+  (std::unique_ptr<CSRMatrix<scalar_t,integer_t>> A) {
+    if (!(mat_ && A->size() == mat_->size() && A->nnz() <= mat_->nnz())) {
+      // matrix() has been made symmetric, can have more nonzeros
+      this->print_wrong_sparsity_error();
+      return;
+    }
+    mat_ = std::move(A);
+    permute_matrix_values();
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::set_csr_matrix
   (integer_t N, const integer_t* row_ptr, const integer_t* col_ind,
@@ -176,7 +213,7 @@ namespace strumpack {
   (DenseM_t& x, DenseM_t& xtmp) {
     integer_t N = matrix()->size(), d = x.cols();
     auto& P = reordering()->iperm();
-    if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+    if (matching_has_scaling(opts_.matching()))
       for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
         for (integer_t i=0; i<N; i++)
@@ -222,7 +259,7 @@ namespace strumpack {
 #pragma omp parallel for
         for (integer_t i=0; i<N; i++)
           x(matching_.Q[i], j) = xtmp(i, j);
-      if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+      if (matching_has_scaling(opts_.matching()))
         for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
           for (integer_t i=0; i<N; i++)
@@ -230,29 +267,247 @@ namespace strumpack {
     }
   }
 
-  template<typename scalar_t,typename integer_t> void
+  template<typename scalar_t,typename integer_t>
+  template<typename x_t> void
+  SparseSolver<scalar_t,integer_t>::transform_x
+  (const DenseM_t& xloc, DenseMatrix<x_t>& x) {
+    using real_t = typename RealType<x_t>::value_type;
+    integer_t N = matrix()->size(), d = x.cols();
+    auto& Pi = reordering()->perm();
+    bool ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH,
+      perm = opts_.matching() != MatchingJob::NONE,
+      cmatch = perm && matching_has_scaling(opts_.matching());
+    for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+      for (integer_t i=0; i<N; i++) {
+        auto xi = static_cast<x_t>(xloc(Pi[i], j));
+        if (ceq) xi *= real_t(equil_.C[i]);
+        auto q = perm ? matching_.Q[i] : i;
+        if (cmatch) xi *= real_t(matching_.C[q]);
+        x(q, j) = xi;
+      }
+  }
+
+  template<typename scalar_t,typename integer_t>
+  template<typename b_t> void
   SparseSolver<scalar_t,integer_t>::transform_b
-  (const DenseM_t& b, DenseM_t& bloc) {
-    using real_t = typename RealType<scalar_t>::value_type;
+  (const DenseMatrix<b_t>& b, DenseM_t& bloc) {
+    using real_t = typename RealType<b_t>::value_type;
     integer_t N = matrix()->size(), d = b.cols();
     auto& P = reordering()->iperm();
-    std::vector<real_t> R(N, 1.);
-    if (equil_.type == EquilibrationType::ROW ||
-        equil_.type == EquilibrationType::BOTH)
-      for (integer_t i=0; i<N; i++)
-        R[i] *= equil_.R[i];
-    if (this->reordered_ &&
-        opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
-      for (integer_t i=0; i<N; i++)
-        R[i] *= matching_.R[i];
+    bool req = equil_.type == EquilibrationType::ROW ||
+      equil_.type == EquilibrationType::BOTH,
+      rmatch = this->reordered_ && matching_has_scaling(opts_.matching());
     for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
       for (integer_t i=0; i<N; i++) {
         auto p = P[i];
-        bloc(i, j) = R[p] * b(p, j);
+        real_t R(1.);
+        if (req) R *= equil_.R[p];
+        if (rmatch) R *= matching_.R[p];
+        bloc(i, j) = static_cast<scalar_t>(R * b(p, j));
       }
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::selected_inverse
+  (integer_t N, const integer_t* row_ptr, const integer_t* col_ind,
+   scalar_t* values) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (N != matrix()->size()) return ReturnCode::NOT_SUPPORTED;
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    auto e = factor_schur_root();
+    if (e != ReturnCode::SUCCESS) return e;
+    TaskTimer t("selected_inverse");
+    t.start();
+    // A^{-1}(i,j) = C(i) M^{-1}(r,c) R(j), with M the scaled and
+    // permuted matrix which was factored, see transform_b/transform_x
+    auto& Pi = reordering()->perm();
+    bool req = equil_.type == EquilibrationType::ROW ||
+      equil_.type == EquilibrationType::BOTH,
+      ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH,
+      perm = opts_.matching() != MatchingJob::NONE,
+      scale = perm && matching_has_scaling(opts_.matching());
+    std::vector<integer_t> Qinv;
+    if (perm) {
+      Qinv.resize(N);
+      for (integer_t i=0; i<N; i++)
+        Qinv[matching_.Q[i]] = i;
+    }
+    integer_t nnz = row_ptr[N] - row_ptr[0];
+    std::vector<integer_t> r(nnz), c(nnz);
+    std::vector<real_t> s(nnz, real_t(1.));
+    for (integer_t i=0; i<N; i++) {
+      auto ii = perm ? Qinv[i] : i;
+      for (integer_t k=row_ptr[i]; k<row_ptr[i+1]; k++) {
+        auto kk = k - row_ptr[0], j = col_ind[k];
+        r[kk] = Pi[ii];
+        c[kk] = Pi[j];
+        if (ceq) s[kk] *= equil_.C[ii];
+        if (scale) s[kk] *= matching_.C[i] * matching_.R[j];
+        if (req) s[kk] *= equil_.R[j];
+      }
+    }
+    std::vector<std::size_t> ord(nnz);
+    std::iota(ord.begin(), ord.end(), 0);
+    std::sort(ord.begin(), ord.end(), [&](std::size_t a, std::size_t b) {
+      return std::min(r[a], c[a]) < std::min(r[b], c[b]); });
+    auto v = values + row_ptr[0];
+    auto ierr = tree()->selected_inverse(r, c, ord, v);
+    for (integer_t k=0; k<nnz; k++)
+      v[k] *= s[k];
+    t.stop();
+    if (opts_.verbose() && this->is_root_)
+      std::cout << "# selected inversion, " << nnz << " entries, time = "
+                << t.elapsed() << " sec" << std::endl;
+    return ierr;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::inverse_diagonal(scalar_t* d) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    integer_t N = matrix()->size();
+    std::vector<integer_t> ptr(N+1), ind(N);
+    std::iota(ptr.begin(), ptr.end(), 0);
+    std::iota(ind.begin(), ind.end(), 0);
+    return selected_inverse(N, ptr.data(), ind.data(), d);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_sparse
+  (const DenseM_t& b, DenseM_t& x, const std::vector<integer_t>& b_rows,
+   const std::vector<integer_t>& x_rows) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    auto e = factor_schur_root();
+    if (e != ReturnCode::SUCCESS) return e;
+    TaskTimer t("solve_sparse");
+    this->perf_counters_start();
+    t.start();
+    assert(b.cols() == x.cols());
+    integer_t N = matrix()->size(), d = b.cols();
+    std::vector<integer_t> brows(b_rows), xrows(x_rows);
+    if (brows.empty()) {
+      brows.resize(N);
+      std::iota(brows.begin(), brows.end(), 0);
+    }
+    if (xrows.empty()) {
+      xrows.resize(N);
+      std::iota(xrows.begin(), xrows.end(), 0);
+    }
+    // same scaling and permutations as in transform_b/transform_x,
+    // but only for the given rows
+    auto& Pi = reordering()->perm();
+    bool req = equil_.type == EquilibrationType::ROW ||
+      equil_.type == EquilibrationType::BOTH,
+      ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH,
+      perm = opts_.matching() != MatchingJob::NONE,
+      match = perm && matching_has_scaling(opts_.matching());
+    std::vector<integer_t> Qinv;
+    if (perm) {
+      Qinv.resize(N);
+      for (integer_t i=0; i<N; i++)
+        Qinv[matching_.Q[i]] = i;
+    }
+    DenseM_t bloc(N, d);
+    bloc.zero();
+    std::vector<bool> brow(N, false), xrow(N, false);
+    for (auto p : brows) {
+      auto i = Pi[p];
+      real_t R(1.);
+      if (req) R *= equil_.R[p];
+      if (match) R *= matching_.R[p];
+      for (integer_t j=0; j<d; j++)
+        bloc(i, j) = R * b(p, j);
+      brow[i] = true;
+    }
+    for (auto q : xrows)
+      xrow[Pi[perm ? Qinv[q] : q]] = true;
+    tree()->multifrontal_solve_sparse(bloc, brow, xrow);
+    x.zero();
+    for (auto q : xrows) {
+      auto i = perm ? Qinv[q] : q;
+      real_t C(1.);
+      if (ceq) C *= equil_.C[i];
+      if (match) C *= matching_.C[q];
+      for (integer_t j=0; j<d; j++)
+        x(q, j) = C * bloc(Pi[i], j);
+    }
+    Krylov_its_ = 0;
+    t.stop();
+    this->perf_counters_stop("sparse solve");
+    this->record_phase(this->stats_.solve, t.elapsed());
+    this->stats_.solves++;
+    this->print_solve_stats(t);
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::set_schur_indices
+  (const std::vector<integer_t>& S) {
+    schur_ = S;
+    if (!schur_.empty())
+      opts_.set_matching(MatchingJob::NONE);
+    factored_ = reordered_ = false;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::get_schur_complement(DenseM_t& S) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (schur_.empty()) return ReturnCode::NOT_SUPPORTED;
+    if (!this->reordered_) {
+      ReturnCode ierr = this->reorder();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    // without separators there is no root front
+    if (!tree()->root()) return ReturnCode::NOT_SUPPORTED;
+    // the root front was already factored by a solve, redo the
+    // factorization
+    if (this->factored_ && !tree()->schur_complement())
+      factored_ = false;
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    auto F = tree()->schur_complement();
+    if (!F) return ReturnCode::NOT_SUPPORTED;
+    // the root separator is at the end, possibly reordered for
+    // compression, undo the equilibration
+    auto& Pi = reordering()->perm();
+    std::size_t nS = schur_.size(), N = matrix()->size(),
+      s0 = N - nS;
+    bool req = equil_.type == EquilibrationType::ROW ||
+      equil_.type == EquilibrationType::BOTH,
+      ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH;
+    S = DenseM_t(nS, nS);
+    for (std::size_t j=0; j<nS; j++) {
+      auto c = schur_[j];
+      for (std::size_t i=0; i<nS; i++) {
+        auto r = schur_[i];
+        S(i, j) = (*F)(Pi[r]-s0, Pi[c]-s0);
+        if (req) S(i, j) /= equil_.R[r];
+        if (ceq) S(i, j) /= equil_.C[c];
+      }
+    }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::factor_schur_root() {
+    if (schur_.empty()) return ReturnCode::SUCCESS;
+    return tree()->factor_root(*matrix(), opts_);
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolver<scalar_t,integer_t>::solve_internal
   (const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
@@ -271,6 +526,10 @@ namespace strumpack {
       // should still continue!!
       if (ierr != ReturnCode::SUCCESS) return ierr;
     }
+    if (this->factored_) {
+      ReturnCode ierr = factor_schur_root();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
 
     TaskTimer t("solve");
     this->perf_counters_start();
@@ -368,6 +627,8 @@ namespace strumpack {
 
     t.stop();
     this->perf_counters_stop("DIRECT/GMRES solve");
+    this->record_phase(this->stats_.solve, t.elapsed());
+    this->stats_.solves++;
     this->print_solve_stats(t);
     return ReturnCode::SUCCESS;
   }
@@ -393,4 +654,30 @@ namespace strumpack {
   template class SparseSolver<std::complex<float>,long long int>;
   template class SparseSolver<std::complex<double>,long long int>;
 
+  // used by SparseSolverMixedPrecision
+  template void SparseSolver<float,int>::transform_b
+  (const DenseMatrix<double>&, DenseMatrix<float>&);
+  template void SparseSolver<float,int>::transform_x
+  (const DenseMatrix<float>&, DenseMatrix<double>&);
+  template void SparseSolver<std::complex<float>,int>::transform_b
+  (const DenseMatrix<std::complex<double>>&, DenseMatrix<std::complex<float>>&);
+  template void SparseSolver<std::complex<float>,int>::transform_x
+  (const DenseMatrix<std::complex<float>>&, DenseMatrix<std::complex<double>>&);
+  template void SparseSolver<float,long int>::transform_b
+  (const DenseMatrix<double>&, DenseMatrix<float>&);
+  template void SparseSolver<float,long int>::transform_x
+  (const DenseMatrix<float>&, DenseMatrix<double>&);
+  template void SparseSolver<std::complex<float>,long int>::transform_b
+  (const DenseMatrix<std::complex<double>>&, DenseMatrix<std::complex<float>>&);
+  template void SparseSolver<std::complex<float>,long int>::transform_x
+  (const DenseMatrix<std::complex<float>>&, DenseMatrix<std::complex<double>>&);
+  template void SparseSolver<float,long long int>::transform_b
+  (const DenseMatrix<double>&, DenseMatrix<float>&);
+  template void SparseSolver<float,long long int>::transform_x
+  (const DenseMatrix<float>&, DenseMatrix<double>&);
+  template void SparseSolver<std::complex<float>,long long int>::transform_b
+  (const DenseMatrix<std::complex<double>>&, DenseMatrix<std::complex<float>>&);
+  template void SparseSolver<std::complex<float>,long long int>::transform_x
+  (const DenseMatrix<std::complex<float>>&, DenseMatrix<std::complex<double>>&);
+
 } //end namespace strumpack
@@ -25,6 +25,8 @@
  *             (Lawrence Berkeley National Lab, Computational Research
  *             Division).
  */
+#include <fstream>
+
 #include "SparseSolverBase.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -127,6 +129,30 @@ namespace strumpack {
     return Krylov_its_;
   }
 
+  template<typename scalar_t,typename integer_t> SolverStatistics
+  SparseSolverBase<scalar_t,integer_t>::statistics() const {
+    auto s = stats_;
+#if defined(STRUMPACK_COUNT_FLOPS)
+    s.factor_dense_flops = all_reduce_sum(stats_.factor_dense_flops);
+    s.factor_compressed_flops = s.factor.flops - s.factor_dense_flops;
+#endif
+    for (auto f : {&s.factor_fronts.dense, &s.factor_fronts.half,
+                   &s.factor_fronts.lossy, &s.factor_fronts.lossless,
+                   &s.factor_fronts.BLR, &s.factor_fronts.HSS,
+                   &s.factor_fronts.HODLR}) {
+      f->fronts = all_reduce_sum(f->fronts);
+      f->flops = all_reduce_sum(f->flops);
+      f->time = all_reduce_sum(static_cast<long long int>(f->time * 1e9))
+        / 1e9;
+    }
+    if (factored_) {
+      s.factor_nonzeros = factor_nonzeros();
+      s.factor_memory = factor_memory();
+    }
+    s.Krylov_iterations = Krylov_its_;
+    return s;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) {
@@ -261,6 +287,19 @@ namespace strumpack {
 #endif
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::record_phase
+  (SolverStatistics::Phase& p, double time) const {
+    p.time = time;
+#if defined(STRUMPACK_COUNT_FLOPS)
+    // ftot_, btot_, .. were set (and reduced) by perf_counters_stop
+    p.flops = ftot_;
+    p.flops_min = fmin_;
+    p.flops_max = fmax_;
+    p.bytes = btot_;
+#endif
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolverBase<scalar_t,integer_t>::print_solve_stats
   (TaskTimer& t) const {
@@ -314,17 +353,20 @@ namespace strumpack {
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
-  SparseSolverBase<scalar_t,integer_t>::reorder_internal
-  (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
-    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
-    if (reordered_) return ReturnCode::SUCCESS;
-    TaskTimer t1("permute-scale");
-    int ierr;
+  SparseSolverBase<scalar_t,integer_t>::reorder
+  (const DenseMatrix<real_t>& coords) {
+    return reorder_internal(nullptr, 0, 1, 1, 1, 1, 1, &coords);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::preprocess_matrix
+  (TaskTimer& t1, TaskTimer& t2, bool compute_matching) {
     if (opts_.verbose() && is_root_)
       std::cout << "# matching job: " << get_description(opts_.matching())
                 << std::endl;
-    if (opts_.matching() != MatchingJob::NONE) {
+    if (!compute_matching)
+      t1.time([&](){ matrix()->apply_matching(matching_); });
+    else if (opts_.matching() != MatchingJob::NONE) {
       try {
         t1.time([&](){ matching_ = matrix()->matching(opts_.matching()); });
       } catch (std::exception& e) {
@@ -350,8 +392,7 @@ namespace strumpack {
     }
 
     auto old_nnz = matrix()->nnz();
-    TaskTimer t2("sparsity-symmetrization",
-                 [&](){ matrix()->symmetrize_sparsity(); });
+    t2.time([&](){ matrix()->symmetrize_sparsity(); });
     if (matrix()->nnz() != old_nnz && opts_.verbose() && is_root_) {
       std::cout << "# Matrix padded with zeros to get symmetric pattern."
                 << std::endl;
@@ -360,12 +401,28 @@ namespace strumpack {
                 << number_format_with_commas(matrix()->nnz()) << "."
                 << std::endl;
     }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::reorder_internal
+  (const int* p, int base, int nx, int ny, int nz,
+   int components, int width, const DenseMatrix<real_t>* coords) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (reordered_) return ReturnCode::SUCCESS;
+    pattern_hash_ = matrix()->pattern_hash();
+    reset_peak_memory();
+    TaskTimer t1("permute-scale"), t2("sparsity-symmetrization");
+    auto ret = preprocess_matrix(t1, t2, true);
+    if (ret != ReturnCode::SUCCESS) return ret;
+    int ierr;
 
     TaskTimer t3("nested-dissection");
     perf_counters_start();
     t3.start();
     setup_reordering();
-    ierr = compute_reordering(p, base, nx, ny, nz, components, width);
+    ierr = compute_reordering
+      (p, base, nx, ny, nz, components, width, coords);
     if (ierr) {
       std::cerr << "ERROR: nested dissection went wrong, ierr="
                 << ierr << std::endl;
@@ -381,6 +438,7 @@ namespace strumpack {
                 << std::endl;
     }
     perf_counters_stop("nested dissection");
+    record_phase(stats_.reorder, t3.elapsed());
 
     perf_counters_start();
     TaskTimer t0("symbolic-factorization", [&](){ setup_tree(); });
@@ -421,17 +479,24 @@ namespace strumpack {
                     << number_format_with_commas(fc.lossy) << std::endl;
           break;
         case CompressionType::LOSSLESS:
+          std::cout << "#   - nr of lossless Frontal matrices = "
+                    << number_format_with_commas(fc.lossless) << std::endl;
+          break;
         case CompressionType::LOSSY:
-          std::cout << "#   - nr of lossy/lossless Frontal matrices = "
+          std::cout << "#   - nr of lossy Frontal matrices = "
                     << number_format_with_commas(fc.lossy) << std::endl;
           break;
         case CompressionType::NONE:
         default: break;
         }
+        if (fc.half)
+          std::cout << "#   - nr of fp16/bfloat16 Frontal matrices = "
+                    << number_format_with_commas(fc.half) << std::endl;
         std::cout << "#   - symb-factor time = " << t0.elapsed() << std::endl;
       }
     }
     perf_counters_stop("symbolic factorization");
+    record_phase(stats_.symbolic, t0.elapsed());
 
     if (opts_.compression() != CompressionType::NONE) {
       if (is_root_) {
@@ -446,7 +511,6 @@ namespace strumpack {
 #endif
 #if !defined(STRUMPACK_USE_ZFP)
         if (opts_.compression() == CompressionType::ZFP_BLR_HODLR ||
-            opts_.compression() == CompressionType::LOSSLESS ||
             opts_.compression() == CompressionType::LOSSY) {
           std::cerr << "WARNING: Compression type requires ZFP, "
             "but STRUMPACK was not configured with ZFP support!"
@@ -461,12 +525,146 @@ namespace strumpack {
         std::cout << "#   - sep-reorder time = "
                   << t4.elapsed() << std::endl;
       perf_counters_stop("separator reordering");
+      record_phase(stats_.separator_reordering, t4.elapsed());
     }
 
+    record_peak_memory();
     reordered_ = true;
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::write_analysis
+  (std::ostream& os) const {
+    throw std::runtime_error
+      ("save_analysis is not supported by this solver");
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::read_analysis(std::istream& is) {
+    throw std::runtime_error
+      ("load_analysis is not supported by this solver");
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::save_analysis
+  (const std::string& fname) const {
+    if (!reordered_) {
+      if (is_root_)
+        std::cerr << "ERROR: save_analysis requires the matrix to be"
+                  << " reordered first" << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    std::ofstream f(fname, std::ios::out | std::ios::trunc |
+                    std::ios::binary);
+    if (!f) {
+      if (is_root_)
+        std::cerr << "ERROR: could not open " << fname << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    try {
+      int v[3];
+      get_version(v, v+1, v+2);
+      write_binary(f, std::string("STRUMPACK_ANALYSIS"));
+      f.write((const char*)v, sizeof(v));
+      write_binary(f, int(sizeof(integer_t)));
+      write_binary(f, pattern_hash_);
+      write_binary(f, int(opts_.compression()));
+      write_binary(f, int(matching_.job));
+      write_binary(f, matching_.Q);
+      write_binary(f, matching_.R);
+      write_binary(f, matching_.C);
+      write_analysis(f);
+    } catch (std::exception& e) {
+      if (is_root_) std::cerr << "ERROR: " << e.what() << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    if (!f) return ReturnCode::REORDERING_ERROR;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::load_analysis
+  (const std::string& fname) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (reordered_) {
+      if (is_root_)
+        std::cerr << "ERROR: matrix was already reordered, set a new"
+                  << " matrix before calling load_analysis" << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    std::ifstream f(fname, std::ios::in | std::ios::binary);
+    if (!f) {
+      if (is_root_)
+        std::cerr << "ERROR: could not open " << fname << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    TaskTimer t1("permute-scale"), t2("sparsity-symmetrization"),
+      t3("load-analysis");
+    t3.start();
+    try {
+      std::string magic;
+      read_binary(f, magic);
+      if (magic != "STRUMPACK_ANALYSIS")
+        throw std::runtime_error(fname + " is not an analysis file");
+      int v[3], vf[3];
+      get_version(v, v+1, v+2);
+      f.read((char*)vf, sizeof(vf));
+      if ((v[0] != vf[0] || v[1] != vf[1] || v[2] != vf[2]) && is_root_)
+        std::cerr << "Warning, file was created with a different"
+                  << " strumpack version (v"
+                  << vf[0] << "." << vf[1] << "." << vf[2]
+                  << " instead of v"
+                  << v[0] << "." << v[1] << "." << v[2]
+                  << ")" << std::endl;
+      int isize, comp, job;
+      std::uint64_t hash;
+      read_binary(f, isize);
+      if (isize != int(sizeof(integer_t)))
+        throw std::runtime_error("integer type does not match");
+      read_binary(f, hash);
+      if (hash != matrix()->pattern_hash())
+        throw std::runtime_error
+          ("sparsity pattern does not match the saved analysis");
+      read_binary(f, comp);
+      if (comp != int(opts_.compression()))
+        throw std::runtime_error
+          ("compression type does not match the saved analysis");
+      read_binary(f, job);
+      MatchingData<scalar_t,integer_t> M;
+      M.job = MatchingJob(job);
+      read_binary(f, M.Q);
+      read_binary(f, M.R);
+      read_binary(f, M.C);
+      std::size_t n = matrix()->size();
+      if ((M.job != MatchingJob::NONE && M.Q.size() != n) ||
+          (matching_has_scaling(M.job) &&
+           (M.R.size() != n || M.C.size() != n)))
+        throw std::runtime_error("invalid matching");
+      // read (and validate) everything before the matrix is modified,
+      // so a failure leaves the matrix as it was
+      read_analysis(f);
+      pattern_hash_ = hash;
+      matching_ = std::move(M);
+      opts_.set_matching(matching_.job);
+    } catch (std::exception& e) {
+      if (is_root_) std::cerr << "ERROR: " << e.what() << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    auto ret = preprocess_matrix(t1, t2, false);
+    if (ret != ReturnCode::SUCCESS) return ret;
+    // the stored permutation already includes the separator reordering
+    matrix()->permute(reordering()->iperm(), reordering()->perm());
+    t3.stop();
+    if (opts_.verbose() && is_root_)
+      std::cout << "# loaded analysis from " << fname
+                << ", time = " << t3.elapsed() << std::endl;
+    record_phase(stats_.reorder, t3.elapsed());
+    reordered_ = true;
+    factored_ = false;
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolverBase<scalar_t,integer_t>::flop_breakdown_reset() const {
 #if defined(STRUMPACK_COUNT_FLOPS)
@@ -492,6 +690,51 @@ namespace strumpack {
 #endif
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::reset_peak_memory() const {
+#if defined(STRUMPACK_COUNT_FLOPS)
+    params::peak_memory = params::memory.load();
+    params::peak_device_memory = params::device_memory.load();
+#endif
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::record_peak_memory() {
+#if defined(STRUMPACK_COUNT_FLOPS)
+    stats_.peak_memory = std::max(stats_.peak_memory, max_peak_memory());
+    stats_.peak_device_memory = std::max
+      (stats_.peak_device_memory, double(params::peak_device_memory));
+#endif
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::front_stats_reset() const {
+    for (auto& c : params::front_type_counters) {
+      c.fronts = 0;
+      c.time_ns = 0;
+      c.flops = 0;
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::record_front_stats() {
+    using FT = params::FrontType;
+    auto& f = stats_.factor_fronts;
+    for (auto t : {std::make_pair(FT::DENSE, &f.dense),
+                   std::make_pair(FT::HALF, &f.half),
+                   std::make_pair(FT::LOSSY, &f.lossy),
+                   std::make_pair(FT::LOSSLESS, &f.lossless),
+                   std::make_pair(FT::BLR, &f.BLR),
+                   std::make_pair(FT::HSS, &f.HSS),
+                   std::make_pair(FT::HODLR, &f.HODLR)}) {
+      // local values, reduced in statistics()
+      auto& c = params::front_type_counters[int(t.first)];
+      t.second->fronts = c.fronts;
+      t.second->time = c.time_ns.load() / 1e9;
+      t.second->flops = c.flops;
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolverBase<scalar_t,integer_t>::print_flop_breakdown_HSS() const {
     reduce_flop_counters();
@@ -577,13 +820,22 @@ namespace strumpack {
                   << "enabled" << std::endl;
       }
     }
+    reset_peak_memory();
     perf_counters_start();
     flop_breakdown_reset();
+    front_stats_reset();
     ReturnCode err_code;
     TaskTimer t1("Sparse-factorization", [&]() {
       err_code = tree()->multifrontal_factorization(*matrix(), opts_);
     });
     perf_counters_stop("numerical factorization");
+    record_phase(stats_.factor, t1.elapsed());
+    record_front_stats();
+#if defined(STRUMPACK_COUNT_FLOPS)
+    // local value, reduced in statistics()
+    stats_.factor_dense_flops = params::full_rank_flops;
+#endif
+    record_peak_memory();
     if (opts_.verbose()) {
       auto fnnz = factor_nonzeros();
       auto max_rank = maximum_rank();
@@ -591,6 +843,7 @@ namespace strumpack {
       auto peak_max = max_peak_memory();
       auto peak_min = min_peak_memory();
 #endif
+      auto ff = statistics().factor_fronts;
       if (is_root_) {
         std::cout << "#   - factor time = " << t1.elapsed() << std::endl;
         std::cout << "#   - factor nonzeros = "
@@ -612,6 +865,21 @@ namespace strumpack {
                   << double(params::peak_device_memory)/1.e6
                   << " MB" << std::endl;
 #endif
+        for (auto f : {std::make_pair("dense", &ff.dense),
+                       std::make_pair("fp16/bfloat16", &ff.half),
+                       std::make_pair("lossy", &ff.lossy),
+                       std::make_pair("lossless", &ff.lossless),
+                       std::make_pair("BLR", &ff.BLR),
+                       std::make_pair("HSS", &ff.HSS),
+                       std::make_pair("HODLR", &ff.HODLR)})
+          if (f.second->fronts)
+            std::cout << "#   - " << f.first << " fronts: "
+                      << number_format_with_commas(f.second->fronts)
+                      << ", time = " << f.second->time
+#if defined(STRUMPACK_COUNT_FLOPS)
+                      << ", flops = " << double(f.second->flops)
+#endif
+                      << std::endl;
         if (opts_.compression() != CompressionType::NONE) {
           std::cout << "#   - compression = " << std::boolalpha
                     << get_name(opts_.compression()) << std::endl;
@@ -53,6 +53,98 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> class EliminationTree;
   class TaskTimer;
 
+  /**
+   * \struct SolverStatistics
+   *
+   * \brief Performance statistics collected by the sparse solver,
+   * see SparseSolverBase::statistics().
+   *
+   * Timings are always recorded. The flop, byte and memory counts
+   * are only available when STRUMPACK was configured with
+   * -DSTRUMPACK_COUNT_FLOPS=ON, otherwise they are zero. For the
+   * distributed memory solver, flop and byte counts are summed over
+   * all MPI ranks, peak memory is the maximum over all ranks.
+   */
+  struct SolverStatistics {
+    /**
+     * \struct Phase
+     * \brief Statistics for a single phase of the solver.
+     */
+    struct Phase {
+      double time = 0.;              /*!< wall clock time, in seconds */
+      long long int flops = 0;       /*!< total flops                 */
+      long long int flops_min = 0;   /*!< minimum flops over ranks    */
+      long long int flops_max = 0;   /*!< maximum flops over ranks    */
+      long long int bytes = 0;       /*!< bytes moved (solve only)    */
+
+      /**
+       * Achieved flop rate, in GFlop/s.
+       */
+      double gflops() const { return time > 0. ? flops / time / 1e9 : 0.; }
+    };
+
+    /**
+     * \struct FrontTypeStatistics
+     * \brief Numerical factorization statistics for one type of
+     * front, see factor_fronts.
+     */
+    struct FrontTypeStatistics {
+      long long int fronts = 0;  /*!< number of fronts factored    */
+      double time = 0.;          /*!< time, summed over threads
+                                      and ranks, in seconds         */
+      long long int flops = 0;   /*!< flops                         */
+    };
+
+    /**
+     * \struct FrontTypes
+     * \brief Numerical factorization statistics per type of front.
+     */
+    struct FrontTypes {
+      FrontTypeStatistics dense;    /*!< dense, and mixed precision  */
+      FrontTypeStatistics half;     /*!< fp16/bfloat16 factors       */
+      FrontTypeStatistics lossy;    /*!< lossy compressed (ZFP)      */
+      FrontTypeStatistics lossless; /*!< lossless compressed         */
+      FrontTypeStatistics BLR;      /*!< block low rank              */
+      FrontTypeStatistics HSS;      /*!< HSS                         */
+      FrontTypeStatistics HODLR;    /*!< HODLR                       */
+    };
+
+    Phase reorder;              /*!< fill reducing (nested dissection)
+                                     ordering                          */
+    Phase symbolic;             /*!< symbolic factorization           */
+    Phase separator_reordering; /*!< separator reordering, only with
+                                     compression                       */
+    Phase factor;               /*!< numerical factorization          */
+    Phase solve;                /*!< most recent solve                */
+
+    /** flops in the factorization spent in dense (full-rank)
+        operations, including the dense parts of compressed fronts */
+    long long int factor_dense_flops = 0;
+    /** flops in the factorization spent in compression and
+        compressed (HSS, BLR, HODLR, ..) operations */
+    long long int factor_compressed_flops = 0;
+
+    /** numerical factorization per type of front. This only
+        includes the work on the front itself, not on its
+        children. The flops are those counted by the thread factoring
+        the front, including the tasks it executes itself. With
+        multiple threads, flops of tasks executed by other threads
+        are not attributed to a type, so the sum over the types can
+        be less than factor.flops. GPU fronts are not included. */
+    FrontTypes factor_fronts;
+
+    std::size_t factor_nonzeros = 0; /*!< see factor_nonzeros()    */
+    std::size_t factor_memory = 0;   /*!< see factor_memory()      */
+    /** peak memory during the reordering and factorization by this
+        solver, in bytes */
+    double peak_memory = 0.;
+    /** peak device memory during the reordering and factorization
+        by this solver, in bytes */
+    double peak_device_memory = 0.;
+    int solves = 0;                  /*!< number of solve calls    */
+    int Krylov_iterations = 0;       /*!< see Krylov_iterations()  */
+  };
+
   /**
    * \class SparseSolverBase
    *
@@ -82,6 +174,7 @@ namespace strumpack {
     using Reord_t = MatrixReordering<scalar_t,integer_t>;
     using DenseM_t = DenseMatrix<scalar_t>;
     using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 
   public:
 
@@ -167,6 +260,61 @@ namespace strumpack {
      */
     ReturnCode reorder(const int* p, int base=0);
 
+    /**
+     * Perform sparse matrix reordering, using the coordinates of the
+     * points (mesh nodes) corresponding to the rows/columns of the
+     * sparse matrix. This is nested dissection by recursive inertial
+     * bisection, where the separators are extracted from the graph
+     * of the matrix. This does not require a regular mesh. The
+     * coordinates are also used to cluster the separators for the
+     * HSS and BLR compression. Using this will ignore the reordering
+     * method selected in the options struct. Only supported in the
+     * sequential/multithreaded solver.
+     *
+     * \param coords d x N matrix, with N the size of the sparse
+     * matrix, where column i has the (d dimensional) coordinates of
+     * point i
+     * \return error code
+     */
+    ReturnCode reorder(const DenseMatrix<real_t>& coords);
+
+    /**
+     * Write the result of the analysis phase (reorder) to a file:
+     * the matching, the fill reducing permutation, the separator
+     * tree, the structure of the frontal matrices and the
+     * partitioning of the separators for compression. This can be
+     * loaded with load_analysis, for a matrix with the same sparsity
+     * pattern, to skip the analysis. The numerical values are not
+     * stored. The matrix has to be reordered already (see reorder or
+     * factor). Only supported in the sequential/multithreaded
+     * solver.
+     *
+     * \param fname file name
+     * \return error code
+     * \see load_analysis
+     */
+    ReturnCode save_analysis(const std::string& fname) const;
+
+    /**
+     * Load the analysis phase from a file written by save_analysis,
+     * instead of calling reorder. A matrix should be set, with the
+     * same sparsity pattern as the one used for save_analysis. The
+     * sparsity pattern, the integer type and the compression type
+     * are checked, and ReturnCode::REORDERING_ERROR is returned if
+     * they do not match, with the matrix left unmodified. Other
+     * options, such as the compression tolerances, are not
+     * checked. The matching is not recomputed: the stored matching
+     * is applied to the new matrix, and the matching job in the
+     * options is overwritten with the stored one. Equilibration is
+     * recomputed. The analysis can be saved before or after
+     * factorization.
+     *
+     * \param fname file name
+     * \return error code
+     * \see save_analysis
+     */
+    ReturnCode load_analysis(const std::string& fname);
+
     /**
      * Perform numerical factorization of the sparse input matrix.
      *
@@ -341,6 +489,17 @@ namespace strumpack {
      */
     int Krylov_iterations() const;
 
+    /**
+     * Return performance statistics (timings, flops, bytes moved and
+     * memory usage) for the reordering, factorization and solve
+     * phases. This can be called at any time, statistics for phases
+     * which have not been performed yet are zero. For the
+     * SparseSolverMPIDist distributed memory solver, this routine is
+     * collective on the MPI communicator.
+     *
+     * \see SolverStatistics
+     */
+    SolverStatistics statistics() const;
 
     /**
      * Return the inertia of the matrix. A sparse matrix needs to be
@@ -395,8 +554,15 @@ namespace strumpack {
     virtual
     int compute_reordering(const int* p, int base,
                            int nx, int ny, int nz,
-                           int components, int width) = 0;
+                           int components, int width,
+                           const DenseMatrix<real_t>* coords) = 0;
     virtual void separator_reordering() = 0;
+    // write/read the reordering and the elimination tree (after
+    // separator reordering), see save_analysis/load_analysis. These
+    // can throw std::runtime_error. read_analysis does not modify the
+    // matrix, load_analysis permutes it after preprocessing.
+    virtual void write_analysis(std::ostream& os) const;
+    virtual void read_analysis(std::istream& is);
 
     virtual SpMat_t* matrix() = 0;
     virtual Reord_t* reordering() = 0;
@@ -414,15 +580,24 @@ namespace strumpack {
     { return double(params::peak_memory); }
     virtual double min_peak_memory() const
     { return double(params::peak_memory); }
+    virtual long long int all_reduce_sum(long long int v) const
+    { return v; }
 
     void papi_initialize();
     long long dense_factor_nonzeros() const;
     void print_solve_stats(TaskTimer& t) const;
+    void record_phase(SolverStatistics::Phase& p, double time) const;
 
     virtual void reduce_flop_counters() const {}
     void print_flop_breakdown_HSS() const;
     void print_flop_breakdown_HODLR() const;
     void flop_breakdown_reset() const;
+    // the memory counters are global, restart the peak at the
+    // current usage before a phase, and keep the maximum in stats_
+    void reset_peak_memory() const;
+    void record_peak_memory();
+    void front_stats_reset() const;
+    void record_front_stats();
 
     void print_wrong_sparsity_error();
 
@@ -448,7 +623,10 @@ namespace strumpack {
     std::ostream* rank_out_ = nullptr;
     bool factored_ = false;
     bool reordered_ = false;
+    // sparsity pattern hash of the input matrix, for save_analysis
+    std::uint64_t pattern_hash_ = 0;
     int Krylov_its_ = 0;
+    SolverStatistics stats_;
 
 #if defined(STRUMPACK_USE_PAPI)
     float rtime_ = 0., ptime_ = 0.;
@@ -464,9 +642,12 @@ namespace strumpack {
 #endif
 
   private:
+    ReturnCode preprocess_matrix(TaskTimer& t1, TaskTimer& t2,
+                                 bool compute_matching);
     ReturnCode reorder_internal(const int* p, int base,
                                 int nx, int ny, int nz,
-                                int components, int width);
+                                int components, int width,
+                                const DenseMatrix<real_t>* coords=nullptr);
 
     virtual void delete_factors_internal() = 0;
   };
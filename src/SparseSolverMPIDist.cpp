@@ -208,8 +208,14 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   SparseSolverMPIDist<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
+   int components, int width, const DenseMatrix<real_t>* coords) {
     if (p) return nd_mpi_->set_permutation(opts_, *mat_mpi_, p, base);
+    if (coords) {
+      if (is_root_)
+        std::cerr << "# ERROR: reordering with coordinates is not"
+          " supported in SparseSolverMPIDist." << std::endl;
+      return 1;
+    }
     return nd_mpi_->nested_dissection
       (opts_, *mat_mpi_, nx, ny, nz, components, width);
   }
@@ -225,6 +231,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolverMPIDist<scalar_t,integer_t>::setup_tree() {
+    matching_plan_.reset();
     if (opts_.replace_tiny_pivots() && opts_.matching() == MatchingJob::NONE) {
       auto shifted_mat = mat_mpi_->add_missing_diagonal(opts_.pivot_threshold());
       tree_mpi_dist_.reset
@@ -280,7 +287,7 @@ namespace strumpack {
     this->Krylov_its_ = 0;
 
     auto bloc = b;
-    if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+    if (matching_has_scaling(opts_.matching()))
       bloc.scale_rows_real(this->matching_.R);
     if (this->equil_.type == EquilibrationType::ROW ||
         this->equil_.type == EquilibrationType::BOTH)
@@ -288,7 +295,7 @@ namespace strumpack {
 
     if (use_initial_guess &&
         opts_.Krylov_solver() != KrylovSolver::DIRECT) {
-      if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING ||
+      if (matching_has_scaling(opts_.matching()) ||
           this->equil_.type == EquilibrationType::COLUMN ||
           this->equil_.type == EquilibrationType::BOTH) {
         std::vector<real_t> C(nloc, 1.);
@@ -296,7 +303,7 @@ namespace strumpack {
             this->equil_.type == EquilibrationType::BOTH)
           for (std::size_t i=0; i<nloc; i++)
             C[i] /= this->equil_.C[i + mat_mpi_->begin_row()];
-        if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+        if (matching_has_scaling(opts_.matching()))
           for (std::size_t i=0; i<nloc; i++)
             C[i] /= this->matching_.C[i + mat_mpi_->begin_row()];
         x.scale_rows_real(C);
@@ -376,13 +383,19 @@ namespace strumpack {
         this->equil_.type == EquilibrationType::BOTH)
       x.scale_rows_real(this->equil_.C.data() + mat_mpi_->begin_row());
     if (opts_.matching() != MatchingJob::NONE) {
-      permute_vector(x, this->matching_.Q, mat_mpi_->dist(), comm_);
-      if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+      if (!matching_plan_)
+        matching_plan_.reset
+          (new PermutePlanMPI<integer_t>
+           (this->matching_.Q, mat_mpi_->dist(), comm_));
+      matching_plan_->apply(x, comm_);
+      if (matching_has_scaling(opts_.matching()))
         x.scale_rows_real(this->matching_.C.data() + mat_mpi_->begin_row());
     }
 
     t.stop();
     this->perf_counters_stop("DIRECT/GMRES solve");
+    this->record_phase(this->stats_.solve, t.elapsed());
+    this->stats_.solves++;
     this->print_solve_stats(t);
     return ReturnCode::SUCCESS;
   }
@@ -423,16 +436,18 @@ namespace strumpack {
                   << " sec" << std::endl;
       }
 #endif
+    }
 #if defined(STRUMPACK_COUNT_FLOPS)
-      auto df = params::flops - this->f0_;
-      long long int flopsbytes[2] = {df, params::bytes_moved - this->b0_};
-      comm_.all_reduce(flopsbytes, 2, MPI_SUM);
-      this->ftot_ = flopsbytes[0];
-      this->btot_ = flopsbytes[1];
-      this->fmin_ = comm_.all_reduce(df, MPI_MIN);
-      this->fmax_ = comm_.all_reduce(df, MPI_MAX);
+    // always reduced (not only when verbose), these are also used
+    // for statistics()
+    long long int df = params::flops - this->f0_;
+    long long int flopsbytes[2] = {df, params::bytes_moved - this->b0_};
+    comm_.all_reduce(flopsbytes, 2, MPI_SUM);
+    this->ftot_ = flopsbytes[0];
+    this->btot_ = flopsbytes[1];
+    this->fmin_ = comm_.all_reduce(df, MPI_MIN);
+    this->fmax_ = comm_.all_reduce(df, MPI_MAX);
 #endif
-    }
   }
 
   template<typename scalar_t,typename integer_t> void
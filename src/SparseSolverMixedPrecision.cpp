@@ -26,6 +26,8 @@
  *             Division).
  */
 
+#include <algorithm>
+
 #include "StrumpackSparseSolverMixedPrecision.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -41,6 +43,22 @@
 
 namespace strumpack {
 
+  // copy of A with values converted to to_t, in a single allocation
+  template<typename to_t,typename from_t,typename integer_t>
+  std::unique_ptr<CSRMatrix<to_t,integer_t>>
+  convert_matrix(const CSRMatrix<from_t,integer_t>& A) {
+    auto n = A.size(), nnz = A.nnz();
+    auto B = std::make_unique<CSRMatrix<to_t,integer_t>>(n, nnz);
+    std::copy(A.ptr(), A.ptr()+n+1, B->ptr());
+    std::copy(A.ind(), A.ind()+nnz, B->ind());
+    auto Av = A.val();
+    auto Bv = B->val();
+    for (integer_t i=0; i<nnz; i++)
+      Bv[i] = static_cast<to_t>(Av[i]);
+    B->set_symm_sparse(A.symm_sparse());
+    return B;
+  }
+
   template<typename factor_t,typename refine_t,typename integer_t>
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   SparseSolverMixedPrecision(bool verbose, bool root)
@@ -64,22 +82,19 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   solve(const DenseMatrix<refine_t>& b, DenseMatrix<refine_t>& x,
         bool use_initial_guess) {
-    auto solve_func =
-      [&](DenseMatrix<refine_t>& w) {
-        DenseMatrix<factor_t> new_x(w.rows(), w.cols()),
-          cast_b = cast_matrix<refine_t,factor_t>(w);
-        solver_.solve(cast_b, new_x);
-        copy(new_x, w);
-      };
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    if (!solver_.factored_) {
+      auto ierr = solver_.factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    auto solve_func = [&](DenseMatrix<refine_t>& w) { inner_solve(w, w); };
     auto solve_func_ptr =
       [&](refine_t* w) {
         DenseMatrixWrapper<refine_t> wx(x.rows(), 1, w, x.rows());
-        solve_func(wx);
+        inner_solve(wx, wx);
       };
-    auto spmv = [&](const refine_t* x, refine_t* y) { mat_.spmv(x, y); };
+    auto spmv = [&](const refine_t* x, refine_t* y) { mat_->spmv(x, y); };
 
-    auto old_verbose = solver_.options().verbose();
-    solver_.options().set_verbose(false);
     Krylov_its_ = 0;
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
@@ -91,16 +106,15 @@ namespace strumpack {
            use_initial_guess, opts_.verbose());
       else
         iterative::IterativeRefinement<refine_t,integer_t>
-          (mat_, solve_func, x, b, opts_.rel_tol(), opts_.abs_tol(),
+          (*mat_, solve_func, x, b, opts_.rel_tol(), opts_.abs_tol(),
            Krylov_its_, opts_.maxit(), use_initial_guess, opts_.verbose());
     }; break;
     case KrylovSolver::DIRECT: {
-      copy(b, x, 0, 0);
-      solve_func(x);
+      inner_solve(b, x);
     }; break;
     case KrylovSolver::REFINE: {
       iterative::IterativeRefinement<refine_t,integer_t>
-        (mat_, solve_func, x, b, opts_.rel_tol(), opts_.abs_tol(),
+        (*mat_, solve_func, x, b, opts_.rel_tol(), opts_.abs_tol(),
          Krylov_its_, opts_.maxit(), use_initial_guess, opts_.verbose());
     }; break;
     case KrylovSolver::PREC_GMRES: {
@@ -125,14 +139,26 @@ namespace strumpack {
     }
     }
     // TODO check convergence, return whether or not this converged
-    solver_.options().set_verbose(old_verbose);
     return ReturnCode::SUCCESS;
   }
 
+  template<typename factor_t,typename refine_t,typename integer_t> void
+  SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::inner_solve
+  (const DenseMatrix<refine_t>& b, DenseMatrix<refine_t>& x) {
+    // permutation and scaling are done together with the conversion
+    // to/from factor_t, b and x may alias
+    if (work_.rows() != b.rows() || work_.cols() != b.cols())
+      work_ = DenseMatrix<factor_t>(b.rows(), b.cols());
+    solver_.transform_b(b, work_);
+    solver_.tree()->multifrontal_solve(work_);
+    solver_.transform_x(work_, x);
+  }
+
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   solve(const refine_t* b, refine_t* x, bool use_initial_guess) {
-    auto N = mat_.size();
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    auto N = mat_->size();
     auto B = ConstDenseMatrixWrapperPtr(N, 1, b, N);
     DenseMatrixWrapper<refine_t> X(N, 1, x, N);
     return solve(*B, X, use_initial_guess);
@@ -142,7 +168,8 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   solve(int nrhs, const refine_t* b, int ldb, refine_t* x, int ldx,
         bool use_initial_guess) {
-    auto N = mat_.size();
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    auto N = mat_->size();
     auto B = ConstDenseMatrixWrapperPtr(N, nrhs, b, ldb);
     DenseMatrixWrapper<refine_t> X(N, nrhs, x, ldx);
     return solve(*B, X, use_initial_guess);
@@ -164,7 +191,8 @@ namespace strumpack {
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   solve(const factor_t* b, factor_t* x, bool use_initial_guess) {
-    auto N = mat_.size();
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    auto N = mat_->size();
     auto B = ConstDenseMatrixWrapperPtr(N, 1, b, N);
     DenseMatrixWrapper<factor_t> X(N, 1, x, N);
     return solve(*B, X, use_initial_guess);
@@ -174,7 +202,8 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   solve(int nrhs, const factor_t* b, int ldb, factor_t* x, int ldx,
         bool use_initial_guess) {
-    auto N = mat_.size();
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    auto N = mat_->size();
     auto B = ConstDenseMatrixWrapperPtr(N, nrhs, b, ldb);
     DenseMatrixWrapper<factor_t> X(N, nrhs, x, ldx);
     return solve(*B, X, use_initial_guess);
@@ -195,42 +224,42 @@ namespace strumpack {
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_matrix(const CSRMatrix<refine_t,integer_t>& A) {
-    mat_ = A;
-    solver_.set_matrix(cast_matrix<refine_t,integer_t,factor_t>(A));
+    mat_.reset(new CSRMatrix<refine_t,integer_t>(A));
+    solver_.set_matrix(convert_matrix<factor_t>(A));
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_matrix(const CSRMatrix<factor_t,integer_t>& A) {
-    mat_ = cast_matrix<factor_t,integer_t,refine_t>(A);
+    mat_ = convert_matrix<refine_t>(A);
     solver_.set_matrix(A);
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_lower_triangle_matrix(const CSRMatrix<refine_t,integer_t>& A) {
-    mat_ = A;
-    solver_.set_lower_triangle_matrix(cast_matrix<refine_t,integer_t,factor_t>(A));
+    mat_.reset(new CSRMatrix<refine_t,integer_t>(A));
+    solver_.set_lower_triangle_matrix(*convert_matrix<factor_t>(A));
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_lower_triangle_matrix(const CSRMatrix<factor_t,integer_t>& A) {
-    mat_ = cast_matrix<factor_t,integer_t,refine_t>(A);
+    mat_ = convert_matrix<refine_t>(A);
     solver_.set_lower_triangle_matrix(A);
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   update_matrix_values(const CSRMatrix<refine_t,integer_t>& A) {
-    mat_ = A;
-    solver_.update_matrix_values(cast_matrix<refine_t,integer_t,factor_t>(A));
+    mat_.reset(new CSRMatrix<refine_t,integer_t>(A));
+    solver_.update_matrix_values(convert_matrix<factor_t>(A));
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   update_matrix_values(const CSRMatrix<factor_t,integer_t>& A) {
-    mat_ = cast_matrix<factor_t,integer_t,refine_t>(A);
+    mat_ = convert_matrix<refine_t>(A);
     solver_.update_matrix_values(A);
   }
 
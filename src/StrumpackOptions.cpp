@@ -88,8 +88,17 @@ namespace strumpack {
     return "UNKNOWN";
   }
 
+  std::string get_name(FactorStorage fs) {
+    switch (fs) {
+    case FactorStorage::FULL: return "full";
+    case FactorStorage::FP16: return "fp16";
+    case FactorStorage::BF16: return "bf16";
+    }
+    return "UNKNOWN";
+  }
+
   MatchingJob get_matching(int job) {
-    if (job < 0 || job > 6)
+    if (job < 0 || job > static_cast<int>(MatchingJob::AUCTION))
       std::cerr << "ERROR: Matching job not recognized!!" << std::endl;
     return static_cast<MatchingJob>(job);
   }
@@ -109,10 +118,18 @@ namespace strumpack {
       return "maximum matching with row and column scaling";
     case MatchingJob::COMBBLAS:
       return "approximate weighted perfect matching, from CombBLAS";
+    case MatchingJob::AUCTION:
+      return "approximate maximum product matching with row and column"
+        " scaling, distributed auction";
     }
     return "UNKNOWN";
   }
 
+  bool matching_has_scaling(MatchingJob job) {
+    return job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING ||
+      job == MatchingJob::AUCTION;
+  }
+
   std::string get_name(ProportionalMapping pmap) {
     switch (pmap) {
     case ProportionalMapping::FLOPS: return "FLOPS";
@@ -185,6 +202,22 @@ namespace strumpack {
        {"sp_proportional_mapping",      required_argument, 0, 50},
        {"sp_enable_openmp_tree",        no_argument, 0, 51},
        {"sp_disable_openmp_tree",       no_argument, 0, 52},
+       // ids below 256 can collide with the '?' returned for
+       // options which are not recognized here (HSS, BLR, ...)
+       {"sp_compressed_solve_cache",    required_argument, 0, 256},
+       {"sp_enable_CB_clustering",      no_argument, 0, 257},
+       {"sp_disable_CB_clustering",     no_argument, 0, 258},
+       {"sp_enable_inplace_assembly",   no_argument, 0, 259},
+       {"sp_disable_inplace_assembly",  no_argument, 0, 260},
+       {"sp_dense_tile_size",           required_argument, 0, 261},
+       {"sp_enable_mixed_precision_fronts",  no_argument, 0, 262},
+       {"sp_disable_mixed_precision_fronts", no_argument, 0, 263},
+       {"sp_mixed_precision_level",     required_argument, 0, 264},
+       {"sp_mixed_precision_max_front_size", required_argument, 0, 265},
+       {"sp_mixed_precision_pivot_growth", required_argument, 0, 266},
+       {"sp_factor_storage",            required_argument, 0, 267},
+       {"sp_enable_parallel_nd",        no_argument, 0, 268},
+       {"sp_disable_parallel_nd",       no_argument, 0, 269},
        {"sp_verbose",                   no_argument, 0, 'v'},
        {"sp_quiet",                     no_argument, 0, 'q'},
        {"help",                         no_argument, 0, 'h'},
@@ -428,6 +461,48 @@ namespace strumpack {
       } break;
       case 51: enable_openmp_tree(); break;
       case 52: disable_openmp_tree(); break;
+      case 256: {
+        std::istringstream iss(optarg);
+        iss >> compressed_solve_cache_;
+        set_compressed_solve_cache(compressed_solve_cache_);
+      } break;
+      case 257: enable_CB_clustering(); break;
+      case 258: disable_CB_clustering(); break;
+      case 259: enable_inplace_assembly(); break;
+      case 260: disable_inplace_assembly(); break;
+      case 261: {
+        std::istringstream iss(optarg);
+        iss >> dense_tile_size_;
+        set_dense_tile_size(dense_tile_size_);
+      } break;
+      case 262: enable_mixed_precision_fronts(); break;
+      case 263: disable_mixed_precision_fronts(); break;
+      case 264: {
+        std::istringstream iss(optarg);
+        iss >> mixed_precision_level_;
+        set_mixed_precision_level(mixed_precision_level_);
+      } break;
+      case 265: {
+        std::istringstream iss(optarg);
+        iss >> mixed_precision_max_front_size_;
+        set_mixed_precision_max_front_size(mixed_precision_max_front_size_);
+      } break;
+      case 266: {
+        std::istringstream iss(optarg);
+        iss >> mixed_precision_pivot_growth_;
+        set_mixed_precision_pivot_growth(mixed_precision_pivot_growth_);
+      } break;
+      case 267: {
+        std::string s; std::istringstream iss(optarg); iss >> s;
+        for (auto& c : s) c = std::toupper(c);
+        if (s == "FULL") set_factor_storage(FactorStorage::FULL);
+        else if (s == "FP16") set_factor_storage(FactorStorage::FP16);
+        else if (s == "BF16") set_factor_storage(FactorStorage::BF16);
+        else std::cerr << "# WARNING: factor storage not"
+               " recognized, use 'full', 'fp16' or 'bf16'" << std::endl;
+      } break;
+      case 268: enable_parallel_nd(); break;
+      case 269: disable_parallel_nd(); break;
       case 'h': { describe_options(); } break;
       case 'v': set_verbose(true); break;
       case 'q': set_verbose(false); break;
@@ -521,9 +596,9 @@ namespace strumpack {
               << std::boolalpha << use_agg_amalg() << ")" << std::endl;
     std::cout << "#   --sp_disable_agg_amalg (default "
               << std::boolalpha << !use_agg_amalg() << ")" << std::endl;
-    std::cout << "#   --sp_matching int [0-6] (default "
+    std::cout << "#   --sp_matching int [0-7] (default "
               << static_cast<int>(matching()) << ")" << std::endl;
-    for (int i=0; i<7; i++)
+    for (int i=0; i<=static_cast<int>(MatchingJob::AUCTION); i++)
       std::cout << "#      " << i << " " <<
         get_description(get_matching(i)) << std::endl;
     std::cout << "#   --sp_compression (default "
@@ -545,6 +620,11 @@ namespace strumpack {
               << std::endl;
     std::cout << "#   --sp_separator_ordering_level (default "
               << separator_ordering_level() << ")" << std::endl;
+    std::cout << "#   --sp_enable_CB_clustering (default "
+              << std::boolalpha << CB_clustering() << ")" << std::endl
+              << "#          cluster the HSS/BLR contribution blocks"
+              << " using the ancestor separators" << std::endl;
+    std::cout << "#   --sp_disable_CB_clustering" << std::endl;
     std::cout << "#   --sp_enable_indirect_sampling" << std::endl;
     std::cout << "#   --sp_disable_indirect_sampling" << std::endl;
     std::cout << "#   --sp_enable_replace_tiny_pivots" << std::endl;
@@ -569,6 +649,43 @@ namespace strumpack {
               << std::boolalpha << !use_openmp_tree_ << ")" << std::endl
               << "#          uses less more memory, but scales worse with OpenMP threads"
               << std::endl;
+    std::cout << "#   --sp_enable_parallel_nd (default "
+              << std::boolalpha << use_parallel_nd() << ")" << std::endl
+              << "#          use the OpenMP parallel nested dissection"
+              << " instead of metis/scotch" << std::endl
+              << "#          (with the OpenMP tree and more than 1 thread)"
+              << std::endl;
+    std::cout << "#   --sp_disable_parallel_nd" << std::endl;
+    std::cout << "#   --sp_enable_inplace_assembly (default "
+              << std::boolalpha << inplace_assembly() << ")" << std::endl
+              << "#          assemble dense fronts in the largest child"
+              << " contribution block" << std::endl;
+    std::cout << "#   --sp_disable_inplace_assembly" << std::endl;
+    std::cout << "#   --sp_dense_tile_size int (default "
+              << dense_tile_size() << ")" << std::endl
+              << "#          tile size for the task based LU of dense fronts"
+              << " (<= 0 to disable)" << std::endl;
+    std::cout << "#   --sp_enable_mixed_precision_fronts (default "
+              << std::boolalpha << mixed_precision_fronts() << ")" << std::endl
+              << "#          factor fronts in single precision" << std::endl;
+    std::cout << "#   --sp_disable_mixed_precision_fronts" << std::endl;
+    std::cout << "#   --sp_mixed_precision_level int (default "
+              << mixed_precision_level() << ")" << std::endl
+              << "#          minimum tree level of single precision fronts"
+              << std::endl;
+    std::cout << "#   --sp_mixed_precision_max_front_size int (default "
+              << mixed_precision_max_front_size() << ")" << std::endl
+              << "#          maximum size of single precision fronts"
+              << std::endl;
+    std::cout << "#   --sp_mixed_precision_pivot_growth real_t (default "
+              << mixed_precision_pivot_growth() << ")" << std::endl
+              << "#          refactor a front in full precision if the"
+              << " pivot growth is larger" << std::endl;
+    std::cout << "#   --sp_factor_storage (default "
+              << get_name(factor_storage()) << ")" << std::endl
+              << "#          should be [full|fp16|bf16]" << std::endl
+              << "#          storage format for the factors of dense fronts"
+              << std::endl;
     std::cout << "#   --sp_lossy_precision [1-64] (default "
               << lossy_precision() << ")" << std::endl
               << "#          lossy compression precision" << std::endl
@@ -577,6 +694,10 @@ namespace strumpack {
               << lossy_accuracy() << ")" << std::endl
               << "#          lossy compression accuracy" << std::endl
               << "#          (for precision mode, set < 0)" << std::endl;
+    std::cout << "#   --sp_compressed_solve_cache bytes (default "
+              << compressed_solve_cache() << ")" << std::endl
+              << "#          keep decompressed lossy/lossless fronts"
+              << " in memory across solves" << std::endl;
     std::cout << "#   --sp_hss_min_sep_size (default "
               << hss_min_sep_size() << ")" << std::endl
               << "#          minimum separator size for hss compression"
@@ -60,16 +60,21 @@ namespace strumpack {
    */
   enum class ReorderingStrategy {
     NATURAL,    /*!< Do not reorder the system                      */
-    METIS,      /*!< Use Metis nested-dissection reordering         */
+    METIS,      /*!< Use Metis nested-dissection reordering, or the
+                  OpenMP parallel nested dissection with
+                  use_parallel_nd()                                 */
     PARMETIS,   /*!< Use ParMetis nested-dissection reordering      */
-    SCOTCH,     /*!< Use Scotch nested-dissection reordering        */
+    SCOTCH,     /*!< Use Scotch nested-dissection reordering, or the
+                  OpenMP parallel nested dissection with
+                  use_parallel_nd()                                 */
     PTSCOTCH,   /*!< Use PT-Scotch nested-dissection reordering     */
     RCM,        /*!< Use RCM reordering                             */
     GEOMETRIC,  /*!< A simple geometric nested dissection code that
                   only works for regular meshes. (see Sp::reorder)  */
     AMD,        /*!< Approximate minimum degree                     */
     MMD,        /*!< Multiple minimum degree                        */
-    AND,        /*!< Nested dissection                              */
+    AND,        /*!< Nested dissection, multilevel and OpenMP
+                  parallel with use_openmp_tree()                   */
     MLF,        /*!< Minimum local fill                             */
     SPECTRAL    /*!< Spectral nested dissection                     */
   };
@@ -102,7 +107,8 @@ namespace strumpack {
                     Block low-rank compression of medium
                     fronts and Hierarchically Off-diagonal
                     Low-Rank compression of large fronts  */
-    LOSSLESS,  /*!< Lossless cmpresssion                  */
+    LOSSLESS,  /*!< Lossless compression, with a built-in
+                    codec (distributed fronts use ZFP)    */
     LOSSY      /*!< Lossy cmpresssion                     */
   };
 
@@ -111,6 +117,25 @@ namespace strumpack {
    */
   std::string get_name(CompressionType comp);
 
+  /**
+   * Enumeration of the formats used to store the factors of dense
+   * fronts. The factorization is always done in the working
+   * precision, the factors are converted to the storage format
+   * afterwards (with a scaling factor per column), and converted back
+   * in the solve.
+   * \ingroup Enumerations
+   */
+  enum class FactorStorage {
+    FULL,      /*!< Store in the working precision        */
+    FP16,      /*!< IEEE half precision, 11 bit mantissa  */
+    BF16       /*!< bfloat16, 8 bit mantissa              */
+  };
+
+  /**
+   * Return a name/string for the FactorStorage.
+   */
+  std::string get_name(FactorStorage fs);
+
 
   /**
    * Enumeration of possible matching algorithms, used for permutation
@@ -126,7 +151,10 @@ namespace strumpack {
     MAX_DIAGONAL_SUM,             /*!< Maximum sum of diagonal values      */
     MAX_DIAGONAL_PRODUCT_SCALING, /*!< Maximum product of diagonal values
                                     and row and column scaling             */
-    COMBBLAS                      /*!< Use AWPM from CombBLAS              */
+    COMBBLAS,                     /*!< Use AWPM from CombBLAS              */
+    AUCTION                       /*!< Distributed auction, approximate
+                                    maximum product of diagonal values,
+                                    with row and column scaling            */
   };
 
   enum class EquilibrationType : char
@@ -149,6 +177,12 @@ namespace strumpack {
    */
   std::string get_description(MatchingJob job);
 
+  /**
+   * Check whether the matching algorithm also computes row and
+   * column scaling vectors.
+   */
+  bool matching_has_scaling(MatchingJob job);
+
 
   /**
    * Type of Gram-Schmidt orthogonalization used in GMRes.
@@ -684,6 +718,23 @@ namespace strumpack {
     void set_separator_ordering_level(int l)
     { assert(l >= 0); sep_order_level_ = l; }
 
+    /**
+     * Cluster the contribution block (the update indices) of HSS and
+     * BLR fronts using the clustering of the ancestor separators
+     * (computed during separator reordering), instead of splitting
+     * the update indices in equal parts. This leads to lower ranks
+     * in the F12, F21 and F22 blocks. Enabled by default.
+     */
+    void enable_CB_clustering() { CB_clustering_ = true; }
+
+    /**
+     * Split the contribution block of HSS and BLR fronts in equal
+     * parts, in their natural order.
+     *
+     * \see enable_CB_clustering
+     */
+    void disable_CB_clustering() { CB_clustering_ = false; }
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     void enable_indirect_sampling() { indirect_sampling_ = true; }
     void disable_indirect_sampling() { indirect_sampling_ = false; }
@@ -778,7 +829,8 @@ namespace strumpack {
     /**
      * Enable OpenMP tasking traversal of the supernodal tree in the
      * sparse solver. This requires more (peak) memory, but scales
-     * better with OpenMP threads.
+     * better with OpenMP threads. This also enables the OpenMP
+     * parallel nested dissection for ReorderingStrategy::AND.
      */
     void enable_openmp_tree() { use_openmp_tree_ = true; }
 
@@ -789,6 +841,116 @@ namespace strumpack {
      */
     void disable_openmp_tree() { use_openmp_tree_ = false; }
 
+    /**
+     * Use the in-tree OpenMP parallel multilevel nested dissection
+     * instead of Metis or Scotch, for ReorderingStrategy::METIS and
+     * ReorderingStrategy::SCOTCH, when the OpenMP tree traversal is
+     * enabled and more than one thread is available. The separator
+     * tree uses nd_param() as leaf size. This only affects the
+     * sequential/multithreaded interface. Disabled by default.
+     *
+     * \see enable_openmp_tree, set_nd_param
+     */
+    void enable_parallel_nd() { parallel_nd_ = true; }
+
+    /**
+     * Always call Metis or Scotch for ReorderingStrategy::METIS and
+     * ReorderingStrategy::SCOTCH.
+     *
+     * \see enable_parallel_nd
+     */
+    void disable_parallel_nd() { parallel_nd_ = false; }
+
+    /**
+     * Assemble a dense front in place in the contribution block of
+     * its child with the largest contribution block. The storage of
+     * that contribution block is reused (and extended if needed) for
+     * the F22 block of the parent, instead of allocating a new F22
+     * block and copying the child contribution block into it. This
+     * reduces the peak memory and the memory traffic of the
+     * multifrontal factorization. Disabled by default.
+     */
+    void enable_inplace_assembly() { inplace_assembly_ = true; }
+
+    /**
+     * Allocate a new F22 block for every dense front, and
+     * extend-add all children contribution blocks into it.
+     *
+     * \see enable_inplace_assembly
+     */
+    void disable_inplace_assembly() { inplace_assembly_ = false; }
+
+    /**
+     * Set the tile size for the task based LU factorization of large
+     * dense fronts. Dense fronts with a separator larger than this
+     * tile size are factored as a task graph over tiles (panel LU,
+     * triangular solves and Schur complement updates), which lets
+     * the updates of the contribution block overlap with the
+     * factorization of the next panels. This requires OpenMP task
+     * dependencies and is only used inside the OpenMP parallel
+     * traversal of the tree. A value <= 0 disables the tiled
+     * factorization.
+     */
+    void set_dense_tile_size(int nb) { dense_tile_size_ = nb; }
+
+    /**
+     * Factor (dense) fronts in lower precision (float or
+     * std::complex<float>), when scalar_t is double or
+     * std::complex<double>. A front is factored in lower precision
+     * when it is at least mixed_precision_level() levels below the
+     * root of the elimination tree and when its size (separator plus
+     * update) is at most mixed_precision_max_front_size(). Its
+     * factors are stored in lower precision, the Schur complement
+     * update is added to the contribution block in full precision.
+     * When the lower precision LU of a front encounters a zero pivot
+     * or a pivot growth larger than mixed_precision_pivot_growth(),
+     * that front is factored in full precision instead. The solution
+     * is refined in full precision with the iterative solver (see
+     * set_Krylov_solver). Disabled by default.
+     */
+    void enable_mixed_precision_fronts() { mixed_precision_fronts_ = true; }
+
+    /**
+     * Factor all fronts in the full precision of scalar_t.
+     * \see enable_mixed_precision_fronts
+     */
+    void disable_mixed_precision_fronts() { mixed_precision_fronts_ = false; }
+
+    /**
+     * Only fronts at least l levels below the root (level 0) are
+     * factored in lower precision.
+     * \see enable_mixed_precision_fronts
+     */
+    void set_mixed_precision_level(int l)
+    { assert(l >= 0); mixed_precision_level_ = l; }
+
+    /**
+     * Only fronts with dimension (separator plus update) at most s
+     * are factored in lower precision.
+     * \see enable_mixed_precision_fronts
+     */
+    void set_mixed_precision_max_front_size(int s)
+    { mixed_precision_max_front_size_ = s; }
+
+    /**
+     * Maximum pivot growth, max|U|/max|F11|, accepted for the lower
+     * precision LU of a front. A front with a larger growth is
+     * factored in full precision.
+     * \see enable_mixed_precision_fronts
+     */
+    void set_mixed_precision_pivot_growth(real_t g)
+    { assert(g > 0); mixed_precision_pivot_growth_ = g; }
+
+    /**
+     * Store the factors of dense (non-compressed) fronts in 16 bit
+     * floating point, see FactorStorage. This reduces the memory for
+     * the factors and the memory traffic in the solve, at the cost of
+     * a less accurate preconditioner, so it should be combined with
+     * iterative refinement or a Krylov solver. Fronts which are
+     * compressed (see set_compression) are not affected.
+     */
+    void set_factor_storage(FactorStorage fs) { factor_storage_ = fs; }
+
     /**
      * Set the precision for lossy compression. Preferred mode is
      * accuracy. To use precision mode, set the accuracy to a negative
@@ -808,6 +970,20 @@ namespace strumpack {
      */
     void set_lossy_accuracy(double a) { lossy_accuracy_ = a; }
 
+    /**
+     * Set the maximum number of bytes used to keep decompressed
+     * lossy/lossless fronts in memory across solves, in a least
+     * recently used cache. With the default of 0, the compressed
+     * factors are decompressed one column panel at a time during the
+     * solve, which keeps the memory overhead of the solve small, but
+     * requires decompression of all fronts for every solve.
+     *
+     * \see compressed_solve_cache
+     */
+    void set_compressed_solve_cache(std::size_t bytes) {
+      compressed_solve_cache_ = bytes;
+    }
+
     /**
      * Print statistics, about ranks, memory etc, for the root front
      * only.
@@ -1138,6 +1314,13 @@ namespace strumpack {
      */
     int separator_ordering_level() const { return sep_order_level_; }
 
+    /**
+     * Is clustering of the contribution blocks of HSS and BLR fronts
+     * enabled?
+     * \see enable_CB_clustering
+     */
+    bool CB_clustering() const { return CB_clustering_; }
+
     /**
      * Is indirect sampling for HSS construction enabled?
      */
@@ -1186,6 +1369,58 @@ namespace strumpack {
      */
     bool use_openmp_tree() const { return use_openmp_tree_; }
 
+    /**
+     * Is the OpenMP parallel nested dissection used instead of Metis
+     * or Scotch?
+     * \see enable_parallel_nd
+     */
+    bool use_parallel_nd() const { return parallel_nd_; }
+
+    /**
+     * Is in place assembly of dense fronts in the contribution block
+     * of a child enabled?
+     * \see enable_inplace_assembly
+     */
+    bool inplace_assembly() const { return inplace_assembly_; }
+
+    /**
+     * Tile size for the task based LU factorization of dense fronts.
+     * \see set_dense_tile_size
+     */
+    int dense_tile_size() const { return dense_tile_size_; }
+
+    /**
+     * Is factorization of fronts in lower precision enabled?
+     * \see enable_mixed_precision_fronts
+     */
+    bool mixed_precision_fronts() const { return mixed_precision_fronts_; }
+
+    /**
+     * Minimum level of fronts factored in lower precision.
+     * \see set_mixed_precision_level
+     */
+    int mixed_precision_level() const { return mixed_precision_level_; }
+
+    /**
+     * Maximum dimension of fronts factored in lower precision.
+     * \see set_mixed_precision_max_front_size
+     */
+    int mixed_precision_max_front_size() const
+    { return mixed_precision_max_front_size_; }
+
+    /**
+     * Maximum pivot growth for the lower precision LU of a front.
+     * \see set_mixed_precision_pivot_growth
+     */
+    real_t mixed_precision_pivot_growth() const
+    { return mixed_precision_pivot_growth_; }
+
+    /**
+     * Storage format for the factors of dense fronts.
+     * \see set_factor_storage
+     */
+    FactorStorage factor_storage() const { return factor_storage_; }
+
     /**
      * Returns the number of GPU streams to use.
      */
@@ -1212,6 +1447,16 @@ namespace strumpack {
         -1 : lossy_accuracy_;
     }
 
+    /**
+     * Returns the capacity, in bytes, of the cache of decompressed
+     * lossy/lossless fronts used during the solve.
+     *
+     * \see set_compressed_solve_cache
+     */
+    std::size_t compressed_solve_cache() const {
+      return compressed_solve_cache_;
+    }
+
     /**
      * Info about the stats of the root front will be printed to
      * std::cout
@@ -1327,6 +1572,14 @@ namespace strumpack {
     bool print_comp_front_stats_ = false;
     ProportionalMapping prop_map_ = ProportionalMapping::FLOPS;
     bool use_openmp_tree_ = true;
+    bool parallel_nd_ = false;
+    bool inplace_assembly_ = false;
+    int dense_tile_size_ = 256;
+    bool mixed_precision_fronts_ = false;
+    int mixed_precision_level_ = 1;
+    int mixed_precision_max_front_size_ = std::numeric_limits<int>::max();
+    real_t mixed_precision_pivot_growth_ = 1e3;
+    FactorStorage factor_storage_ = FactorStorage::FULL;
     bool use_symmetric_ = false;
     bool use_positive_definite_ = false;
 
@@ -1347,6 +1600,7 @@ namespace strumpack {
     int hss_min_sep_size_ = 1000;
     int sep_order_level_ = 1;
     bool indirect_sampling_ = false;
+    bool CB_clustering_ = true;
     HSS::HSSOptions<scalar_t> hss_opts_;
 
     /** BLR options */
@@ -1364,6 +1618,7 @@ namespace strumpack {
     int lossy_min_sep_size_ = 8;
     int lossy_precision_ = 16;
     double lossy_accuracy_ = 1e-3;
+    std::size_t compressed_solve_cache_ = 0;
 
     // ordering::NDOptions nd_opts_;
 
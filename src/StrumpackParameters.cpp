@@ -43,35 +43,37 @@ namespace strumpack {
     int task_recursion_cutoff_level = 0;
 #endif
 
-    std::atomic<long long int> flops(0);
-    std::atomic<long long int> bytes_moved(0);
+    ThreadCounter flops;
+    ThreadCounter bytes_moved;
     std::atomic<long long int> memory(0);
     std::atomic<long long int> peak_memory(0);
     std::atomic<long long int> device_memory(0);
     std::atomic<long long int> peak_device_memory(0);
 
-    std::atomic<long long int> CB_sample_flops(0);
-    std::atomic<long long int> sparse_sample_flops(0);
-    std::atomic<long long int> extraction_flops(0);
-    std::atomic<long long int> ULV_factor_flops(0);
-    std::atomic<long long int> schur_flops(0);
-    std::atomic<long long int> full_rank_flops(0);
-    std::atomic<long long int> random_flops(0);
-    std::atomic<long long int> ID_flops(0);
-    std::atomic<long long int> QR_flops(0);
-    std::atomic<long long int> ortho_flops(0);
-    std::atomic<long long int> reduce_sample_flops(0);
-    std::atomic<long long int> update_sample_flops(0);
-    std::atomic<long long int> hss_solve_flops(0);
+    ThreadCounter CB_sample_flops;
+    ThreadCounter sparse_sample_flops;
+    ThreadCounter extraction_flops;
+    ThreadCounter ULV_factor_flops;
+    ThreadCounter schur_flops;
+    ThreadCounter full_rank_flops;
+    ThreadCounter random_flops;
+    ThreadCounter ID_flops;
+    ThreadCounter QR_flops;
+    ThreadCounter ortho_flops;
+    ThreadCounter reduce_sample_flops;
+    ThreadCounter update_sample_flops;
+    ThreadCounter hss_solve_flops;
 
-    std::atomic<long long int> f11_fill_flops(0);
-    std::atomic<long long int> f12_fill_flops(0);
-    std::atomic<long long int> f21_fill_flops(0);
-    std::atomic<long long int> f22_fill_flops(0);
+    ThreadCounter f11_fill_flops;
+    ThreadCounter f12_fill_flops;
+    ThreadCounter f21_fill_flops;
+    ThreadCounter f22_fill_flops;
 
-    std::atomic<long long int> f21_mult_flops(0);
-    std::atomic<long long int> invf11_mult_flops(0);
-    std::atomic<long long int> f12_mult_flops(0);
+    ThreadCounter f21_mult_flops;
+    ThreadCounter invf11_mult_flops;
+    ThreadCounter f12_mult_flops;
+
+    FrontTypeCounter front_type_counters[int(FrontType::COUNT)];
 
   } // end namespace params
 } // end namespace strumpack
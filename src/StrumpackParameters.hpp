@@ -53,7 +53,8 @@ namespace strumpack { // these are all global variables
     REORDERING_ERROR,   /*!< The matrix reordering failed.          */
     ZERO_PIVOT,         /*!< A zero pivot was encountered.          */
     NO_CONVERGENCE,     /*!< The iterative solver did not converge. */
-    INACCURATE_INERTIA  /*!< Inertia could not be computed.         */
+    INACCURATE_INERTIA, /*!< Inertia could not be computed.         */
+    NOT_SUPPORTED       /*!< Not supported for this type of front.  */
   };
 
   inline std::ostream& operator<<(std::ostream& os, ReturnCode& e) {
@@ -64,6 +65,7 @@ namespace strumpack { // these are all global variables
     case ReturnCode::ZERO_PIVOT:         os << "ZERO_PIVOT"; break;
     case ReturnCode::NO_CONVERGENCE:     os << "NO_CONVERGENCE"; break;
     case ReturnCode::INACCURATE_INERTIA: os << "INACCURATE_INERTIA"; break;
+    case ReturnCode::NOT_SUPPORTED:      os << "NOT_SUPPORTED"; break;
     }
     return os;
   }
@@ -75,35 +77,111 @@ namespace strumpack { // these are all global variables
     extern int num_threads;
     extern int task_recursion_cutoff_level;
 
-    extern std::atomic<long long int> flops;
-    extern std::atomic<long long int> bytes_moved;
+    /*
+     * Event counter which is updated from many threads at once (flop
+     * and byte counters). Instead of a single shared atomic, every
+     * thread increments its own cache line, so concurrent updates
+     * from the BLAS wrappers do not contend. The value is only
+     * aggregated when it is read. Threads are mapped to slots round
+     * robin; when there are more threads than slots, slots are shared
+     * and the (relaxed) atomic increments keep the count exact.
+     */
+    class ThreadCounter {
+    public:
+      constexpr ThreadCounter() {}
+      ThreadCounter(const ThreadCounter&) = delete;
+      ThreadCounter& operator=(const ThreadCounter&) = delete;
+
+      ThreadCounter& operator+=(long long int n) {
+        slots_[slot()].v.fetch_add(n, std::memory_order_relaxed);
+        return *this;
+      }
+      ThreadCounter& operator-=(long long int n) {
+        slots_[slot()].v.fetch_sub(n, std::memory_order_relaxed);
+        return *this;
+      }
+      /* not atomic with respect to concurrent updates, only used to
+         reset or overwrite the counter between solver phases */
+      ThreadCounter& operator=(long long int v) {
+        for (int i=1; i<SLOTS; i++)
+          slots_[i].v.store(0, std::memory_order_relaxed);
+        slots_[0].v.store(v, std::memory_order_relaxed);
+        return *this;
+      }
+
+      long long int load() const {
+        long long int s = 0;
+        for (int i=0; i<SLOTS; i++)
+          s += slots_[i].v.load(std::memory_order_relaxed);
+        return s;
+      }
+      operator long long int() const { return load(); }
+
+    private:
+      static const int SLOTS = 64;
+      struct alignas(64) Slot { std::atomic<long long int> v{0}; };
+      Slot slots_[SLOTS];
+
+      static int slot() {
+        static std::atomic<int> next(0);
+        thread_local int s = next.fetch_add(1) % SLOTS;
+        return s;
+      }
+    };
+
+    extern ThreadCounter flops;
+    extern ThreadCounter bytes_moved;
     extern std::atomic<long long int> memory;
     extern std::atomic<long long int> peak_memory;
     extern std::atomic<long long int> device_memory;
     extern std::atomic<long long int> peak_device_memory;
 
-    extern std::atomic<long long int> CB_sample_flops;
-    extern std::atomic<long long int> sparse_sample_flops;
-    extern std::atomic<long long int> extraction_flops;
-    extern std::atomic<long long int> ULV_factor_flops;
-    extern std::atomic<long long int> schur_flops;
-    extern std::atomic<long long int> full_rank_flops;
-    extern std::atomic<long long int> random_flops;
-    extern std::atomic<long long int> ID_flops;
-    extern std::atomic<long long int> ortho_flops;
-    extern std::atomic<long long int> QR_flops;
-    extern std::atomic<long long int> reduce_sample_flops;
-    extern std::atomic<long long int> update_sample_flops;
-    extern std::atomic<long long int> hss_solve_flops;
-
-    extern std::atomic<long long int> f11_fill_flops;
-    extern std::atomic<long long int> f12_fill_flops;
-    extern std::atomic<long long int> f21_fill_flops;
-    extern std::atomic<long long int> f22_fill_flops;
-
-    extern std::atomic<long long int> f21_mult_flops;
-    extern std::atomic<long long int> invf11_mult_flops;
-    extern std::atomic<long long int> f12_mult_flops;
+    extern ThreadCounter CB_sample_flops;
+    extern ThreadCounter sparse_sample_flops;
+    extern ThreadCounter extraction_flops;
+    extern ThreadCounter ULV_factor_flops;
+    extern ThreadCounter schur_flops;
+    extern ThreadCounter full_rank_flops;
+    extern ThreadCounter random_flops;
+    extern ThreadCounter ID_flops;
+    extern ThreadCounter ortho_flops;
+    extern ThreadCounter QR_flops;
+    extern ThreadCounter reduce_sample_flops;
+    extern ThreadCounter update_sample_flops;
+    extern ThreadCounter hss_solve_flops;
+
+    extern ThreadCounter f11_fill_flops;
+    extern ThreadCounter f12_fill_flops;
+    extern ThreadCounter f21_fill_flops;
+    extern ThreadCounter f22_fill_flops;
+
+    extern ThreadCounter f21_mult_flops;
+    extern ThreadCounter invf11_mult_flops;
+    extern ThreadCounter f12_mult_flops;
+
+    /*
+     * Flops counted by the calling thread, used to attribute flops
+     * to the front the thread is working on, see FrontFactorStats.
+     */
+    inline long long int& thread_flops() {
+      static thread_local long long int f = 0;
+      return f;
+    }
+    inline void add_flops(long long int n) {
+      flops += n;
+      thread_flops() += n;
+    }
+
+    /*
+     * Factorization counters per type of front, reported in
+     * SolverStatistics::factor_fronts. The time is in nanoseconds.
+     */
+    enum class FrontType : int
+      { DENSE, HALF, LOSSY, LOSSLESS, BLR, HSS, HODLR, COUNT };
+    struct FrontTypeCounter {
+      ThreadCounter fronts, time_ns, flops;
+    };
+    extern FrontTypeCounter front_type_counters[int(FrontType::COUNT)];
 
 #endif //DOXYGEN_SHOULD_SKIP_THIS
 
@@ -112,7 +190,7 @@ namespace strumpack { // these are all global variables
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #if defined(STRUMPACK_COUNT_FLOPS)
 #define STRUMPACK_FLOPS(n)                      \
-  strumpack::params::flops += n;
+  strumpack::params::add_flops(n);
 #define STRUMPACK_BYTES(n)                      \
   strumpack::params::bytes_moved += n;
 #define STRUMPACK_ID_FLOPS(n)                   \
@@ -159,22 +237,20 @@ namespace strumpack { // these are all global variables
   strumpack::params::f12_mult_flops += n
 
 #define STRUMPACK_ADD_MEMORY(n) {                                       \
-    strumpack::params::memory += n;                                     \
-    auto new_peak_ = std::max(strumpack::params::memory.load(),         \
-                              strumpack::params::peak_memory.load());   \
-    auto old_peak_ = strumpack::params::peak_memory.load();             \
+    auto new_peak_ = (strumpack::params::memory += n);                  \
+    auto old_peak_ =                                                    \
+      strumpack::params::peak_memory.load(std::memory_order_relaxed);   \
     while (new_peak_ > old_peak_ &&                                     \
            !strumpack::params::peak_memory.compare_exchange_weak        \
-           (old_peak_, new_peak_)) { }                                  \
+           (old_peak_, new_peak_, std::memory_order_relaxed)) { }       \
   }
 #define STRUMPACK_ADD_DEVICE_MEMORY(n) {                                \
-    strumpack::params::device_memory += n;                              \
-    auto new_peak_ = std::max(strumpack::params::device_memory.load(),  \
-                              strumpack::params::peak_device_memory.load()); \
-    auto old_peak_ = strumpack::params::peak_device_memory.load();      \
+    auto new_peak_ = (strumpack::params::device_memory += n);           \
+    auto old_peak_ = strumpack::params::peak_device_memory.load         \
+      (std::memory_order_relaxed);                                      \
     while (new_peak_ > old_peak_ &&                                     \
            !strumpack::params::peak_device_memory.compare_exchange_weak \
-           (old_peak_, new_peak_)) { }                                  \
+           (old_peak_, new_peak_, std::memory_order_relaxed)) { }       \
   }
 
 #define STRUMPACK_SUB_MEMORY(n)                 \
@@ -90,7 +90,8 @@ typedef enum
    STRUMPACK_MATCHING_MAX_SMALLEST_DIAGONAL_2=3,
    STRUMPACK_MATCHING_MAX_DIAGONAL_SUM=4,
    STRUMPACK_MATCHING_MAX_DIAGONAL_PRODUCT_SCALING=5,
-   STRUMPACK_MATCHING_COMBBLAS=6
+   STRUMPACK_MATCHING_COMBBLAS=6,
+   STRUMPACK_MATCHING_AUCTION=7
   } STRUMPACK_MATCHING_JOB;
 
 typedef enum
@@ -145,7 +146,8 @@ typedef enum
    STRUMPACK_REORDERING_ERROR=2,
    STRUMPACK_ZERO_PIVOT=3,
    STRUMPACK_NO_CONVERGENCE=4,
-   STRUMPACK_INACCURATE_INERTIA=5
+   STRUMPACK_INACCURATE_INERTIA=5,
+   STRUMPACK_NOT_SUPPORTED=6
   } STRUMPACK_RETURN_CODE;
 
 
@@ -48,6 +48,8 @@ namespace strumpack {
   // forward declarations
   template<typename scalar_t,typename integer_t> class MatrixReordering;
   template<typename scalar_t,typename integer_t> class EliminationTree;
+  template<typename factor_t,typename refine_t,typename integer_t>
+  class SparseSolverMixedPrecision;
   class TaskTimer;
 
   /**
@@ -79,6 +81,7 @@ namespace strumpack {
     using Reord_t = MatrixReordering<scalar_t,integer_t>;
     using DenseM_t = DenseMatrix<scalar_t>;
     using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 
   public:
 
@@ -219,13 +222,122 @@ namespace strumpack {
      */
     void update_matrix_values(const CSRMatrix<scalar_t,integer_t>& A);
 
+    /**
+     * Compute selected entries of the inverse of the matrix, using
+     * the Takahashi recurrences on the sparse factors, without
+     * forming any column of the inverse. The matrix will be factored
+     * first if that was not done yet. The requested entries are given
+     * as an NxN CSR sparsity pattern, and entry (i,j) can only be
+     * computed if it is in the sparsity pattern of the factors, which
+     * includes all (i,j) for which A(j,i) is nonzero. Requesting the
+     * entries in the sparsity pattern of A^T (or of A if A has a
+     * symmetric pattern) is always safe.
+     *
+     * This is currently only supported for dense and BLR fronts, and
+     * for BLR fronts the result is only as accurate as the BLR
+     * approximation. For other front types, or for entries outside
+     * the sparsity pattern of the factors,
+     * ReturnCode::NOT_SUPPORTED is returned.
+     *
+     * \param N number of rows and columns, should be the size of the
+     * matrix.
+     * \param row_ptr indices in col_ind and values for the start of
+     * each row. Entries for row r are in [row_ptr[r],row_ptr[r+1])
+     * \param col_ind column indices of the requested entries
+     * \param values output, entries of the inverse corresponding to
+     * row_ptr and col_ind
+     *
+     * \see inverse_diagonal
+     */
+    ReturnCode selected_inverse(integer_t N,
+                                const integer_t* row_ptr,
+                                const integer_t* col_ind,
+                                scalar_t* values);
+
+    /**
+     * Compute the diagonal of the inverse of the matrix. This is a
+     * special case of selected_inverse, and has the same
+     * restrictions.
+     *
+     * \param d output, array of size N, the number of rows of the
+     * matrix, will hold the diagonal of the inverse.
+     *
+     * \see selected_inverse
+     */
+    ReturnCode inverse_diagonal(scalar_t* d);
+
+    /**
+     * Solve a linear system with a sparse right-hand side, and/or
+     * compute only selected entries of the solution. Fronts in the
+     * elimination tree which do not lie on a path from a nonzero row
+     * of b to the root are skipped in the forward solve, and only the
+     * fronts on a path from the root to a requested row of x are
+     * visited in the backward solve. The matrix will be factored
+     * first if that was not done yet. This always performs a single
+     * direct solve, without iterative refinement, regardless of
+     * options().Krylov_solver().
+     *
+     * \param b right-hand side, N x nrhs. Only the rows listed in
+     * b_rows are read, the other rows are assumed to be zero.
+     * \param x output, N x nrhs. Only the rows listed in x_rows are
+     * computed, the other rows are set to zero.
+     * \param b_rows the (possibly) nonzero rows of b, or an empty
+     * vector if all rows of b should be used
+     * \param x_rows the rows of the solution to compute, or an empty
+     * vector to compute the full solution
+     *
+     * \see solve
+     */
+    ReturnCode solve_sparse(const DenseM_t& b, DenseM_t& x,
+                            const std::vector<integer_t>& b_rows,
+                            const std::vector<integer_t>& x_rows);
+
+    /**
+     * Set the unknowns for which the Schur complement will be
+     * computed, see get_schur_complement. These unknowns are ordered
+     * last, and form the separator of the root of the elimination
+     * tree. This needs to be called before the reordering, since it
+     * changes the reordering. Since the Schur complement is defined
+     * in terms of rows and columns of A with the same indices, this
+     * disables the matching (column permutation), see
+     * SPOptions::set_matching.
+     *
+     * \param S indices of the Schur complement unknowns, in the
+     * original numbering, without duplicates. An empty vector
+     * disables the Schur complement computation.
+     *
+     * \see get_schur_complement
+     */
+    void set_schur_indices(const std::vector<integer_t>& S);
+
+    /**
+     * Compute the dense Schur complement S = A_SS - A_SI A_II^{-1}
+     * A_IS, for the unknowns S set with set_schur_indices, and I all
+     * other unknowns. This will reorder and factor the matrix if that
+     * was not done yet. The factorization stops before the root front
+     * of the elimination tree, which is only assembled, and its
+     * separator block is the Schur complement. The root is factored
+     * on the first call to solve.
+     *
+     * \param S output, the Schur complement, of size |S| x |S|, with
+     * rows and columns in the order given to set_schur_indices.
+     * \return ReturnCode::NOT_SUPPORTED if no Schur complement
+     * indices were set, or if the elimination tree is empty
+     *
+     * \see set_schur_indices
+     */
+    ReturnCode get_schur_complement(DenseM_t& S);
+
   private:
     void setup_tree() override;
     void setup_reordering() override;
     int compute_reordering(const int* p, int base,
                            int nx, int ny, int nz,
-                           int components, int width) override;
+                           int components, int width,
+                           const DenseMatrix<real_t>* coords) override;
     void separator_reordering() override;
+    void write_analysis(std::ostream& os) const override;
+    void read_analysis(std::istream& is) override;
 
     SpMat_t* matrix() override { return mat_.get(); }
     Reord_t* reordering() override { return nd_.get(); }
@@ -243,13 +355,27 @@ namespace strumpack {
 
     void delete_factors_internal() override;
 
+    // factor the root front if it was left unfactored for the Schur
+    // complement computation
+    ReturnCode factor_schur_root();
+
+    void set_matrix(std::unique_ptr<CSRMatrix<scalar_t,integer_t>> A);
+    void update_matrix_values
+    (std::unique_ptr<CSRMatrix<scalar_t,integer_t>> A);
+
     void transform_x0(DenseM_t& x, DenseM_t& xtmp);
-    void transform_b(const DenseM_t& b, DenseM_t& bloc);
     void transform_x(DenseM_t& x, DenseM_t& xtmp);
+    // b (or x) can be in a different precision than scalar_t, the
+    // conversion is done while permuting/scaling
+    template<typename b_t> void
+    transform_b(const DenseMatrix<b_t>& b, DenseM_t& bloc);
+    template<typename x_t> void
+    transform_x(const DenseM_t& xloc, DenseMatrix<x_t>& x);
 
     std::unique_ptr<CSRMatrix<scalar_t,integer_t>> mat_;
     std::unique_ptr<MatrixReordering<scalar_t,integer_t>> nd_;
     std::unique_ptr<EliminationTree<scalar_t,integer_t>> tree_;
+    std::vector<integer_t> schur_;
 
     using SPBase_t = SparseSolverBase<scalar_t,integer_t>;
     using SPBase_t::opts_;
@@ -260,6 +386,9 @@ namespace strumpack {
     using SPBase_t::reordered_;
     using SPBase_t::Krylov_its_;
     using SPBase_t::solve_internal;
+
+    template<typename factor_t,typename refine_t,typename index_t>
+    friend class SparseSolverMixedPrecision;
   };
 
   template<typename scalar_t,typename integer_t>
@@ -42,6 +42,7 @@ namespace strumpack {
 
   // forward declarations
   template<typename scalar_t,typename integer_t> class MatrixReorderingMPI;
+  template<typename integer_t> class PermutePlanMPI;
 
   /**
    * \class SparseSolverMPIDist
@@ -76,6 +77,7 @@ namespace strumpack {
     using Reord_t = MatrixReordering<scalar_t,integer_t>;
     using DenseM_t = DenseMatrix<scalar_t>;
     using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 
   public:
     /**
@@ -306,7 +308,8 @@ namespace strumpack {
     void setup_tree() override;
     void setup_reordering() override;
     int compute_reordering(const int* p, int base, int nx, int ny, int nz,
-                           int components, int width) override;
+                           int components, int width,
+                           const DenseMatrix<real_t>* coords) override;
     void separator_reordering() override;
 
     void perf_counters_stop(const std::string& s) override;
@@ -314,10 +317,13 @@ namespace strumpack {
     void reduce_flop_counters() const override;
 
     double max_peak_memory() const override {
-      return comm_.reduce(double(params::peak_memory), MPI_MAX);
+      return comm_.all_reduce(double(params::peak_memory), MPI_MAX);
     }
     double min_peak_memory() const override {
-      return comm_.reduce(double(params::peak_memory), MPI_MIN);
+      return comm_.all_reduce(double(params::peak_memory), MPI_MIN);
+    }
+    long long int all_reduce_sum(long long int v) const override {
+      return comm_.all_reduce(v, MPI_SUM);
     }
 
     void redistribute_values();
@@ -338,6 +344,7 @@ namespace strumpack {
     std::unique_ptr<CSRMatrixMPI<scalar_t,integer_t>> mat_mpi_;
     std::unique_ptr<MatrixReorderingMPI<scalar_t,integer_t>> nd_mpi_;
     std::unique_ptr<EliminationTreeMPIDist<scalar_t,integer_t>> tree_mpi_dist_;
+    std::unique_ptr<PermutePlanMPI<integer_t>> matching_plan_;
   };
 
   template<typename scalar_t,typename integer_t>
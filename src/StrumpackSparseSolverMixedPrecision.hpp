@@ -151,10 +151,15 @@ namespace strumpack {
     int Krylov_iterations() const { return Krylov_its_; }
 
   private:
-    CSRMatrix<refine_t,integer_t> mat_;
+    std::unique_ptr<CSRMatrix<refine_t,integer_t>> mat_;
     SparseSolver<factor_t,integer_t> solver_;
     SPOptions<refine_t> opts_;
     int Krylov_its_ = 0;
+    // permuted right hand side for the inner solve, reused
+    DenseMatrix<factor_t> work_;
+
+    void inner_solve(const DenseMatrix<refine_t>& b,
+                     DenseMatrix<refine_t>& x);
   };
 
   template<typename factor_t,typename refine_t,typename integer_t>
@@ -87,11 +87,13 @@ module strumpack
   enumerator :: STRUMPACK_MATCHING_MAX_DIAGONAL_SUM = 4
   enumerator :: STRUMPACK_MATCHING_MAX_DIAGONAL_PRODUCT_SCALING = 5
   enumerator :: STRUMPACK_MATCHING_COMBBLAS = 6
+  enumerator :: STRUMPACK_MATCHING_AUCTION = 7
  end enum
  integer, parameter, public :: STRUMPACK_MATCHING_JOB = kind(STRUMPACK_MATCHING_NONE)
  public :: STRUMPACK_MATCHING_NONE, STRUMPACK_MATCHING_MAX_CARDINALITY, STRUMPACK_MATCHING_MAX_SMALLEST_DIAGONAL, &
     STRUMPACK_MATCHING_MAX_SMALLEST_DIAGONAL_2, STRUMPACK_MATCHING_MAX_DIAGONAL_SUM, &
-    STRUMPACK_MATCHING_MAX_DIAGONAL_PRODUCT_SCALING, STRUMPACK_MATCHING_COMBBLAS
+    STRUMPACK_MATCHING_MAX_DIAGONAL_PRODUCT_SCALING, STRUMPACK_MATCHING_COMBBLAS, &
+    STRUMPACK_MATCHING_AUCTION
  ! typedef enum STRUMPACK_REORDERING_STRATEGY
  enum, bind(c)
   enumerator :: STRUMPACK_NATURAL = 0
@@ -152,10 +154,11 @@ module strumpack
   enumerator :: STRUMPACK_ZERO_PIVOT = 3
   enumerator :: STRUMPACK_NO_CONVERGENCE = 4
   enumerator :: STRUMPACK_INACCURATE_INERTIA = 5
+  enumerator :: STRUMPACK_NOT_SUPPORTED = 6
  end enum
  integer, parameter, public :: STRUMPACK_RETURN_CODE = kind(STRUMPACK_SUCCESS)
  public :: STRUMPACK_SUCCESS, STRUMPACK_MATRIX_NOT_SET, STRUMPACK_REORDERING_ERROR, STRUMPACK_ZERO_PIVOT, &
-    STRUMPACK_NO_CONVERGENCE, STRUMPACK_INACCURATE_INERTIA
+    STRUMPACK_NO_CONVERGENCE, STRUMPACK_INACCURATE_INERTIA, STRUMPACK_NOT_SUPPORTED
  public :: STRUMPACK_init_mt
  public :: STRUMPACK_set_distributed_csr_matrix
  public :: STRUMPACK_update_distributed_csr_matrix_values
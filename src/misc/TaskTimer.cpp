@@ -34,6 +34,7 @@
 #include <omp.h>
 #endif
 #include "TaskTimer.hpp"
+#include "Trace.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "misc/MPIWrapper.hpp"
 #endif
@@ -223,6 +224,9 @@ TimerList::TimerList() : is_finalized(false) {
 
 void TimerList::Finalize() {
   TaskTimer::time_log_list.finalize();
+#if defined(STRUMPACK_TRACE)
+  Trace::write();
+#endif
 }
 
 void TimerList::finalize() {
@@ -31,6 +31,11 @@
 
 #include <vector>
 #include <iomanip>
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
 #include "StrumpackConfig.hpp"
 #include "StrumpackParameters.hpp"
 #include "dense/BLASLAPACKWrapper.hpp"
@@ -280,6 +285,49 @@ namespace strumpack {
     return ss.str();
   }
 
+  /**
+   * Raw binary output of a trivially copyable value, or a vector of
+   * such values (size first). Used to store the analysis phase, see
+   * SparseSolver::save_analysis.
+   */
+  template<typename T> void write_binary(std::ostream& os, const T& v) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "write_binary requires a trivially copyable type");
+    os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+  }
+  template<typename T> void
+  write_binary(std::ostream& os, const std::vector<T>& v) {
+    write_binary(os, std::uint64_t(v.size()));
+    os.write(reinterpret_cast<const char*>(v.data()), v.size()*sizeof(T));
+  }
+  inline void write_binary(std::ostream& os, const std::string& s) {
+    write_binary(os, std::vector<char>(s.begin(), s.end()));
+  }
+
+  /**
+   * Counterpart of write_binary, throws std::runtime_error when the
+   * stream cannot be read.
+   */
+  template<typename T> void read_binary(std::istream& is, T& v) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "read_binary requires a trivially copyable type");
+    if (!is.read(reinterpret_cast<char*>(&v), sizeof(T)))
+      throw std::runtime_error("unexpected end of file");
+  }
+  template<typename T> void
+  read_binary(std::istream& is, std::vector<T>& v) {
+    std::uint64_t n;
+    read_binary(is, n);
+    v.resize(n);
+    if (!is.read(reinterpret_cast<char*>(v.data()), n*sizeof(T)))
+      throw std::runtime_error("unexpected end of file");
+  }
+  inline void read_binary(std::istream& is, std::string& s) {
+    std::vector<char> v;
+    read_binary(is, v);
+    s.assign(v.begin(), v.end());
+  }
+
 } // end namespace strumpack
 
 #endif // STRUMPACK_TOOLS_HPP
@@ -0,0 +1,178 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cstdlib>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include "Trace.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "misc/MPIWrapper.hpp"
+#endif
+
+namespace strumpack {
+
+  namespace {
+
+    struct TraceEvent {
+      const char* name;
+      double begin, end;
+      std::int64_t front, dsep, dupd;
+    };
+
+    struct TraceBuffer {
+      TraceBuffer(std::size_t capacity, int id)
+        : events(capacity), tid(id) {}
+      std::vector<TraceEvent> events;
+      std::size_t recorded = 0;
+      int tid;
+    };
+
+    std::mutex trace_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> trace_buffers;
+    thread_local TraceBuffer* trace_buffer = nullptr;
+
+    const auto trace_t0 = std::chrono::steady_clock::now();
+
+    std::size_t trace_capacity() {
+      auto s = std::getenv("STRUMPACK_TRACE_EVENTS");
+      long c = s ? std::atol(s) : 0;
+      return c > 0 ? std::size_t(c) : std::size_t(65536);
+    }
+
+    // this is called once per thread, after that recording does not
+    // need the lock
+    TraceBuffer* register_trace_buffer() {
+      std::lock_guard<std::mutex> lock(trace_mutex);
+      trace_buffers.emplace_back
+        (new TraceBuffer(trace_capacity(), trace_buffers.size()));
+      return trace_buffers.back().get();
+    }
+
+    void write_events(std::ostream& os, int pid, bool& first) {
+      os.precision(15);
+      for (auto& b : trace_buffers) {
+        auto n = std::min(b->recorded, b->events.size());
+        for (std::size_t i=b->recorded-n; i<b->recorded; i++) {
+          auto& e = b->events[i % b->events.size()];
+          if (!first) os << ",\n";
+          first = false;
+          os << "{\"name\":\"" << e.name << "\",\"cat\":\"strumpack\","
+             << "\"ph\":\"X\",\"ts\":" << e.begin
+             << ",\"dur\":" << e.end - e.begin
+             << ",\"pid\":" << pid << ",\"tid\":" << b->tid;
+          if (e.front >= 0)
+            os << ",\"args\":{\"front\":" << e.front
+               << ",\"dim_sep\":" << e.dsep
+               << ",\"dim_upd\":" << e.dupd << "}";
+          os << "}";
+        }
+        if (b->recorded > b->events.size()) {
+          if (!first) os << ",\n";
+          first = false;
+          os << "{\"name\":\"dropped_events\",\"ph\":\"i\",\"s\":\"t\","
+             << "\"ts\":0,\"pid\":" << pid << ",\"tid\":" << b->tid
+             << ",\"args\":{\"count\":"
+             << b->recorded - b->events.size() << "}}";
+        }
+      }
+    }
+
+  } // end anonymous namespace
+
+  bool Trace::enabled_ = std::getenv("STRUMPACK_TRACE_FILE") != nullptr;
+
+  double Trace::now() {
+    return std::chrono::duration<double,std::micro>
+      (std::chrono::steady_clock::now() - trace_t0).count();
+  }
+
+  void Trace::record(const char* name, double begin, std::int64_t front,
+                     std::int64_t dsep, std::int64_t dupd) {
+    if (!trace_buffer) trace_buffer = register_trace_buffer();
+    auto& b = *trace_buffer;
+    b.events[b.recorded++ % b.events.size()] =
+      {name, begin, now(), front, dsep, dupd};
+  }
+
+  void Trace::write() {
+    if (!enabled_) return;
+    std::string fname(std::getenv("STRUMPACK_TRACE_FILE"));
+    std::ostringstream os;
+    bool first = true;
+    int rank = 0;
+#if defined(STRUMPACK_USE_MPI)
+    int mpi_initialized, mpi_finalized;
+    MPI_Initialized(&mpi_initialized);
+    MPI_Finalized(&mpi_finalized);
+    if (mpi_initialized && mpi_finalized) {
+      std::cerr << "# Warning, not writing " << fname
+                << ", since MPI_Finalize has already been called."
+                << std::endl;
+      return;
+    }
+    if (mpi_initialized) {
+      MPIComm c;
+      rank = c.rank();
+      write_events(os, rank, first);
+      auto s = os.str();
+      int len = s.size(), P = c.size();
+      std::vector<int> lens(rank ? 0 : P), displs(rank ? 0 : P);
+      MPI_Gather(&len, 1, MPI_INT, lens.data(), 1, MPI_INT, 0, c.comm());
+      std::string all;
+      if (!rank) {
+        for (int p=1; p<P; p++) displs[p] = displs[p-1] + lens[p-1];
+        all.resize(displs[P-1] + lens[P-1]);
+      }
+      MPI_Gatherv(s.data(), len, MPI_CHAR, &all[0], lens.data(),
+                  displs.data(), MPI_CHAR, 0, c.comm());
+      if (rank) return;
+      // ranks with no events sent an empty string
+      os.str("");
+      first = true;
+      for (int p=0; p<P; p++) {
+        if (!lens[p]) continue;
+        if (!first) os << ",\n";
+        first = false;
+        os.write(all.data()+displs[p], lens[p]);
+      }
+    } else write_events(os, rank, first);
+#else
+    write_events(os, rank, first);
+#endif
+    std::ofstream f(fname);
+    f << "{\"traceEvents\":[\n" << os.str()
+      << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  }
+
+} // end namespace strumpack
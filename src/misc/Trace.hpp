@@ -0,0 +1,135 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file Trace.hpp
+ * \brief Event recorder, to write a timeline of the multifrontal
+ * factorization and solve in the Chrome trace event format.
+ */
+#ifndef STRUMPACK_TRACE_HPP
+#define STRUMPACK_TRACE_HPP
+
+#include <cstdint>
+#include "StrumpackConfig.hpp"
+
+namespace strumpack {
+
+  /**
+   * \class Trace
+   *
+   * \brief Records the begin and end time of tasks, such as the
+   * assembly, extend-add, factorization and solve of the fronts.
+   *
+   * This is only compiled in when STRUMPACK is configured with
+   * -DSTRUMPACK_TRACE=ON, and then it is only active when the
+   * environment variable STRUMPACK_TRACE_FILE is set to the name of
+   * the output file. Every thread records into its own fixed size
+   * ring buffer (no locks or atomics, when the buffer is full the
+   * oldest events are overwritten). The size of the ring buffers can
+   * be set with the environment variable STRUMPACK_TRACE_EVENTS
+   * (default 65536 events per thread).
+   *
+   * The events are written, in the Chrome trace event JSON format,
+   * by TimerList::Finalize(). With MPI, the events of all ranks are
+   * gathered and written to a single file by rank 0, with the rank
+   * as the process id. The resulting file can be opened in
+   * chrome://tracing or https://ui.perfetto.dev.
+   */
+  class Trace {
+  public:
+    /**
+     * Is the recorder active, ie, was STRUMPACK_TRACE_FILE set?
+     */
+    static bool enabled() { return enabled_; }
+
+    /**
+     * Current time in micro seconds.
+     */
+    static double now();
+
+    /**
+     * Record an event in the ring buffer of the calling thread.
+     *
+     * \param name name of the event, should be a string literal, as
+     * only the pointer is stored
+     * \param begin start time, obtained with now()
+     * \param front id of the front, or -1
+     * \param dsep dimension of the separator of the front
+     * \param dupd dimension of the update of the front
+     */
+    static void record(const char* name, double begin, std::int64_t front,
+                       std::int64_t dsep, std::int64_t dupd);
+
+    /**
+     * Write all recorded events to STRUMPACK_TRACE_FILE. This is
+     * collective on MPI_COMM_WORLD when running with MPI. No other
+     * threads should be recording events during this call.
+     */
+    static void write();
+
+  private:
+    static bool enabled_;
+  };
+
+  /**
+   * Scoped event, recorded from construction to destruction, when
+   * the Trace recorder is enabled.
+   */
+  class TraceScope {
+  public:
+    TraceScope(const char* name, std::int64_t front=-1,
+               std::int64_t dsep=0, std::int64_t dupd=0)
+      : name_(name), front_(front), dsep_(dsep), dupd_(dupd),
+        begin_(Trace::enabled() ? Trace::now() : -1.) {}
+    ~TraceScope() {
+      if (begin_ >= 0.)
+        Trace::record(name_, begin_, front_, dsep_, dupd_);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+    const char* name_;
+    std::int64_t front_, dsep_, dupd_;
+    double begin_;
+  };
+
+#define STRUMPACK_TRACE_CONCAT_(a, b) a##b
+#define STRUMPACK_TRACE_CONCAT(a, b) STRUMPACK_TRACE_CONCAT_(a, b)
+
+#if defined(STRUMPACK_TRACE)
+#define TRACE_SCOPE(name, front, dsep, dupd)                            \
+  TraceScope STRUMPACK_TRACE_CONCAT(trace_scope_, __LINE__)             \
+  (name, front, dsep, dupd)
+#else
+#define TRACE_SCOPE(name, front, dsep, dupd) (void)0
+#endif
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_TRACE_HPP
@@ -0,0 +1,288 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file AuctionMatchingMPI.hpp
+ * \brief Distributed approximate maximum product matching and
+ * scaling, using an auction algorithm on a block-row distributed
+ * CSR matrix.
+ */
+#ifndef STRUMPACK_AUCTION_MATCHING_MPI_HPP
+#define STRUMPACK_AUCTION_MATCHING_MPI_HPP
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#include "CSRMatrixMPI.hpp"
+#include "misc/Triplet.hpp"
+
+namespace strumpack {
+
+  /**
+   * Compute a (column) matching for the block-row distributed matrix
+   * A, which approximately maximizes the product of the absolute
+   * values of the diagonal elements, plus row and column scaling
+   * factors, such that the scaled, permuted matrix has entries with
+   * absolute value <= 1, and diagonal elements >= exp(-eps), with
+   * eps a small tolerance.
+   *
+   * This implements a (Jacobi style) distributed auction algorithm
+   * [Bertsekas, Castanon 1991] with eps-scaling, on the weights
+   * log|a_ij| - log max_i |a_ij|. The rows act as bidders, and are
+   * handled by the process owning the row, the columns are the
+   * objects, handled by the process owning the row with the same
+   * index. The matrix is never gathered, only the permutation Q and
+   * the column scaling C are (as for all other matchings) returned
+   * as global vectors. The dual variables (prices and profits) of
+   * the auction define the scaling.
+   *
+   * \param A block-row distributed matrix, not modified
+   * \param M output, the Q, R (local) and C (global) vectors should
+   * already be allocated
+   * \param max_rounds maximum number of bidding rounds, summed over
+   * all eps-scaling phases
+   * \return 0 on success, 1 if the auction did not find a perfect
+   * matching within max_rounds, this can happen if the matrix is
+   * structurally singular
+   */
+  template<typename scalar_t,typename integer_t,typename real_t> int
+  auction_matching(const CSRMatrixMPI<scalar_t,integer_t>& A,
+                   MatchingData<scalar_t,integer_t,real_t>& M,
+                   int max_rounds=100000) {
+    using Bid_t = Triplet<real_t,integer_t>;
+    const auto& c = A.Comm();
+    const int P = c.size();
+    const integer_t n = A.size(), lrows = A.local_rows(),
+      brow = A.begin_row();
+    const auto& dist = A.dist();
+    const real_t inf = std::numeric_limits<real_t>::infinity();
+    auto owner = [&dist](integer_t i) {
+      return int(std::upper_bound(dist.begin(), dist.end(), i)
+                 - dist.begin()) - 1;
+    };
+    // global max over each column, for the weights
+    std::vector<real_t> cmax(n, 0.);
+    for (integer_t r=0; r<lrows; r++)
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++)
+        cmax[A.ind(j)] =
+          std::max(cmax[A.ind(j)], real_t(std::abs(A.val(j))));
+    c.all_reduce(cmax, MPI_MAX);
+    // a zero row or column, the matrix is structurally singular
+    int zero = std::any_of(cmax.begin(), cmax.end(),
+                           [](real_t m) { return m == real_t(0.); });
+    for (integer_t r=0; r<lrows; r++) {
+      real_t rmax = 0.;
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++)
+        rmax = std::max(rmax, real_t(std::abs(A.val(j))));
+      if (rmax == real_t(0.)) zero = 1;
+    }
+    if (c.all_reduce(zero, MPI_MAX)) return 1;
+
+    // The columns referenced by the local rows, sorted, and for each
+    // nonzero the index in this list. pcache holds the (possibly
+    // outdated) prices of those columns. Prices only increase.
+    std::vector<integer_t> cols(A.ind(), A.ind()+A.local_nnz()),
+      ci(A.local_nnz());
+    std::sort(cols.begin(), cols.end());
+    cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+    std::vector<real_t> w(A.local_nnz()), pcache(cols.size(), 0.);
+    real_t wmin = 0.;
+    for (integer_t r=0; r<lrows; r++)
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++) {
+        ci[j] = std::lower_bound(cols.begin(), cols.end(), A.ind(j))
+          - cols.begin();
+        auto a = std::abs(A.val(j));
+        w[j] = (a == 0) ? -inf :
+          real_t(std::log(a)) - real_t(std::log(cmax[A.ind(j)]));
+        if (a != 0) wmin = std::min(wmin, w[j]);
+      }
+    wmin = c.all_reduce(wmin, MPI_MIN);
+    const real_t wrange = -wmin;
+    auto cache_index = [&cols](integer_t j) {
+      return std::lower_bound(cols.begin(), cols.end(), j) - cols.begin();
+    };
+
+    // state of the owned columns: price and current holder
+    std::vector<real_t> price(lrows, 0.);
+    std::vector<integer_t> holder(lrows, -1), assigned(lrows, -1);
+
+    // refresh the price cache from the column owners
+    auto fetch_prices = [&]() {
+      std::vector<std::vector<integer_t>> sreq(P);
+      for (auto j : cols) sreq[owner(j)].push_back(j);
+      std::vector<std::size_t> roff(P+1, 0);
+      for (int p=0; p<P; p++) roff[p+1] = roff[p] + sreq[p].size();
+      // number of requests received from each rank
+      std::vector<int> scnt(P), rcnt(P);
+      for (int p=0; p<P; p++) scnt[p] = sreq[p].size();
+      c.all_to_all(scnt.data(), 1, rcnt.data());
+      std::vector<integer_t> rreq;
+      std::vector<integer_t*> preq;
+      c.all_to_all_v(sreq, rreq, preq);
+      std::vector<std::vector<real_t>> sprice(P);
+      for (int p=0; p<P; p++) {
+        sprice[p].reserve(rcnt[p]);
+        for (auto j=preq[p]; j!=preq[p]+rcnt[p]; j++)
+          sprice[p].push_back(price[*j-brow]);
+      }
+      std::vector<real_t> rprice;
+      std::vector<real_t*> pprice;
+      c.all_to_all_v(sprice, rprice, pprice);
+      // cols is sorted, so the columns of each owner are contiguous
+      for (int p=0; p<P; p++)
+        std::copy(pprice[p], pprice[p] + (roff[p+1] - roff[p]),
+                  pcache.begin() + roff[p]);
+    };
+
+    const real_t eps_final = 1e-3, theta = 6.;
+    real_t eps = std::max(wrange / theta, eps_final);
+    // profit of row r, and value of column j for row r, with the
+    // cached prices
+    auto profit = [&](integer_t r) {
+      real_t pi = -inf;
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++)
+        pi = std::max(pi, w[j] - pcache[ci[j]]);
+      return pi;
+    };
+    auto value = [&](integer_t r, integer_t col) {
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++)
+        if (A.ind(j) == col) return w[j] - pcache[ci[j]];
+      return -inf;
+    };
+    int rounds = 0;
+    bool converged = false;
+    integer_t unassigned = n;
+    while (rounds < max_rounds) {
+      while (unassigned && rounds < max_rounds) {
+        rounds++;
+        // every unassigned row bids for its best column
+        std::vector<std::vector<Bid_t>> sbids(P);
+        for (integer_t r=0; r<lrows; r++) {
+          if (assigned[r] != -1) continue;
+          real_t v1 = -inf, v2 = -inf;
+          integer_t j1 = -1;
+          for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++) {
+            if (w[j] == -inf) continue;
+            auto v = w[j] - pcache[ci[j]];
+            if (v > v1) { v2 = v1; v1 = v; j1 = j; }
+            else if (v > v2) v2 = v;
+          }
+          if (v2 == -inf) v2 = v1 - wrange - eps;
+          sbids[owner(A.ind(j1))].emplace_back
+            (r+brow, A.ind(j1), pcache[ci[j1]] + v1 - v2 + eps);
+        }
+        auto rbids = c.all_to_all_v(sbids);
+        // the column owner accepts the highest bid, if larger than
+        // the current price, evicts the previous holder, and sends
+        // the price back to all bidders
+        std::sort(rbids.begin(), rbids.end(),
+                  [](const Bid_t& a, const Bid_t& b) {
+                    return (a.c < b.c) || (a.c == b.c && a.v > b.v) ||
+                      (a.c == b.c && a.v == b.v && a.r < b.r); });
+        std::vector<std::vector<Bid_t>> sreply(P);
+        for (std::size_t i=0; i<rbids.size(); ) {
+          auto jl = rbids[i].c - brow;
+          auto& b = rbids[i];
+          if (b.v > price[jl] || (holder[jl] == -1 && b.v >= price[jl])) {
+            if (holder[jl] != -1)
+              sreply[owner(holder[jl])].emplace_back
+                (holder[jl], -b.c-1, b.v);
+            holder[jl] = b.r;
+            price[jl] = b.v;
+            sreply[owner(b.r)].emplace_back(b.r, b.c, b.v);
+          } else
+            sreply[owner(b.r)].emplace_back(b.r, -b.c-1, price[jl]);
+          for (i++; i<rbids.size() && rbids[i].c == jl+brow; i++)
+            sreply[owner(rbids[i].r)].emplace_back
+              (rbids[i].r, -rbids[i].c-1, price[jl]);
+        }
+        for (auto& r : c.all_to_all_v(sreply)) {
+          auto j = (r.c < 0) ? -r.c-1 : r.c;
+          auto& pj = pcache[cache_index(j)];
+          pj = std::max(pj, r.v);
+          if (r.c >= 0) assigned[r.r-brow] = j;
+          else if (assigned[r.r-brow] == j) assigned[r.r-brow] = -1;
+        }
+        unassigned = c.all_reduce
+          (integer_t(std::count(assigned.begin(), assigned.end(),
+                                integer_t(-1))), MPI_SUM);
+      }
+      if (unassigned) break;
+      fetch_prices();
+      if (eps <= eps_final) {
+        converged = true;
+        break;
+      }
+      eps = std::max(eps / theta, eps_final);
+      // Keep the assignments which satisfy eps-complementary
+      // slackness for the new eps, release the others. This avoids
+      // restarting every phase from scratch.
+      std::vector<std::vector<integer_t>> srel(P);
+      for (integer_t r=0; r<lrows; r++)
+        if (assigned[r] != -1 && value(r, assigned[r]) < profit(r) - eps) {
+          srel[owner(assigned[r])].push_back(assigned[r]);
+          assigned[r] = -1;
+        }
+      for (auto j : c.all_to_all_v(srel))
+        holder[j-brow] = -1;
+      unassigned = c.all_reduce
+        (integer_t(std::count(assigned.begin(), assigned.end(),
+                              integer_t(-1))), MPI_SUM);
+    }
+    if (!converged) return 1;
+
+    // Scaling from the dual variables: with profit pi_i = max_j (w_ij
+    // - p_j), R_i = exp(-pi_i) and C_j = exp(-p_j) / cmax_j, so that
+    // |R_i a_ij C_j| = exp(w_ij - p_j - pi_i) <= 1.
+    M.R.resize(lrows);
+    for (integer_t r=0; r<lrows; r++)
+      M.R[r] = std::exp(-profit(r));
+    std::vector<real_t> lC(lrows);
+    for (integer_t r=0; r<lrows; r++)
+      lC[r] = std::exp(-price[r]) / cmax[r+brow];
+    std::vector<int> rcnts(P), displs(P);
+    for (int p=0; p<P; p++) {
+      rcnts[p] = dist[p+1] - dist[p];
+      displs[p] = dist[p];
+    }
+    M.C.resize(n);
+    M.Q.resize(n);
+    MPI_Allgatherv(lC.data(), lrows, mpi_type<real_t>(), M.C.data(),
+                   rcnts.data(), displs.data(), mpi_type<real_t>(),
+                   c.comm());
+    MPI_Allgatherv(assigned.data(), lrows, mpi_type<integer_t>(),
+                   M.Q.data(), rcnts.data(), displs.data(),
+                   mpi_type<integer_t>(), c.comm());
+    return 0;
+  }
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_AUCTION_MATCHING_MPI_HPP
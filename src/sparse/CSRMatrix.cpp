@@ -35,6 +35,7 @@
 
 #include "CSRMatrix.hpp"
 #include "MC64ad.hpp"
+#include "CSRMatrixMMap.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "dense/DistributedMatrix.hpp"
 #endif
@@ -102,30 +103,29 @@ namespace strumpack {
   CSRMatrix<scalar_t,integer_t>::print_binary
   (const std::string& filename) const {
     std::ofstream fs(filename, std::ofstream::binary);
-    char s = 'R';
-    fs.write(&s, sizeof(char));
-    if (std::is_same<integer_t,int>()) s = '4';
-    else if (std::is_same<integer_t,int64_t>()) s = '8';
-    fs.write(&s, sizeof(char));
-    if (is_complex<scalar_t>()) {
-      if (std::is_same<real_t,float>()) s = 'c';
-      else if (std::is_same<real_t,double>()) s = 'z';
-    } else {
-      if (std::is_same<real_t,float>()) s = 's';
-      else if (std::is_same<real_t,double>()) s = 'd';
-    }
-    fs.write(&s, sizeof(char));
-    fs.write((char*)&n_, sizeof(integer_t));
-    fs.write((char*)&n_, sizeof(integer_t));
-    fs.write((char*)&nnz_, sizeof(integer_t));
-
-    for (integer_t i=0; i<n_+1; i++)
-      fs.write((char*)(&ptr_[i]), sizeof(integer_t));
-    for (integer_t i=0; i<nnz_; i++)
-      fs.write((char*)(&ind_[i]), sizeof(integer_t));
-    for (integer_t i=0; i<nnz_; i++)
-      fs.write((char*)(&(val_[i])), sizeof(scalar_t));
-
+    BinaryCSRHeader h;
+    h.set<scalar_t,integer_t>(n_, nnz_, symm_sparse_);
+    h.ptr_checksum = binary_csr_checksum
+      (ptr_.data(), (n_+1)*sizeof(integer_t));
+    h.ind_checksum = binary_csr_checksum
+      (ind_.data(), nnz_*sizeof(integer_t));
+    h.val_checksum = binary_csr_checksum
+      (val_.data(), nnz_*sizeof(scalar_t));
+    h.header_checksum = h.compute_header_checksum();
+    const char zeros[BinaryCSRHeader::alignment] = {};
+    auto pad_to = [&](std::uint64_t offset) {
+      fs.write(zeros, offset - std::uint64_t(fs.tellp()));
+    };
+    fs.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    pad_to(h.ptr_offset);
+    fs.write(reinterpret_cast<const char*>(ptr_.data()),
+             (n_+1)*sizeof(integer_t));
+    pad_to(h.ind_offset);
+    fs.write(reinterpret_cast<const char*>(ind_.data()),
+             nnz_*sizeof(integer_t));
+    pad_to(h.val_offset);
+    fs.write(reinterpret_cast<const char*>(val_.data()),
+             nnz_*sizeof(scalar_t));
     if (!fs.good()) {
       std::cout << "Error writing to file !!" << std::endl;
       std::cout << "failbit = " << fs.fail() << std::endl;
@@ -140,6 +140,55 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   CSRMatrix<scalar_t,integer_t>::read_binary(const std::string& filename) {
     std::ifstream fs(filename, std::ifstream::in | std::ifstream::binary);
+    if (!fs.good()) {
+      std::cerr << "Error: could not open file " << filename << std::endl;
+      return 1;
+    }
+    BinaryCSRHeader h;
+    fs.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!h.valid_magic()) {
+      fs.clear();
+      fs.seekg(0);
+      return read_binary_v0(fs);
+    }
+    fs.seekg(0, std::ifstream::end);
+    if (h.check<scalar_t,integer_t>(fs.tellg()))
+      return 1;
+    n_ = h.n;
+    nnz_ = h.nnz;
+    symm_sparse_ = h.symm_sparse;
+    std::cout << "# Reading matrix with n="
+              << number_format_with_commas(n_)
+              << ", nnz=" << number_format_with_commas(nnz_)
+              << std::endl;
+    ptr_.resize(n_+1);
+    ind_.resize(nnz_);
+    val_.resize(nnz_);
+    fs.seekg(h.ptr_offset);
+    fs.read(reinterpret_cast<char*>(ptr_.data()), (n_+1)*sizeof(integer_t));
+    fs.seekg(h.ind_offset);
+    fs.read(reinterpret_cast<char*>(ind_.data()), nnz_*sizeof(integer_t));
+    fs.seekg(h.val_offset);
+    fs.read(reinterpret_cast<char*>(val_.data()), nnz_*sizeof(scalar_t));
+    fs.close();
+    if (binary_csr_checksum(ptr_.data(), (n_+1)*sizeof(integer_t))
+        != h.ptr_checksum ||
+        binary_csr_checksum(ind_.data(), nnz_*sizeof(integer_t))
+        != h.ind_checksum ||
+        binary_csr_checksum(val_.data(), nnz_*sizeof(scalar_t))
+        != h.val_checksum) {
+      std::cerr << "Error: checksum mismatch in binary CSR file "
+                << filename << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  // the original (unversioned) binary format: 'R', followed by a
+  // character for the integer size and a character for the scalar
+  // type, the sizes and then the three arrays without padding
+  template<typename scalar_t,typename integer_t> int
+  CSRMatrix<scalar_t,integer_t>::read_binary_v0(std::ifstream& fs) {
     char s;
     fs.read(&s, sizeof(s));
     if (s != 'R') {
@@ -155,10 +204,7 @@ namespace strumpack {
       return 1;
     }
     fs.read(&s, sizeof(s));
-    if ((!is_complex<scalar_t>() && std::is_same<real_t,float>() && s!='s') ||
-        (!is_complex<scalar_t>() && std::is_same<real_t,double>() && s!='d') ||
-        (is_complex<scalar_t>() && std::is_same<real_t,float>() && s!='c') ||
-        (is_complex<scalar_t>() && std::is_same<real_t,double>() && s!='z')) {
+    if (s != scalar_type_char<scalar_t>()) {
       std::cerr << "Error: scalar type of input matrix does not match,"
         " input matrix is of type " << s << std::endl;
       return 1;//throw "Error: scalar type of input matrix does not match";
@@ -174,12 +220,9 @@ namespace strumpack {
     ptr_.resize(n_+1);
     ind_.resize(nnz_);
     val_.resize(nnz_);
-    for (integer_t i=0; i<n_+1; i++)
-      fs.read((char*)(&ptr_[i]), sizeof(integer_t));
-    for (integer_t i=0; i<nnz_; i++)
-      fs.read((char*)(&ind_[i]), sizeof(integer_t));
-    for (integer_t i=0; i<nnz_; i++)
-      fs.read((char*)(&val_[i]), sizeof(scalar_t));
+    fs.read((char*)ptr_.data(), (n_+1)*sizeof(integer_t));
+    fs.read((char*)ind_.data(), nnz_*sizeof(integer_t));
+    fs.read((char*)val_.data(), nnz_*sizeof(scalar_t));
     fs.close();
     return 0;
   }
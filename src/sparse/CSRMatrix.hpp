@@ -34,6 +34,7 @@
 #define STRUMPACK_CSR_MATRIX_HPP
 
 #include <vector>
+#include <fstream>
 
 #include "CompressedSparseMatrix.hpp"
 #include "CSRGraph.hpp"
@@ -91,9 +92,30 @@ namespace strumpack {
     add_missing_diagonal(const scalar_t& s) const;
 
     int read_matrix_market(const std::string& filename) override;
+
+    /**
+     * Read a matrix written with print_binary. This reads the
+     * versioned binary CSR format, see BinaryCSRHeader, with a single
+     * bulk read per array, and checks the checksums. Files written in
+     * the original unversioned binary format are still accepted.
+     *
+     * To avoid the copy into this matrix altogether, use
+     * CSRMatrixMMap.
+     *
+     * \return 0 on success, nonzero on failure
+     * \see print_binary, CSRMatrixMMap
+     */
     int read_binary(const std::string& filename);
     void print_dense(const std::string& name) const override;
     void print_matrix_market(const std::string& filename) const override;
+
+    /**
+     * Write this matrix to a file in the versioned binary CSR
+     * format. The arrays are written aligned, so that the file can
+     * be memory mapped with CSRMatrixMMap.
+     *
+     * \see read_binary, CSRMatrixMMap, BinaryCSRHeader
+     */
     void print_binary(const std::string& filename) const;
 
     CSRGraph<integer_t>
@@ -196,6 +218,7 @@ namespace strumpack {
     void scale_real(const std::vector<real_t>& Dr,
                     const std::vector<real_t>& Dc) override;
     void sort_rows();
+    int read_binary_v0(std::ifstream& fs);
 
   private:
     using CSM_t::n_;
@@ -0,0 +1,330 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include <complex>
+#include <limits>
+
+#include "CSRMatrixMMap.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define STRUMPACK_USE_MMAP
+#endif
+
+namespace strumpack {
+
+  std::uint64_t binary_csr_checksum(const void* data, std::size_t bytes) {
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t h = 14695981039346656037ULL;
+    auto c = static_cast<const char*>(data);
+    std::size_t words = bytes / sizeof(std::uint64_t);
+    for (std::size_t i=0; i<words; i++) {
+      std::uint64_t w;
+      std::memcpy(&w, c + i*sizeof(std::uint64_t), sizeof(w));
+      h = (h ^ w) * prime;
+    }
+    for (std::size_t i=words*sizeof(std::uint64_t); i<bytes; i++)
+      h = (h ^ std::uint8_t(c[i])) * prime;
+    return h;
+  }
+
+  bool BinaryCSRHeader::valid_magic() const {
+    return std::memcmp(magic, BinaryCSRHeader().magic, sizeof(magic)) == 0;
+  }
+
+  std::uint64_t BinaryCSRHeader::compute_header_checksum() const {
+    BinaryCSRHeader h(*this);
+    h.header_checksum = 0;
+    return binary_csr_checksum(&h, sizeof(h));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  BinaryCSRHeader::set(std::uint64_t n_rows, std::uint64_t nonzeros,
+                       bool symm) {
+    auto align = [](std::uint64_t b) {
+      return (b + alignment - 1) / alignment * alignment;
+    };
+    integer_bytes = sizeof(integer_t);
+    scalar_type = scalar_type_char<scalar_t>();
+    symm_sparse = symm;
+    n = n_rows;
+    nnz = nonzeros;
+    ptr_offset = align(sizeof(BinaryCSRHeader));
+    ind_offset = align(ptr_offset + (n+1)*sizeof(integer_t));
+    val_offset = align(ind_offset + nnz*sizeof(integer_t));
+    file_bytes = val_offset + nnz*sizeof(scalar_t);
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  BinaryCSRHeader::check(std::uint64_t bytes) const {
+    if (!valid_magic()) {
+      std::cerr << "Error: file is not in binary CSR format." << std::endl;
+      return 1;
+    }
+    if (version > current_version || header_bytes != sizeof(*this)) {
+      std::cerr << "Error: binary CSR format version " << version
+                << " is not supported." << std::endl;
+      return 1;
+    }
+    if (header_checksum != compute_header_checksum()) {
+      std::cerr << "Error: binary CSR header is corrupt." << std::endl;
+      return 1;
+    }
+    if (integer_bytes != sizeof(integer_t)) {
+      std::cerr << "Error: matrix integer_t type does not match,"
+        " input matrix uses " << int(integer_bytes)
+                << " bytes per integer." << std::endl;
+      return 1;
+    }
+    if (scalar_type != scalar_type_char<scalar_t>()) {
+      std::cerr << "Error: scalar type of input matrix does not match,"
+        " input matrix is of type " << scalar_type << std::endl;
+      return 1;
+    }
+    if (bytes < file_bytes) {
+      std::cerr << "Error: binary CSR file is truncated, expected "
+                << file_bytes << " bytes, found " << bytes << std::endl;
+      return 1;
+    }
+    if (n > std::uint64_t(std::numeric_limits<integer_t>::max()) ||
+        nnz > std::uint64_t(std::numeric_limits<integer_t>::max())) {
+      std::cerr << "Error: binary CSR matrix is too large for integer_t,"
+                << " n = " << n << ", nnz = " << nnz << std::endl;
+      return 1;
+    }
+    // each array should be aligned, should lie within the file, and
+    // should not overlap the header or the previous array. The
+    // products are only formed after checking that they fit in bytes.
+    auto fits = [&](std::uint64_t off, std::uint64_t cnt, std::size_t s) {
+      return off % alignment == 0 && off <= bytes &&
+        cnt <= (bytes - off) / s;
+    };
+    if (!fits(ptr_offset, n+1, sizeof(integer_t)) ||
+        !fits(ind_offset, nnz, sizeof(integer_t)) ||
+        !fits(val_offset, nnz, sizeof(scalar_t)) ||
+        ptr_offset < sizeof(*this) ||
+        ind_offset < ptr_offset + (n+1)*sizeof(integer_t) ||
+        val_offset < ind_offset + nnz*sizeof(integer_t)) {
+      std::cerr << "Error: binary CSR header has invalid array offsets."
+                << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+
+  template<typename scalar_t,typename integer_t>
+  CSRMatrixMMap<scalar_t,integer_t>::CSRMatrixMMap
+  (const std::string& filename, bool verify_checksums) {
+#if defined(STRUMPACK_USE_MMAP)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("Could not open file " + filename);
+    struct stat sb;
+    if (::fstat(fd, &sb) != 0 ||
+        std::size_t(sb.st_size) < sizeof(BinaryCSRHeader)) {
+      ::close(fd);
+      throw std::runtime_error("Could not read header from " + filename);
+    }
+    map_bytes_ = sb.st_size;
+    map_ = ::mmap(nullptr, map_bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED) {
+      map_ = nullptr;
+      throw std::runtime_error("Could not mmap file " + filename);
+    }
+    const char* base = static_cast<const char*>(map_);
+    std::memcpy(&h_, base, sizeof(h_));
+#else
+    std::ifstream fs(filename, std::ifstream::binary | std::ifstream::ate);
+    if (!fs.good())
+      throw std::runtime_error("Could not open file " + filename);
+    std::size_t bytes = fs.tellg();
+    fs.seekg(0);
+    if (bytes < sizeof(BinaryCSRHeader))
+      throw std::runtime_error("Could not read header from " + filename);
+    buf_.resize(bytes);
+    fs.read(buf_.data(), bytes);
+    map_bytes_ = bytes;
+    const char* base = buf_.data();
+    std::memcpy(&h_, base, sizeof(h_));
+#endif
+    if (h_.check<scalar_t,integer_t>(map_bytes_)) {
+      unmap();
+      throw std::runtime_error
+        ("Invalid binary CSR file " + filename);
+    }
+    n_ = h_.n;
+    nnz_ = h_.nnz;
+    symm_ = h_.symm_sparse;
+    ptr_ = reinterpret_cast<const integer_t*>(base + h_.ptr_offset);
+    ind_ = reinterpret_cast<const integer_t*>(base + h_.ind_offset);
+    val_ = reinterpret_cast<const scalar_t*>(base + h_.val_offset);
+#if defined(STRUMPACK_USE_MMAP) && defined(MADV_WILLNEED)
+    ::madvise(map_, map_bytes_, MADV_WILLNEED);
+#endif
+    if (verify_checksums && !verify()) {
+      unmap();
+      throw std::runtime_error
+        ("Checksum mismatch in binary CSR file " + filename);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t>
+  CSRMatrixMMap<scalar_t,integer_t>::CSRMatrixMMap(CSRMatrixMMap&& m) {
+    *this = std::move(m);
+  }
+
+  template<typename scalar_t,typename integer_t>
+  CSRMatrixMMap<scalar_t,integer_t>&
+  CSRMatrixMMap<scalar_t,integer_t>::operator=(CSRMatrixMMap&& m) {
+    if (this != &m) {
+      unmap();
+      h_ = m.h_;
+      map_ = m.map_;  m.map_ = nullptr;
+      map_bytes_ = m.map_bytes_;  m.map_bytes_ = 0;
+      buf_ = std::move(m.buf_);
+      n_ = m.n_;  nnz_ = m.nnz_;  symm_ = m.symm_;
+      ptr_ = m.ptr_;  ind_ = m.ind_;  val_ = m.val_;
+      m.ptr_ = m.ind_ = nullptr;
+      m.val_ = nullptr;
+      m.n_ = m.nnz_ = 0;
+    }
+    return *this;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  CSRMatrixMMap<scalar_t,integer_t>::~CSRMatrixMMap() { unmap(); }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrixMMap<scalar_t,integer_t>::unmap() {
+#if defined(STRUMPACK_USE_MMAP)
+    if (map_) ::munmap(map_, map_bytes_);
+#endif
+    map_ = nullptr;
+    map_bytes_ = 0;
+    buf_.clear();
+    ptr_ = ind_ = nullptr;
+    val_ = nullptr;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  CSRMatrixMMap<scalar_t,integer_t>::verify() const {
+    return binary_csr_checksum(ptr_, (h_.n+1)*sizeof(integer_t))
+      == h_.ptr_checksum &&
+      binary_csr_checksum(ind_, h_.nnz*sizeof(integer_t))
+      == h_.ind_checksum &&
+      binary_csr_checksum(val_, h_.nnz*sizeof(scalar_t))
+      == h_.val_checksum;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrixMMap<scalar_t,integer_t>::spmv
+  (const scalar_t* x, scalar_t* y) const {
+#pragma omp parallel for
+    for (integer_t r=0; r<n_; r++) {
+      const auto hij = ptr_[r+1];
+      scalar_t yr(0);
+      for (integer_t j=ptr_[r]; j<hij; j++)
+        yr += val_[j] * x[ind_[j]];
+      y[r] = yr;
+    }
+    STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1 ) * (2ll * nnz_ - n_));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrixMMap<scalar_t,integer_t>::spmv
+  (const DenseM_t& x, DenseM_t& y) const {
+    for (std::size_t c=0; c<x.cols(); c++)
+      spmv(x.ptr(0,c), y.ptr(0,c));
+  }
+
+  template void BinaryCSRHeader::set<float,int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<double,int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<std::complex<float>,int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<std::complex<double>,int>
+  (std::uint64_t, std::uint64_t, bool);
+
+  template void BinaryCSRHeader::set<float,long int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<double,long int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<std::complex<float>,long int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<std::complex<double>,long int>
+  (std::uint64_t, std::uint64_t, bool);
+
+  template void BinaryCSRHeader::set<float,long long int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<double,long long int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<std::complex<float>,long long int>
+  (std::uint64_t, std::uint64_t, bool);
+  template void BinaryCSRHeader::set<std::complex<double>,long long int>
+  (std::uint64_t, std::uint64_t, bool);
+
+  template int BinaryCSRHeader::check<float,int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<double,int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<std::complex<float>,int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<std::complex<double>,int>(std::uint64_t) const;
+
+  template int BinaryCSRHeader::check<float,long int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<double,long int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<std::complex<float>,long int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<std::complex<double>,long int>(std::uint64_t) const;
+
+  template int BinaryCSRHeader::check<float,long long int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<double,long long int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<std::complex<float>,long long int>(std::uint64_t) const;
+  template int BinaryCSRHeader::check<std::complex<double>,long long int>(std::uint64_t) const;
+
+  template class CSRMatrixMMap<float,int>;
+  template class CSRMatrixMMap<double,int>;
+  template class CSRMatrixMMap<std::complex<float>,int>;
+  template class CSRMatrixMMap<std::complex<double>,int>;
+
+  template class CSRMatrixMMap<float,long int>;
+  template class CSRMatrixMMap<double,long int>;
+  template class CSRMatrixMMap<std::complex<float>,long int>;
+  template class CSRMatrixMMap<std::complex<double>,long int>;
+
+  template class CSRMatrixMMap<float,long long int>;
+  template class CSRMatrixMMap<double,long long int>;
+  template class CSRMatrixMMap<std::complex<float>,long long int>;
+  template class CSRMatrixMMap<std::complex<double>,long long int>;
+
+} // end namespace strumpack
@@ -0,0 +1,215 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file CSRMatrixMMap.hpp
+ * \brief Contains the versioned binary file format for compressed
+ * sparse row matrices, and a read-only memory-mapped view of such a
+ * file.
+ */
+#ifndef STRUMPACK_CSR_MATRIX_MMAP_HPP
+#define STRUMPACK_CSR_MATRIX_MMAP_HPP
+
+#include <string>
+#include <cstdint>
+#include <vector>
+
+#include "dense/DenseMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * \struct BinaryCSRHeader
+   * \brief Fixed size (128 byte) header of the binary CSR format.
+   *
+   * The file consists of this header, followed by the row pointers,
+   * the column indices and the nonzero values. Each of the three
+   * arrays starts at an offset which is a multiple of
+   * BinaryCSRHeader::alignment bytes, so that the file can be memory
+   * mapped and the arrays can be used in place. Each array is
+   * protected by a checksum, and the header itself by another.
+   *
+   * This is an internal format, it is not portable across machines
+   * with a different byte order.
+   */
+  struct BinaryCSRHeader {
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint64_t alignment = 64;
+
+    char magic[8] = {'S','T','R','U','M','C','S','R'};
+    std::uint32_t version = current_version;
+    std::uint32_t header_bytes = sizeof(BinaryCSRHeader);
+    std::uint8_t integer_bytes = 0; /*!< sizeof(integer_t)             */
+    char scalar_type = ' ';         /*!< one of 's', 'd', 'c' or 'z'    */
+    std::uint8_t symm_sparse = 0;   /*!< symmetric sparsity pattern?    */
+    std::uint8_t pad0[5] = {0,0,0,0,0};
+    std::uint64_t n = 0, nnz = 0;
+    std::uint64_t ptr_offset = 0, ind_offset = 0, val_offset = 0;
+    std::uint64_t ptr_checksum = 0, ind_checksum = 0, val_checksum = 0;
+    std::uint64_t file_bytes = 0;
+    std::uint8_t pad1[24] = {};
+    std::uint64_t header_checksum = 0;
+
+    /**
+     * Check whether this header starts with the binary CSR magic
+     * string.
+     */
+    bool valid_magic() const;
+
+    /**
+     * Fill in the type information, sizes and (aligned) offsets for
+     * a matrix of size n with nnz nonzeros.
+     */
+    template<typename scalar_t,typename integer_t>
+    void set(std::uint64_t n, std::uint64_t nnz, bool symm);
+
+    /**
+     * Check the type information against scalar_t and integer_t,
+     * the header checksum, the file size, that n and nnz fit in
+     * integer_t, and that the arrays are aligned and lie within the
+     * file. Prints a message to std::cerr and returns a nonzero
+     * value on failure.
+     */
+    template<typename scalar_t,typename integer_t>
+    int check(std::uint64_t file_bytes) const;
+
+    std::uint64_t compute_header_checksum() const;
+  };
+  static_assert(sizeof(BinaryCSRHeader) == 128,
+                "BinaryCSRHeader should be 128 bytes");
+
+  /**
+   * Simple 64 bit checksum (FNV-1a over 8 byte words, the tail is
+   * handled byte per byte) used in the binary CSR format.
+   */
+  std::uint64_t binary_csr_checksum(const void* data, std::size_t bytes);
+
+  /**
+   * Return the character code used in the binary file formats for
+   * the scalar type: 's', 'd', 'c' or 'z'.
+   */
+  template<typename scalar_t> char scalar_type_char() {
+    using real_t = typename RealType<scalar_t>::value_type;
+    if (is_complex<scalar_t>())
+      return std::is_same<real_t,float>() ? 'c' : 'z';
+    return std::is_same<real_t,float>() ? 's' : 'd';
+  }
+
+  /**
+   * \class CSRMatrixMMap
+   * \brief Read-only, zero-copy view of a compressed sparse row
+   * matrix stored in the binary CSR format.
+   *
+   * The file is mapped in memory (with mmap), and the row pointers,
+   * column indices and values are used directly from the mapped
+   * pages, without copying. The arrays can be passed to
+   * SparseSolver::set_csr_matrix, or used directly, for instance for
+   * computing residuals. Where memory mapping is not available, the
+   * file is read with a single bulk read per array.
+   *
+   * Files in this format can be written with
+   * CSRMatrix::print_binary.
+   *
+   * \tparam scalar_t
+   * \tparam integer_t
+   *
+   * \see CSRMatrix::print_binary, CSRMatrix::read_binary
+   */
+  template<typename scalar_t,typename integer_t> class CSRMatrixMMap {
+    using DenseM_t = DenseMatrix<scalar_t>;
+
+  public:
+    /**
+     * Default constructor, does not map anything.
+     */
+    CSRMatrixMMap() = default;
+
+    /**
+     * Map the binary CSR file filename. Throws an std::runtime_error
+     * if the file cannot be opened, is not in the binary CSR format,
+     * has the wrong scalar or integer type, or is truncated.
+     *
+     * \param filename name of file written by CSRMatrix::print_binary
+     * \param verify if true, also check the checksums of the three
+     * arrays. This touches all pages of the file.
+     */
+    CSRMatrixMMap(const std::string& filename, bool verify=true);
+
+    CSRMatrixMMap(const CSRMatrixMMap&) = delete;
+    CSRMatrixMMap& operator=(const CSRMatrixMMap&) = delete;
+    CSRMatrixMMap(CSRMatrixMMap&& m);
+    CSRMatrixMMap& operator=(CSRMatrixMMap&& m);
+    ~CSRMatrixMMap();
+
+    /** Number of rows (and columns). */
+    integer_t size() const { return n_; }
+    /** Number of nonzeros. */
+    integer_t nnz() const { return nnz_; }
+    /** Was the matrix written with a symmetric sparsity pattern. */
+    bool symm_sparse() const { return symm_; }
+
+    /** Row pointers, array of size()+1 elements. */
+    const integer_t* ptr() const { return ptr_; }
+    /** Column indices, array of nnz() elements. */
+    const integer_t* ind() const { return ind_; }
+    /** Nonzero values, array of nnz() elements. */
+    const scalar_t* val() const { return val_; }
+
+    /**
+     * Check the checksums of the row pointers, column indices and
+     * values. Returns true when all are correct.
+     */
+    bool verify() const;
+
+    /**
+     * Sparse matrix times vector product, y = this * x.
+     */
+    void spmv(const scalar_t* x, scalar_t* y) const;
+
+    /**
+     * Sparse matrix times dense matrix product, y = this * x.
+     */
+    void spmv(const DenseM_t& x, DenseM_t& y) const;
+
+  private:
+    BinaryCSRHeader h_;
+    void* map_ = nullptr;
+    std::size_t map_bytes_ = 0;
+    std::vector<char> buf_;
+    integer_t n_ = 0, nnz_ = 0;
+    bool symm_ = false;
+    const integer_t* ptr_ = nullptr;
+    const integer_t* ind_ = nullptr;
+    const scalar_t* val_ = nullptr;
+
+    void unmap();
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_CSR_MATRIX_MMAP_HPP
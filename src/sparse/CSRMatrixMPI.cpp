@@ -33,9 +33,13 @@
 #include <memory>
 #include <algorithm>
 #include <exception>
+#include <limits>
+#include <cstring>
 
 
 #include "CSRMatrixMPI.hpp"
+#include "CSRMatrixMMap.hpp"
+#include "AuctionMatchingMPI.hpp"
 #if defined(STRUMPACK_USE_COMBBLAS)
 #include "AWPMCombBLAS.hpp"
 #endif
@@ -754,6 +758,20 @@ namespace strumpack {
       return M;
     }
 
+    if (job == MatchingJob::AUCTION) {
+      Match_t M(job, this->size());
+      if (!auction_matching(*this, M)) {
+        if (apply) {
+          scale_real(M.R, M.C);
+          permute_columns(M.Q);
+        }
+        return M;
+      }
+      if (comm_.is_root())
+        std::cerr << "# WARNING auction matching did not converge,"
+                  << " using MC64 on the gathered matrix" << std::endl;
+    }
+
     auto Aseq = gather();
     Match_t M;
     int ierr = 0;
@@ -770,7 +788,7 @@ namespace strumpack {
     if (ierr) throw std::runtime_error(std::string("Matching failed"));
     comm_.broadcast(M.Q);
 
-    if (job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING) {
+    if (matching_has_scaling(job)) {
       auto P = comm_.size();
       auto rank = comm_.rank();
       std::unique_ptr<int[]> iwork(new int[2*P]);
@@ -1030,15 +1048,345 @@ namespace strumpack {
     spmv_bufs_ = SPMVBuffers<scalar_t,integer_t>();
   }
 
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrixMPI<scalar_t,integer_t>::set_balanced_dist
+  (const integer_t* lptr, integer_t r0, integer_t r1) {
+    // lptr are the (global) row pointers for rows [r0,r1], find the
+    // rows where to split such that every rank gets about the same
+    // number of nonzeros, same as in the constructor from a
+    // sequential CSRMatrix. Every split point is found by the one
+    // rank which has the corresponding nonzero.
+    auto P = comm_.size();
+    dist_.assign(P+1, integer_t(-1));
+    for (int p=1; p<P; p++) {
+      integer_t t = p * float(nnz_) / P;
+      if (r1 > r0 && t >= lptr[0] && t < lptr[r1-r0]) {
+        auto hi = r0 + std::distance
+          (lptr, std::upper_bound(lptr, lptr+(r1-r0), t));
+        dist_[p] = ((hi-1 >= r0) && (t-lptr[hi-1-r0] < lptr[hi-r0]-t)) ?
+          hi-1 : hi;
+      }
+    }
+    comm_.all_reduce(dist_.data(), P+1, MPI_MAX);
+    dist_[0] = 0;
+    dist_[P] = n_;
+    for (int p=1; p<P; p++)
+      dist_[p] = std::min(n_, std::max(dist_[p], dist_[p-1]));
+    brow_ = dist_[comm_.rank()];
+    lrows_ = dist_[comm_.rank()+1] - brow_;
+  }
+
+  namespace {
+    // Read bytes from fh at offset off. MPI counts are int, so large
+    // reads are split in chunks. This is collective, all ranks call
+    // MPI_File_read_at_all the same number of times.
+    inline int mpi_file_read_at_all
+    (MPI_File fh, MPI_Offset off, void* buf, std::size_t bytes,
+     const MPIComm& c) {
+      const std::size_t chunk = std::numeric_limits<int>::max();
+      std::size_t nchunks = c.all_reduce((bytes + chunk - 1) / chunk, MPI_MAX);
+      auto cbuf = static_cast<char*>(buf);
+      int err = MPI_SUCCESS;
+      for (std::size_t i=0; i<nchunks; i++) {
+        std::size_t b = std::min(chunk*i, bytes),
+          e = std::min(chunk*(i+1), bytes);
+        auto ierr = MPI_File_read_at_all
+          (fh, off + b, cbuf + b, int(e - b), MPI_BYTE, MPI_STATUS_IGNORE);
+        if (ierr != MPI_SUCCESS) err = ierr;
+      }
+      return c.all_reduce(int(err != MPI_SUCCESS), MPI_MAX);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  CSRMatrixMPI<scalar_t,integer_t>::read_binary
+  (const std::string& filename) {
+    MPI_File fh;
+    if (MPI_File_open(comm(), filename.c_str(), MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+      if (comm_.is_root())
+        std::cerr << "Error: could not open file " << filename << std::endl;
+      return 1;
+    }
+    BinaryCSRHeader h;
+    MPI_Offset fsize = 0;
+    MPI_File_get_size(fh, &fsize);
+    // format: 1 for the versioned format, 0 for the original
+    // unversioned format ('R' followed by the integer size), -1 if
+    // this is not a binary CSR file
+    int fmt = -1;
+    if (comm_.is_root()) {
+      char v0[2] = {0, 0};
+      if (std::size_t(fsize) >= sizeof(h) &&
+          MPI_File_read_at(fh, 0, &h, sizeof(h), MPI_BYTE,
+                           MPI_STATUS_IGNORE) == MPI_SUCCESS &&
+          h.valid_magic())
+        fmt = 1;
+      else if (fsize >= 2 &&
+               MPI_File_read_at(fh, 0, v0, 2, MPI_BYTE,
+                                MPI_STATUS_IGNORE) == MPI_SUCCESS &&
+               v0[0] == 'R' && (v0[1] == '4' || v0[1] == '8'))
+        fmt = 0;
+    }
+    comm_.broadcast(fmt);
+    if (fmt != 1) {
+      MPI_File_close(&fh);
+      // not a binary file, the caller can try another reader
+      if (fmt == -1) return 1;
+      // the old format has no offsets to read the row blocks in
+      // parallel, read it on the root and scatter
+      CSRMatrix<scalar_t,integer_t> A;
+      int err = comm_.is_root() ? A.read_binary(filename) : 0;
+      comm_.broadcast(err);
+      if (err) return 1;
+      *this = CSRMatrixMPI<scalar_t,integer_t>
+        (comm_.is_root() ? &A : nullptr, comm_, true);
+      return 0;
+    }
+    int err = comm_.is_root() ? h.check<scalar_t,integer_t>(fsize) : 0;
+    comm_.broadcast(err);
+    if (err) {
+      MPI_File_close(&fh);
+      return 1;
+    }
+    MPI_Bcast(&h, sizeof(h), MPI_BYTE, 0, comm());
+    n_ = h.n;
+    nnz_ = h.nnz;
+    symm_sparse_ = h.symm_sparse;
+    if (comm_.is_root())
+      std::cout << "# Reading matrix with n="
+                << number_format_with_commas(n_)
+                << ", nnz=" << number_format_with_commas(nnz_)
+                << " with MPI-IO" << std::endl;
+    auto rank = comm_.rank();
+    auto P = comm_.size();
+    // read the row pointers for an equal number of rows per rank,
+    // to determine a distribution with balanced nonzeros
+    {
+      integer_t r0 = double(n_) * rank / P, r1 = double(n_) * (rank+1) / P;
+      std::vector<integer_t> lptr(r1-r0+1);
+      err = mpi_file_read_at_all
+        (fh, h.ptr_offset + r0*sizeof(integer_t), lptr.data(),
+         lptr.size()*sizeof(integer_t), comm_);
+      if (!err) set_balanced_dist(lptr.data(), r0, r1);
+    }
+    if (!err) {
+      ptr_.resize(lrows_+1);
+      err = mpi_file_read_at_all
+        (fh, h.ptr_offset + brow_*sizeof(integer_t), ptr_.data(),
+         ptr_.size()*sizeof(integer_t), comm_);
+    }
+    if (!err) {
+      auto nz0 = ptr_[0];
+      lnnz_ = ptr_[lrows_] - nz0;
+      ind_.resize(lnnz_);
+      val_.resize(lnnz_);
+      err = mpi_file_read_at_all
+        (fh, h.ind_offset + nz0*sizeof(integer_t), ind_.data(),
+         ind_.size()*sizeof(integer_t), comm_);
+      if (!err)
+        err = mpi_file_read_at_all
+          (fh, h.val_offset + nz0*sizeof(scalar_t), val_.data(),
+           val_.size()*sizeof(scalar_t), comm_);
+    }
+    MPI_File_close(&fh);
+    if (err) {
+      if (comm_.is_root())
+        std::cerr << "Error: reading from " << filename
+                  << " failed." << std::endl;
+      return 1;
+    }
+    for (integer_t r=lrows_; r>=0; r--)
+      ptr_[r] -= ptr_[0];
+    split_diag_offdiag();
+    check();
+    return 0;
+  }
+
   template<typename scalar_t,typename integer_t> int
   CSRMatrixMPI<scalar_t,integer_t>::read_matrix_market
   (const std::string& filename) {
-    std::cout << "ERROR: reading a distributed matrix"
-              << " from file is not supported." << std::endl;
-    abort();
-    // TODO: first read the matrix as a sequential matrix
-    // then make a Distributed matrix from the sequential one
-    // Aydin has code for MPI-IO input of matrix-market file
+    using Trip_t = Triplet<scalar_t,integer_t>;
+    auto rank = comm_.rank();
+    auto P = comm_.size();
+    // The root parses the banner, comments and the size line, and
+    // broadcasts where the entries start.
+    // info: error, complex, symmetry, data offset, n, nnz
+    std::vector<long long int> info(6, 0);
+    if (comm_.is_root()) {
+      FILE *fp = fopen(filename.c_str(), "r");
+      const int max_cline = 256;
+      char cline[max_cline];
+      if (fp == NULL || fgets(cline, max_cline, fp) == NULL) {
+        std::cerr << "ERROR: could not read file " << filename << std::endl;
+        info[0] = 1;
+      } else {
+        std::cout << "# opening file \'" << filename
+                  << "\' with MPI-IO" << std::endl;
+        printf("# %s", cline);
+        if (strstr(cline, "pattern")) {
+          std::cerr << "ERROR: This is not a matrix,"
+                    << " but just a sparsity pattern" << std::endl;
+          info[0] = 1;
+        } else if (strstr(cline, "complex") && !is_complex<scalar_t>())
+          info[0] = 1;
+        info[1] = strstr(cline, "complex") != NULL;
+        info[2] = CSM_t::GENERAL;
+        if (strstr(cline, "skew-symmetric")) info[2] = CSM_t::SKEWSYMMETRIC;
+        else if (strstr(cline, "symmetric")) info[2] = CSM_t::SYMMETRIC;
+        else if (strstr(cline, "hermitian")) info[2] = CSM_t::HERMITIAN;
+        while (!info[0] && fgets(cline, max_cline, fp)) {
+          if (cline[0] != '%') { // first line should be: m n nnz
+            long long int m, in, innz;
+            sscanf(cline, "%lld %lld %lld", &m, &in, &innz);
+            std::cout << "# reading " << number_format_with_commas(m)
+                      << " by " << number_format_with_commas(in)
+                      << " matrix with " << number_format_with_commas(innz)
+                      << " nnz's from " << filename << std::endl;
+            if (m != in) {
+              std::cerr << "ERROR: matrix is not square!" << std::endl;
+              info[0] = 1;
+            }
+            info[3] = ftell(fp);
+            info[4] = in;
+            info[5] = innz;
+            break;
+          }
+        }
+      }
+      if (fp) fclose(fp);
+    }
+    comm_.broadcast(info);
+    if (info[0]) return 1;
+    auto s = static_cast<typename CSM_t::MMsym>(info[2]);
+    n_ = info[4];
+    symm_sparse_ = s != CSM_t::GENERAL;
+
+    // every rank reads an equal part of the data section, the lines
+    // which start in [b, e) are parsed by this rank
+    MPI_File fh;
+    if (MPI_File_open(comm(), filename.c_str(), MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+      return 1;
+    MPI_Offset fsize = 0;
+    MPI_File_get_size(fh, &fsize);
+    MPI_Offset d0 = info[3], b = d0 + (fsize - d0) * double(rank) / P,
+      e = d0 + (fsize - d0) * double(rank+1) / P;
+    // also read the byte before b, and a bit beyond e to complete
+    // the last line
+    const MPI_Offset max_line = 1024;
+    MPI_Offset rb = std::max(d0, b-1), re = std::min(fsize, e + max_line);
+    std::vector<char> buf(re - rb + 1);
+    if (mpi_file_read_at_all(fh, rb, buf.data(), re - rb, comm_)) {
+      MPI_File_close(&fh);
+      return 1;
+    }
+    MPI_File_close(&fh);
+    buf.back() = '\0';
+    std::vector<Trip_t> A;
+    A.reserve(2 * info[5] / P + 1);
+    int zero_based = 0;
+    {
+      const char* c = buf.data();
+      const char* cend = buf.data() + (re - rb);
+      const char* cown = buf.data() + (e - rb);
+      if (b > d0) { // skip partial line, unless b starts a new line
+        c++;
+        if (*(c-1) != '\n')
+          while (c < cend && *(c-1) != '\n') c++;
+      }
+      while (c < cown) {
+        char* next;
+        if (*c == '%' || *c == '\n' || *c == '\r') {
+          while (c < cend && *c != '\n') c++;
+          c++;
+          continue;
+        }
+        integer_t r = strtoll(c, &next, 10);
+        if (next == c) break;
+        c = next;
+        integer_t col = strtoll(c, &next, 10);
+        c = next;
+        double vr = strtod(c, &next), vi = 0.;
+        c = next;
+        if (info[1]) {
+          vi = strtod(c, &next);
+          c = next;
+        }
+        while (c < cend && *c != '\n') c++;
+        c++;
+        if (r==0 || col==0) zero_based = 1;
+        scalar_t v = get_scalar<scalar_t>(vr, vi);
+        A.emplace_back(r, col, v);
+        if (r != col) {
+          switch (s) {
+          case CSM_t::SKEWSYMMETRIC: A.emplace_back(col, r, -v); break;
+          case CSM_t::SYMMETRIC: A.emplace_back(col, r, v); break;
+          case CSM_t::HERMITIAN:
+            A.emplace_back(col, r, blas::my_conj(v)); break;
+          default: break;
+          }
+        }
+      }
+    }
+    std::vector<char>().swap(buf);
+    zero_based = comm_.all_reduce(zero_based, MPI_MAX);
+    if (!zero_based)
+      for (auto& t : A) { t.r--; t.c--; }
+    nnz_ = comm_.all_reduce(integer_t(A.size()), MPI_SUM);
+
+    auto sort_entries = [](std::vector<Trip_t>& T) {
+      std::sort(T.begin(), T.end(), [](const Trip_t& a, const Trip_t& b) {
+          return (a.r < b.r) || (a.r == b.r && a.c < b.c); });
+    };
+    // send all entries to the ranks with the rows in dist, assuming
+    // the entries are sorted by row
+    auto redistribute = [&](std::vector<Trip_t>& T,
+                            const std::vector<integer_t>& dist) {
+      std::vector<std::vector<Trip_t>> sbuf(P);
+      for (int p=0, i=0; p<P; p++) {
+        auto i0 = i;
+        while (i < int(T.size()) && T[i].r < dist[p+1]) i++;
+        sbuf[p].assign(T.begin()+i0, T.begin()+i);
+      }
+      std::vector<Trip_t>().swap(T);
+      T = comm_.all_to_all_v(sbuf);
+      sort_entries(T);
+    };
+    // first send to ranks with an equal number of rows, then count
+    // the nonzeros per row to define the nonzero balanced
+    // distribution, and then send to the final owner
+    std::vector<integer_t> rdist(P+1);
+    for (int p=0; p<=P; p++)
+      rdist[p] = double(n_) * p / P;
+    sort_entries(A);
+    redistribute(A, rdist);
+    {
+      integer_t r0 = rdist[rank], r1 = rdist[rank+1];
+      std::vector<integer_t> lptr(r1-r0+1, 0);
+      for (auto& t : A) lptr[t.r-r0+1]++;
+      integer_t nz0 = A.size();
+      MPI_Exscan(&nz0, lptr.data(), 1, mpi_type<integer_t>(),
+                 MPI_SUM, comm());
+      if (rank == 0) lptr[0] = 0;
+      for (integer_t r=0; r<r1-r0; r++)
+        lptr[r+1] += lptr[r];
+      set_balanced_dist(lptr.data(), r0, r1);
+    }
+    redistribute(A, dist_);
+    lnnz_ = A.size();
+    ptr_.assign(lrows_+1, 0);
+    ind_.resize(lnnz_);
+    val_.resize(lnnz_);
+    for (integer_t i=0; i<lnnz_; i++) {
+      ptr_[A[i].r-brow_+1]++;
+      ind_[i] = A[i].c;
+      val_[i] = A[i].v;
+    }
+    for (integer_t r=0; r<lrows_; r++)
+      ptr_[r+1] += ptr_[r];
+    split_diag_offdiag();
+    check();
     return 0;
   }
 
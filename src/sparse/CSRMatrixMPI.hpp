@@ -120,7 +120,11 @@ namespace strumpack {
     /**
      * This gathers the matrix to 1 process, then applies MC64
      * sequentially. lDr and gDc are only set when job ==
-     * MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING.
+     * MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING or
+     * MatchingJob::AUCTION. With MatchingJob::AUCTION the matching is
+     * computed with a distributed auction algorithm, without
+     * gathering the matrix, see auction_matching. If the auction
+     * fails, this falls back to MC64 on the gathered matrix.
      *
      * \param job The job type.
      * \param perm Output, column permutation vector containing the
@@ -141,8 +145,37 @@ namespace strumpack {
 
     void symmetrize_sparsity() override;
 
+    /**
+     * Read a matrix in matrix market format, in parallel, using
+     * MPI-IO. Every rank parses an equal part of the file, the
+     * entries are then sent to the ranks which own the
+     * corresponding rows. The matrix is not gathered on a single
+     * process. The rows are distributed such that each rank has
+     * approximately the same number of nonzeros. This is collective
+     * on Comm().
+     *
+     * \return 0 on success, nonzero on failure (on all ranks)
+     */
     int read_matrix_market(const std::string& filename) override;
 
+    /**
+     * Read a matrix written with CSRMatrix::print_binary, in
+     * parallel, using MPI-IO. Every rank reads only its own block of
+     * rows directly from the file. The rows are distributed such
+     * that each rank has approximately the same number of
+     * nonzeros. The array checksums are not verified, see
+     * CSRMatrix::read_binary or CSRMatrixMMap for that. Files in the
+     * original unversioned binary format are read on the root and
+     * scattered. This is collective on Comm().
+     *
+     * \return 0 on success, nonzero on failure (on all ranks). If
+     * the file is not in a binary CSR format at all, nonzero is
+     * returned without printing an error, so the caller can try
+     * another reader, for instance read_matrix_market.
+     * \see CSRMatrix::print_binary, BinaryCSRHeader
+     */
+    int read_binary(const std::string& filename);
+
     real_t max_scaled_residual(const DenseM_t& x, const DenseM_t& b)
       const override;
 
@@ -238,6 +271,7 @@ namespace strumpack {
   protected:
     void split_diag_offdiag();
     void setup_spmv_buffers() const;
+    void set_balanced_dist(const integer_t* lptr, integer_t r0, integer_t r1);
 
     // TODO use MPIComm
     MPIComm comm_;
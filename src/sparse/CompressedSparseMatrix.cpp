@@ -106,7 +106,11 @@ namespace strumpack {
                 << std::endl;
       return M;
     }
-    int info = strumpack_mc64(job, M);
+    // the auction is only used in parallel, sequentially the
+    // equivalent mc64 job is used
+    int info = strumpack_mc64
+      (job == MatchingJob::AUCTION ?
+       MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING : job, M);
     switch (info) {
     case 0: break;
     case 1: throw std::runtime_error
@@ -127,12 +131,27 @@ namespace strumpack {
   CompressedSparseMatrix<scalar_t,integer_t>::apply_matching
   (const Match_t& M) {
     if (M.job == MatchingJob::NONE) return;
-    if (M.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+    if (matching_has_scaling(M.job))
       scale_real(M.R, M.C);
     permute_columns(M.Q);
     symm_sparse_ = false;
   }
 
+  template<typename scalar_t,typename integer_t> std::uint64_t
+  CompressedSparseMatrix<scalar_t,integer_t>::pattern_hash() const {
+    std::uint64_t h = 14695981039346656037ull;
+    auto add = [&h](std::uint64_t v) {
+      for (int b=0; b<8; b++) {
+        h ^= (v >> (8*b)) & 0xff;
+        h *= 1099511628211ull;
+      }
+    };
+    add(n_);
+    for (auto p : ptr_) add(p);
+    for (auto i : ind_) add(i);
+    return h;
+  }
+
   template<typename scalar_t,typename integer_t> void
   CompressedSparseMatrix<scalar_t,integer_t>::symmetrize_sparsity() {
     if (symm_sparse_) return;
@@ -191,16 +210,6 @@ namespace strumpack {
     symm_sparse_ = true;
   }
 
-  template<typename scalar_t> scalar_t get_scalar(double vr, double vi) {
-    return scalar_t(vr);
-  }
-  template<> inline std::complex<double> get_scalar(double vr, double vi) {
-    return std::complex<double>(vr, vi);
-  }
-  template<> inline std::complex<float> get_scalar(double vr, double vi) {
-    return std::complex<float>(vr, vi);
-  }
-
   template<typename scalar_t,typename integer_t>
   std::vector<std::tuple<integer_t,integer_t,scalar_t>>
   CompressedSparseMatrix<scalar_t,integer_t>::read_matrix_market_entries
@@ -51,6 +51,16 @@ namespace strumpack {
   template<typename scalar_t> class DistributedMatrix;
 
 
+  template<typename scalar_t> scalar_t get_scalar(double vr, double vi) {
+    return scalar_t(vr);
+  }
+  template<> inline std::complex<double> get_scalar(double vr, double vi) {
+    return std::complex<double>(vr, vi);
+  }
+  template<> inline std::complex<float> get_scalar(double vr, double vi) {
+    return std::complex<float>(vr, vi);
+  }
+
   template<typename scalar_t, typename integer_t,
            typename real_t = typename RealType<scalar_t>::value_type>
   class MatchingData {
@@ -59,7 +69,7 @@ namespace strumpack {
     MatchingData(MatchingJob j, std::size_t n) : job(j) {
       if (job != MatchingJob::NONE)
         Q.resize(n);
-      if (job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING) {
+      if (matching_has_scaling(job)) {
         R.resize(n);
         C.resize(n);
       }
@@ -346,6 +356,13 @@ namespace strumpack {
 
     virtual void symmetrize_sparsity();
 
+    /**
+     * Hash (64 bit FNV-1a) of the size and sparsity pattern, not of
+     * the values. Used to check that a stored analysis corresponds to
+     * this matrix, see SparseSolver::load_analysis.
+     */
+    std::uint64_t pattern_hash() const;
+
     virtual void print() const;
     virtual void print_dense(const std::string& name) const {
       std::cerr << "print_dense not implemented for this matrix type"
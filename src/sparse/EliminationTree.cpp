@@ -28,10 +28,12 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 
 #include "EliminationTree.hpp"
 #include "fronts/FrontFactory.hpp"
 #include "fronts/Front.hpp"
+#include "fronts/FrontDense.hpp"
 #include "SeparatorTree.hpp"
 
 namespace strumpack {
@@ -39,17 +41,98 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t>
   EliminationTree<scalar_t,integer_t>::EliminationTree
   (const SPOptions<scalar_t>& opts, const SpMat_t& A,
-   SeparatorTree<integer_t>& sep_tree) {
+   SeparatorTree<integer_t>& sep_tree, bool schur_root) {
     std::vector<std::vector<integer_t>> upd(sep_tree.separators());
 #pragma omp parallel default(shared)
 #pragma omp single
     symbolic_factorization(A, sep_tree, sep_tree.root(), upd);
-    root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), 0);
+    if (schur_root && sep_tree.separators()) {
+      auto root = sep_tree.root();
+      schur_root_ = new FrontDense<scalar_t,integer_t>
+        (root, sep_tree.sizes[root], sep_tree.sizes[root+1], upd[root]);
+      root_.reset(schur_root_);
+      nr_fronts_.dense++;
+      if (sep_tree.lch[root] != -1) {
+        root_->set_lchild
+          (setup_tree(opts, A, sep_tree, upd, sep_tree.lch[root], 1));
+        root_->set_rchild
+          (setup_tree(opts, A, sep_tree, upd, sep_tree.rch[root], 1));
+      }
+    } else
+      root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), 0);
+    if (root_) {
+#pragma omp parallel default(shared)
+#pragma omp single
+      root_->setup_parent_maps();
+    }
+  }
+
+  template<typename scalar_t,typename integer_t>
+  EliminationTree<scalar_t,integer_t>::EliminationTree
+  (const SPOptions<scalar_t>& opts, const SpMat_t& A,
+   SeparatorTree<integer_t>& sep_tree, std::istream& is) {
+    if (!sep_tree.separators()) return;
+    root_ = read_tree(opts, sep_tree, is, sep_tree.root(), 0);
+#pragma omp parallel default(shared)
+#pragma omp single
+    root_->setup_parent_maps();
+    // the CB clustering is not stored, it follows from the separator
+    // cluster trees, see MatrixReordering::separator_reordering
+    if (opts.compression() != CompressionType::NONE &&
+        opts.CB_clustering()) {
+#pragma omp parallel
+#pragma omp single
+      root_->cluster_CB(opts);
+    }
   }
 
   template<typename scalar_t,typename integer_t>
   EliminationTree<scalar_t,integer_t>::~EliminationTree() {}
 
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::write_analysis
+  (std::ostream& os) const {
+    if (root_) root_->write_analysis(os);
+  }
+
+  template<typename scalar_t,typename integer_t>
+  std::unique_ptr<Front<scalar_t,integer_t>>
+  EliminationTree<scalar_t,integer_t>::read_tree
+  (const SPOptions<scalar_t>& opts, SeparatorTree<integer_t>& sep_tree,
+   std::istream& is, integer_t sep, int level) {
+    integer_t s;
+    std::vector<integer_t> upd;
+    std::string type;
+    read_binary(is, s);
+    read_binary(is, upd);
+    read_binary(is, type);
+    if (s != sep)
+      throw std::runtime_error("stored tree does not match separator tree");
+    auto sep_begin = sep_tree.sizes[sep];
+    auto sep_end = sep_tree.sizes[sep+1];
+    // see setup_tree
+    if (sep_end == sep_begin && sep_tree.lch[sep] != -1)
+      sep_begin = sep_end = sep_tree.sizes[sep_tree.rch[sep]+1];
+    for (std::size_t i=0; i<upd.size(); i++)
+      if (upd[i] < sep_end || upd[i] >= sep_tree.sizes[sep_tree.separators()]
+          || (i && upd[i] <= upd[i-1]))
+        throw std::runtime_error("invalid update indices");
+    auto front = create_frontal_matrix<scalar_t,integer_t>
+      (opts, sep, sep_begin, sep_end, upd, level, nr_fronts_);
+    if (front->type() != type)
+      throw std::runtime_error
+        ("front type " + front->type() + " does not match stored type "
+         + type + ", the options differ from the stored analysis");
+    front->read_partition(opts, is, level == 0);
+    if (sep_tree.lch[sep] != -1)
+      front->set_lchild
+        (read_tree(opts, sep_tree, is, sep_tree.lch[sep], level+1));
+    if (sep_tree.rch[sep] != -1)
+      front->set_rchild
+        (read_tree(opts, sep_tree, is, sep_tree.rch[sep], level+1));
+    return front;
+  }
+
   template<typename scalar_t,typename integer_t>
   Front<scalar_t,integer_t>*
   EliminationTree<scalar_t,integer_t>::root() const {
@@ -151,9 +234,28 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> ReturnCode
   EliminationTree<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const SPOptions<scalar_t>& opts) {
+    if (schur_root_) {
+      root_factored_ = false;
+      return schur_root_->partial_factorization(A, opts);
+    }
     return root_->multifrontal_factorization(A, opts);
   }
 
+  template<typename scalar_t,typename integer_t>
+  const DenseMatrix<scalar_t>*
+  EliminationTree<scalar_t,integer_t>::schur_complement() const {
+    if (!schur_root_ || root_factored_) return nullptr;
+    return &schur_root_->F11();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  EliminationTree<scalar_t,integer_t>::factor_root
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts) {
+    if (root_factored_) return ReturnCode::SUCCESS;
+    root_factored_ = true;
+    return schur_root_->factor_node(A, opts);
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::delete_factors() {
     root_->delete_factors();
@@ -165,6 +267,13 @@ namespace strumpack {
     root_->multifrontal_solve(x);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::multifrontal_solve_sparse
+  (DenseM_t& x, const std::vector<bool>& brow,
+   const std::vector<bool>& xrow) const {
+    root_->multifrontal_solve_sparse(x, brow, xrow);
+  }
+
   template<typename scalar_t,typename integer_t> integer_t
   EliminationTree<scalar_t,integer_t>::maximum_rank() const {
     integer_t max_rank;
@@ -210,6 +319,18 @@ namespace strumpack {
     return root_->pivot_growth(pgL, pgU);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  EliminationTree<scalar_t,integer_t>::selected_inverse
+  (const std::vector<integer_t>& r, const std::vector<integer_t>& c,
+   const std::vector<std::size_t>& ord, scalar_t* v) const {
+    ReturnCode e;
+    DenseM_t Zuu;
+#pragma omp parallel default(shared)
+#pragma omp single nowait
+    e = root_->selected_inverse(Zuu, r, c, ord, v);
+    return e;
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::draw
   (const SpMat_t& A, const std::string& name) const {
@@ -40,6 +40,7 @@
 namespace strumpack {
 
   template<typename scalar_t,typename integer_t> class Front;
+  template<typename scalar_t,typename integer_t> class FrontDense;
   template<typename integer_t> class SeparatorTree;
 
   // TODO rename this to SuperNodalTree?
@@ -52,18 +53,50 @@ namespace strumpack {
   public:
     EliminationTree() {}
 
+    /**
+     * With schur_root, the root is always a dense front, which is
+     * only assembled in multifrontal_factorization, so its F11 is
+     * the Schur complement of the root separator, see
+     * schur_complement. It is factored later, in factor_root.
+     */
     EliminationTree(const SPOptions<scalar_t>& opts,
                     const SpMat_t& A,
-                    SeparatorTree<integer_t>& sep_tree);
+                    SeparatorTree<integer_t>& sep_tree,
+                    bool schur_root=false);
+
+    /**
+     * Construct the tree from a stored analysis, as written by
+     * write_analysis, skipping the symbolic factorization and the
+     * separator partitioning. Throws std::runtime_error if the
+     * stored data does not match sep_tree, or if the front types
+     * (which follow from the options) are different.
+     */
+    EliminationTree(const SPOptions<scalar_t>& opts,
+                    const SpMat_t& A,
+                    SeparatorTree<integer_t>& sep_tree,
+                    std::istream& is);
     virtual ~EliminationTree();
 
+    void write_analysis(std::ostream& os) const;
+
     virtual ReturnCode
     multifrontal_factorization(const SpMat_t& A,
                                const SPOptions<scalar_t>& opts);
 
     virtual void delete_factors();
 
+    /**
+     * The Schur complement on the root separator, or nullptr if the
+     * tree was not constructed with schur_root, or if the root was
+     * already factored.
+     */
+    const DenseM_t* schur_complement() const;
+    ReturnCode factor_root(const SpMat_t& A, const SPOptions<scalar_t>& opts);
+
     virtual void multifrontal_solve(DenseM_t& x) const;
+    void multifrontal_solve_sparse(DenseM_t& x,
+                                   const std::vector<bool>& brow,
+                                   const std::vector<bool>& xrow) const;
 
     virtual void
     multifrontal_solve_dist(DenseM_t& x,
@@ -81,6 +114,11 @@ namespace strumpack {
     virtual ReturnCode pivot_growth(scalar_t& pgL,
                                     scalar_t& pgU) const;
 
+    ReturnCode selected_inverse(const std::vector<integer_t>& r,
+                                const std::vector<integer_t>& c,
+                                const std::vector<std::size_t>& ord,
+                                scalar_t* v) const;
+
     void print_rank_statistics(std::ostream &out) const;
 
     virtual FrontCounter front_counter() const { return nr_fronts_; }
@@ -92,6 +130,8 @@ namespace strumpack {
   protected:
     FrontCounter nr_fronts_;
     std::unique_ptr<F_t> root_;
+    FrontDense<scalar_t,integer_t>* schur_root_ = nullptr;
+    bool root_factored_ = true;
 
   private:
     std::unique_ptr<F_t>
@@ -100,6 +140,11 @@ namespace strumpack {
                std::vector<std::vector<integer_t>>& upd,
                integer_t sep, int level);
 
+    std::unique_ptr<F_t>
+    read_tree(const SPOptions<scalar_t>& opts,
+              SeparatorTree<integer_t>& sep_tree, std::istream& is,
+              integer_t sep, int level);
+
     void
     symbolic_factorization(const SpMat_t& A,
                            const SeparatorTree<integer_t>& sep_tree,
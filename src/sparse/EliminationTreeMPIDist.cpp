@@ -240,128 +240,125 @@ namespace strumpack {
     return this->root_->multifrontal_factorization(Aprop_, opts);
   }
 
+  template<typename scalar_t,typename integer_t>
+  struct EliminationTreeMPIDist<scalar_t,integer_t>::SolvePlan {
+    integer_t n = 0;
+    std::vector<integer_t> dist;
+    RedistPlan plan;
+    // send slot for x(r,c), stored at r+c*m
+    std::vector<std::size_t> spos;
+    // for each receive slot, -1 for the local subtree, else the
+    // index in local_pfronts_, and the offset in the corresponding
+    // local storage
+    std::vector<int> rfront;
+    std::vector<std::size_t> roff;
+  };
+
+  template<typename scalar_t,typename integer_t>
+  EliminationTreeMPIDist<scalar_t,integer_t>::~EliminationTreeMPIDist() = default;
+
   template<typename scalar_t,typename integer_t> void
-  EliminationTreeMPIDist<scalar_t,integer_t>::multifrontal_solve_dist
-  (DenseM_t& x, const std::vector<integer_t>& dist) {
+  EliminationTreeMPIDist<scalar_t,integer_t>::build_solve_plan
+  (integer_t n, const std::vector<integer_t>& dist) {
     integer_t B = DistM_t::default_MB;
     integer_t lo = dist[rank_];
-    integer_t m = dist[rank_+1] - lo, n = x.cols();
-
-    std::unique_ptr<int[]> iwork(new int[4*P_]);
-    auto ibuf = iwork.get();
-    auto scnts = ibuf;
-    auto rcnts = ibuf + P_;
-    auto sdispls = ibuf + 2*P_;
-    auto rdispls = ibuf + 3*P_;
-
-    using Triplet = Triplet<scalar_t,integer_t>;
-    std::vector<Triplet> sbuf(m*n);
-    std::fill(scnts, scnts+P_, 0);
-    if (n == 1)
-      for (integer_t r=0; r<m; r++)
-        scnts[row_owner_[r]]++;
-    else {
-      for (integer_t r=0; r<m; r++) {
-        int pf = row_pfront_[nd_.perm()[r+lo]];
-        if (pf < 0) scnts[row_owner_[r]] += n;
-        else {
-          auto& f = all_pfronts_[pf];
-          for (integer_t c=0; c<n; c++)
-            scnts[row_owner_[r]+((c/B)%f.pcols)*f.prows]++;
-        }
-      }
-    }
-    std::vector<std::size_t> pp(P_);
-    sdispls[0] = 0;
-    pp[0] = 0;
-    for (int p=1; p<P_; p++)
-      pp[p] = sdispls[p] = sdispls[p-1] + scnts[p-1];
-    if (n == 1) {
-      const auto perm = nd_.perm().data() + lo;
-      for (integer_t r=0; r<m; r++)
-        sbuf[pp[row_owner_[r]]++] = {perm[r], 0, x(r,0)};
-    } else {
+    integer_t m = dist[rank_+1] - lo;
+    std::unique_ptr<SolvePlan> sp(new SolvePlan());
+    sp->n = n;
+    sp->dist = dist;
+    auto dest = [&](integer_t r, integer_t c) {
+      int pf = row_pfront_[nd_.perm()[r+lo]];
+      if (pf < 0) return row_owner_[r];
+      auto& f = all_pfronts_[pf];
+      return row_owner_[r] + int((c/B)%f.pcols)*f.prows;
+    };
+    std::vector<int> scnts(P_);
+    for (integer_t r=0; r<m; r++)
+      for (integer_t c=0; c<n; c++)
+        scnts[dest(r, c)]++;
+    sp->plan = RedistPlan(std::move(scnts), comm_);
+    auto pp = sp->plan.sdispls();
+    sp->spos.resize(std::size_t(m)*n);
+    std::vector<integer_t> sidx(2*std::size_t(m)*n),
+      ridx(2*sp->plan.recv_size());
+    for (integer_t c=0; c<n; c++)
       for (integer_t r=0; r<m; r++) {
-        auto destr = row_owner_[r];
-        auto permr = nd_.perm()[r+lo];
-        int pf = row_pfront_[permr];
-        if (pf < 0)
-          for (integer_t c=0; c<n; c++)
-            sbuf[pp[destr]++] = {permr, c, x(r,c)};
-        else {
-          auto& f = all_pfronts_[pf];
-          for (integer_t c=0; c<n; c++)
-            sbuf[pp[destr+((c/B)%f.pcols)*f.prows]++] =
-              {permr, c, x(r,c)};
-        }
+        auto k = sp->spos[r+c*m] = pp[dest(r, c)]++;
+        sidx[2*k] = nd_.perm()[r+lo];
+        sidx[2*k+1] = c;
       }
-    }
-    comm_.all_to_all(scnts, 1, rcnts);
-    rdispls[0] = 0;
-    for (int p=1; p<P_; p++)
-      rdispls[p] = rdispls[p-1] + rcnts[p-1];
-
-    auto rbuf = comm_.all_to_allv
-      (sbuf.data(), scnts, sdispls, rcnts, rdispls);
-
-    DenseM_t xloc(local_range_.second - local_range_.first, n);
-    DenseMW_t Xloc
-      (Aprop_.size(), n, xloc.data()-local_range_.first, xloc.ld());
+    sp->plan.exchange(sidx.data(), ridx.data(), comm_, 2);
+    // only used to get the local layout of the separators
     std::vector<DistM_t> xdist(local_pfronts_.size());
-
     for (std::size_t f=0; f<local_pfronts_.size(); f++)
       xdist[f] = DistM_t
         (local_pfronts_[f].grid, local_pfronts_[f].dim_sep(), n);
-    auto rsize = rbuf.size();
+    std::size_t ldloc =
+      std::max(integer_t(1), local_range_.second - local_range_.first);
+    auto rsize = sp->plan.recv_size();
+    sp->rfront.resize(rsize);
+    sp->roff.resize(rsize);
 #pragma omp parallel for
     for (std::size_t i=0; i<rsize; i++) {
-      integer_t r = rbuf[i].r, c = rbuf[i].c;
-      if (r >= local_range_.first && r < local_range_.second)
-        Xloc(r, c) = rbuf[i].v;
-      else {
+      integer_t r = ridx[2*i], c = ridx[2*i+1];
+      if (r >= local_range_.first && r < local_range_.second) {
+        sp->rfront[i] = -1;
+        sp->roff[i] = (r - local_range_.first) + c*ldloc;
+      } else {
         for (std::size_t f=0; f<local_pfronts_.size(); f++)
           if (r >= local_pfronts_[f].sep_begin &&
               r < local_pfronts_[f].sep_end) {
-            xdist[f].global(r - local_pfronts_[f].sep_begin, c) = rbuf[i].v;
+            auto& X = xdist[f];
+            sp->rfront[i] = f;
+            sp->roff[i] = X.rowg2l(r - local_pfronts_[f].sep_begin) +
+              std::size_t(X.colg2l(c))*X.ld();
             break;
           }
       }
     }
+    solve_plan_ = std::move(sp);
+  }
 
-    this->root_->multifrontal_solve(Xloc, xdist.data());
+  template<typename scalar_t,typename integer_t> void
+  EliminationTreeMPIDist<scalar_t,integer_t>::multifrontal_solve_dist
+  (DenseM_t& x, const std::vector<integer_t>& dist) {
+    integer_t lo = dist[rank_];
+    integer_t m = dist[rank_+1] - lo, n = x.cols();
+    if (!solve_plan_ || solve_plan_->n != n || solve_plan_->dist != dist)
+      build_solve_plan(n, dist);
+    const auto& sp = *solve_plan_;
 
-    rcnts = ibuf;
-    scnts = ibuf + P_;
-    rdispls = ibuf + 2*P_;
-    sdispls = ibuf + 3*P_;
-    for (int p=0; p<P_; p++)
-      pp[p] = sdispls[p];
-    for (integer_t r=local_range_.first; r<local_range_.second; r++) {
-      auto dest = std::upper_bound
-        (dist.begin(), dist.end(), nd_.iperm()[r])-dist.begin()-1;
-      auto permgr = nd_.iperm()[r];
-      for (integer_t c=0; c<n; c++)
-        rbuf[pp[dest]++] = {permgr, c, Xloc(r,c)};
-    }
-    for (std::size_t i=0; i<local_pfronts_.size(); i++) {
-      if (xdist[i].lcols() == 0) continue;
-      auto slo = local_pfronts_[i].sep_begin;
-      for (int r=0; r<xdist[i].lrows(); r++) {
-        auto permgr = nd_.iperm()[xdist[i].rowl2g(r) + slo];
-        auto dest = std::upper_bound
-          (dist.begin(), dist.end(), permgr)-dist.begin()-1;
-        for (int c=0; c<xdist[i].lcols(); c++)
-          rbuf[pp[dest]++] = {permgr, xdist[i].coll2g(c), xdist[i](r,c)};
-      }
-    }
-    comm_.all_to_allv
-      (rbuf.data(), scnts, sdispls, sbuf.data(), rcnts, rdispls);
+    std::vector<scalar_t> sbuf(std::size_t(m)*n),
+      rbuf(sp.plan.recv_size());
+    for (integer_t c=0; c<n; c++)
+      for (integer_t r=0; r<m; r++)
+        sbuf[sp.spos[r+c*m]] = x(r,c);
+    sp.plan.exchange(sbuf.data(), rbuf.data(), comm_);
 
+    DenseM_t xloc(local_range_.second - local_range_.first, n);
+    DenseMW_t Xloc
+      (Aprop_.size(), n, xloc.data()-local_range_.first, xloc.ld());
+    std::vector<DistM_t> xdist(local_pfronts_.size());
+    for (std::size_t f=0; f<local_pfronts_.size(); f++)
+      xdist[f] = DistM_t
+        (local_pfronts_[f].grid, local_pfronts_[f].dim_sep(), n);
+    auto xptr = [&](int f) {
+      return f < 0 ? xloc.data() : xdist[f].data();
+    };
+    auto rsize = rbuf.size();
 #pragma omp parallel for
-    for (std::size_t i=0; i<std::size_t(m)*n; i++)
-      x(sbuf[i].r-lo,sbuf[i].c) = sbuf[i].v;
+    for (std::size_t i=0; i<rsize; i++)
+      xptr(sp.rfront[i])[sp.roff[i]] = rbuf[i];
 
-    Triplet::free_mpi_type();
+    this->root_->multifrontal_solve(Xloc, xdist.data());
+
+#pragma omp parallel for
+    for (std::size_t i=0; i<rsize; i++)
+      rbuf[i] = xptr(sp.rfront[i])[sp.roff[i]];
+    sp.plan.exchange_back(rbuf.data(), sbuf.data(), comm_);
+    for (integer_t c=0; c<n; c++)
+      for (integer_t r=0; r<m; r++)
+        x(r,c) = sbuf[sp.spos[r+c*m]];
   }
 
   template<typename integer_t, typename It>
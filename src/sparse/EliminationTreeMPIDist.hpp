@@ -60,6 +60,8 @@ namespace strumpack {
     EliminationTreeMPIDist(const Opts_t& opts, const CSRMPI_t& A,
                            Reord_t& nd, const MPIComm& comm);
 
+    ~EliminationTreeMPIDist();
+
     void update_values(const Opts_t& opts, const CSRMPI_t& A,
                        Reord_t& nd);
 
@@ -104,6 +106,17 @@ namespace strumpack {
     std::vector<int> row_pfront_;
     void find_row_front(const CSRMPI_t& A);
 
+    /**
+     * Communication pattern to move the right-hand side from the
+     * user's row distribution to the proportional mapping
+     * distribution and back. This is computed on the first solve and
+     * reused as long as the distribution and the number of columns
+     * remain the same.
+     */
+    struct SolvePlan;
+    std::unique_ptr<SolvePlan> solve_plan_;
+    void build_solve_plan(integer_t n, const std::vector<integer_t>& dist);
+
     struct ParallelFront {
       ParallelFront() {}
       ParallelFront
@@ -127,6 +127,177 @@ namespace strumpack {
     }
   }
 
+  /**
+   * Communication plan to move the entries of a distributed vector
+   * from one distribution to another. The send/receive counts,
+   * displacements and the list of neighboring processes are computed
+   * once, after which only the values need to be exchanged, with
+   * point-to-point messages to the processes that actually send or
+   * receive data. The exchange can also be performed in the reverse
+   * direction, which moves the data back to the original
+   * distribution.
+   */
+  class RedistPlan {
+  public:
+    RedistPlan() = default;
+
+    /**
+     * Construct the plan from the number of entries to send to each
+     * process. The receive counts are obtained with a single
+     * all-to-all. Collective on comm.
+     *
+     * \param scnts number of entries to send to each of the
+     * comm.size() processes
+     * \param comm communicator on which the exchange takes place
+     */
+    RedistPlan(std::vector<int> scnts, const MPIComm& comm)
+      : scnts_(std::move(scnts)) {
+      auto P = comm.size();
+      rcnts_.resize(P);
+      comm.all_to_all(scnts_.data(), 1, rcnts_.data());
+      sdispls_.resize(P);
+      rdispls_.resize(P);
+      for (int p=1; p<P; p++) {
+        sdispls_[p] = sdispls_[p-1] + scnts_[p-1];
+        rdispls_[p] = rdispls_[p-1] + rcnts_[p-1];
+      }
+      for (int p=0; p<P; p++) {
+        if (scnts_[p]) sranks_.push_back(p);
+        if (rcnts_[p]) rranks_.push_back(p);
+      }
+    }
+
+    std::size_t send_size() const {
+      return scnts_.empty() ? 0 : std::size_t(sdispls_.back()) + scnts_.back();
+    }
+    std::size_t recv_size() const {
+      return rcnts_.empty() ? 0 : std::size_t(rdispls_.back()) + rcnts_.back();
+    }
+    const std::vector<int>& sdispls() const { return sdispls_; }
+
+    /**
+     * Send sbuf, ordered according to the send displacements, and
+     * receive in rbuf, ordered according to the receive
+     * displacements. Every entry consists of k consecutive values.
+     */
+    template<typename T> void
+    exchange(const T* sbuf, T* rbuf, const MPIComm& comm, int k=1) const {
+      exchange(sbuf, scnts_, sdispls_, sranks_,
+               rbuf, rcnts_, rdispls_, rranks_, comm, k);
+    }
+
+    /**
+     * Reverse of exchange, send back the entries in rbuf, to sbuf.
+     */
+    template<typename T> void
+    exchange_back(const T* rbuf, T* sbuf, const MPIComm& comm, int k=1) const {
+      exchange(rbuf, rcnts_, rdispls_, rranks_,
+               sbuf, scnts_, sdispls_, sranks_, comm, k);
+    }
+
+  private:
+    std::vector<int> scnts_, sdispls_, rcnts_, rdispls_;
+    std::vector<int> sranks_, rranks_;
+    static const int tag_ = 31;
+
+    template<typename T> static void
+    exchange(const T* sbuf, const std::vector<int>& scnts,
+             const std::vector<int>& sdispls, const std::vector<int>& sranks,
+             T* rbuf, const std::vector<int>& rcnts,
+             const std::vector<int>& rdispls, const std::vector<int>& rranks,
+             const MPIComm& comm, int k) {
+      auto rank = comm.rank();
+      std::vector<MPI_Request> req;
+      req.reserve(sranks.size() + rranks.size());
+      for (auto p : rranks) {
+        if (p == rank) continue;
+        req.emplace_back();
+        MPI_Irecv(rbuf+std::size_t(k)*rdispls[p], k*rcnts[p], mpi_type<T>(),
+                  p, tag_, comm.comm(), &req.back());
+      }
+      for (auto p : sranks) {
+        if (p == rank) continue;
+        req.emplace_back();
+        MPI_Isend(const_cast<T*>(sbuf)+std::size_t(k)*sdispls[p],
+                  k*scnts[p], mpi_type<T>(), p, tag_, comm.comm(),
+                  &req.back());
+      }
+      if (!scnts.empty() && scnts[rank])
+        std::copy(sbuf+std::size_t(k)*sdispls[rank],
+                  sbuf+std::size_t(k)*(sdispls[rank]+scnts[rank]),
+                  rbuf+std::size_t(k)*rdispls[rank]);
+      MPI_Waitall(req.size(), req.data(), MPI_STATUSES_IGNORE);
+    }
+  };
+
+  /**
+   * Reusable version of permute_vector. The destination of every
+   * local row is computed once, in the constructor, after which
+   * apply only sends the values.
+   */
+  template<typename integer_t> class PermutePlanMPI {
+  public:
+    /**
+     * Build the plan to permute a vector distributed according to
+     * dist, with the global inverse permutation iorder. Collective
+     * on comm.
+     *
+     * \param iorder The global inverse permutation, size dist[P].
+     * \param dist Describes distribution of the vector, dist has P+1
+     * elements process p has elements [dist[p],dist[p+1])
+     * \param comm The MPI communicator, comm.size() == P
+     */
+    PermutePlanMPI(const std::vector<integer_t>& iorder,
+                   const std::vector<integer_t>& dist,
+                   const MPIComm& comm) {
+      auto rank = comm.rank();
+      auto P = comm.size();
+      auto lo = dist[rank];
+      auto m = dist[rank+1] - lo;
+      std::vector<int> scnts(P), dest(m);
+      for (integer_t r=0; r<m; r++) {
+        dest[r] = std::upper_bound
+          (dist.begin(), dist.end(), iorder[r+lo]) - dist.begin() - 1;
+        scnts[dest[r]]++;
+      }
+      plan_ = RedistPlan(std::move(scnts), comm);
+      auto pp = plan_.sdispls();
+      spos_.resize(m);
+      std::vector<integer_t> sidx(m), ridx(plan_.recv_size());
+      for (integer_t r=0; r<m; r++) {
+        spos_[r] = pp[dest[r]]++;
+        sidx[spos_[r]] = iorder[r+lo];
+      }
+      plan_.exchange(sidx.data(), ridx.data(), comm);
+      rpos_.resize(ridx.size());
+      for (std::size_t i=0; i<ridx.size(); i++)
+        rpos_[i] = ridx[i] - lo;
+    }
+
+    /**
+     * Apply the permutation to the local rows of x, all columns at
+     * once. Collective on comm, which should be the same
+     * communicator as used to construct this plan.
+     */
+    template<typename scalar_t> void
+    apply(DenseMatrix<scalar_t>& x, const MPIComm& comm) const {
+      std::size_t n = x.cols();
+      std::vector<scalar_t> sbuf(spos_.size()*n), rbuf(rpos_.size()*n);
+      for (std::size_t r=0; r<spos_.size(); r++)
+        for (std::size_t c=0; c<n; c++)
+          sbuf[spos_[r]*n+c] = x(r,c);
+      plan_.exchange(sbuf.data(), rbuf.data(), comm, n);
+#pragma omp parallel for
+      for (std::size_t i=0; i<rpos_.size(); i++)
+        for (std::size_t c=0; c<n; c++)
+          x(rpos_[i],c) = rbuf[i*n+c];
+    }
+
+  private:
+    RedistPlan plan_;
+    std::vector<integer_t> spos_, rpos_;
+  };
+
   /**
    * Helper class to receive the sub graph that is owned by process
    * owner.  This class will store the separator tree information,
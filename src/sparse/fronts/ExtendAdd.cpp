@@ -224,7 +224,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   ExtendAdd<scalar_t,integer_t>::extend_add_copy_from_buffers
   (DistM_t& F11, DistM_t& F12, DistM_t& F21, DistM_t& F22,
-   scalar_t** pbuf, const FMPI_t* pa, const FMPI_t* ch) {
+   scalar_t** pbuf, const FMPI_t* pa, const FMPI_t* ch, int src) {
     if (!(F11.active() || F22.active())) return;
     const auto ch_dim_upd = ch->dim_upd();
     const auto& ch_upd = ch->upd();
@@ -281,6 +281,21 @@ namespace strumpack {
       c_2[c_max_2] = c;
       upd_c_2[c_max_2++] = ((uc / B) % pcols) * prows;
     }
+    if (src >= 0) {
+      // Only keep the rows from process row src % prows and the
+      // columns from process column src / prows. The data from src
+      // is then read in the same order as it was packed.
+      auto keep = [](int* rc, int* u, integer_t& n, int up) {
+        integer_t m = 0;
+        for (integer_t i=0; i<n; i++)
+          if (u[i] == up) { rc[m] = rc[i]; u[m++] = up; }
+        n = m;
+      };
+      keep(r_1, upd_r_1, r_max_1, src % prows);
+      keep(r_2, upd_r_2, r_max_2, src % prows);
+      keep(c_1, upd_c_1, c_max_1, (src / prows) * prows);
+      keep(c_2, upd_c_2, c_max_2, (src / prows) * prows);
+    }
     for (int c=0; c<c_max_1; c++)
       for (int r=0, cc=c_1[c], ucc=upd_c_1[c]; r<r_max_1; r++)
         F11(r_1[r],cc) += *(pbuf[upd_r_1[r]+ucc]++);
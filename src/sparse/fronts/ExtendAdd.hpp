@@ -61,9 +61,15 @@ namespace strumpack {
     (DistM_t& F11, DistM_t& F12, DistM_t& F21, DistM_t& F22,
      scalar_t*& pbuf, const FMPI_t* pa, const F_t* ch);
 
+    /*
+     * If src >= 0, only the part of the contribution block sent by
+     * rank src (in the child grid) is added, and only pbuf[src] is
+     * used. This allows to assemble the messages in the order they
+     * arrive.
+     */
     static void extend_add_copy_from_buffers
     (DistM_t& F11, DistM_t& F12, DistM_t& F21, DistM_t& F22,
-     scalar_t** pbuf, const FMPI_t* pa, const FMPI_t* ch);
+     scalar_t** pbuf, const FMPI_t* pa, const FMPI_t* ch, int src=-1);
 
     static void extend_add_column_copy_to_buffers
     (const DistM_t& CB, VVS_t& sbuf, const FMPI_t* pa, const VI_t& I);
@@ -31,8 +31,10 @@
 #include <random>
 #include <vector>
 #include <cmath>
+#include <queue>
 
 #include "Front.hpp"
+#include "clustering/Clustering.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontMPI.hpp"
@@ -107,6 +109,11 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::upd_to_parent
   (const F_t* pa, std::size_t& upd2sep, std::size_t* I) const {
+    if (pa == pa_map_front_) {
+      std::copy(pa_map_.I.begin(), pa_map_.I.end(), I);
+      upd2sep = pa_map_.upd2sep;
+      return;
+    }
     integer_t r = 0, dupd = dim_upd(), pa_dsep = pa->dim_sep();
     for (; r<dupd; r++) {
       auto up = upd_[r];
@@ -123,17 +130,44 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::upd_to_parent
   (const F_t* pa, std::size_t* I) const {
-    integer_t r = 0, dupd = dim_upd(), pa_dsep = pa->dim_sep();
-    for (; r<dupd; r++) {
-      auto up = upd_[r];
-      if (up >= pa->sep_end_) break;
-      I[r] = up - pa->sep_begin_;
-    }
-    for (integer_t t=0; r<dupd; r++) {
-      auto up = upd_[r];
-      while (pa->upd_[t] < up) t++;
-      I[r] = t + pa_dsep;
+    std::size_t upd2sep;
+    upd_to_parent(pa, upd2sep, I);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::compute_parent_map
+  (const F_t* pa, ParentMap& M) const {
+    const std::size_t dupd = dim_upd();
+    M.I.resize(dupd);
+    upd_to_parent(pa, M.upd2sep, M.I.data());
+    M.runs.clear();
+    for (std::size_t r=0; r<dupd; r++)
+      if (r == 0 || r == M.upd2sep || M.I[r] != M.I[r-1] + 1)
+        M.runs.push_back(r);
+    M.runs.push_back(dupd);
+  }
+
+  template<typename scalar_t,typename integer_t>
+  const typename Front<scalar_t,integer_t>::ParentMap&
+  Front<scalar_t,integer_t>::parent_map
+  (const F_t* pa, ParentMap& tmp) const {
+    if (pa == pa_map_front_) return pa_map_;
+    compute_parent_map(pa, tmp);
+    return tmp;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::setup_parent_maps(int task_depth) {
+    for (auto ch : {lchild_.get(), rchild_.get()}) {
+      if (!ch) continue;
+      ch->pa_map_front_ = nullptr;
+      ch->compute_parent_map(this, ch->pa_map_);
+      ch->pa_map_front_ = this;
+#pragma omp task default(shared) firstprivate(ch,task_depth)            \
+  if(task_depth < params::task_recursion_cutoff_level)
+      ch->setup_parent_maps(task_depth+1);
     }
+#pragma omp taskwait
   }
 
   template<typename scalar_t,typename integer_t> std::vector<std::size_t>
@@ -232,7 +266,24 @@ namespace strumpack {
   (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
     DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
     bupd.zero();
-    if (task_depth == 0) {
+    SolveSchedule s;
+    if (task_depth == 0 && solve_schedule(s, etree_level)) {
+      // the independent subtrees, largest first, without tasking
+#pragma omp parallel for schedule(dynamic,1)
+      for (std::size_t i=0; i<s.sub.size(); i++) {
+        auto f = s.sub[i];
+        auto& w = s.work[i];
+        w.resize(f->levels());
+        for (std::size_t l=0; l<w.size(); l++)
+          w[l] = DenseM_t(f->max_dim_upd(), b.cols());
+        f->forward_multifrontal_solve
+          (b, w.data(), s.level[i], params::task_recursion_cutoff_level);
+      }
+      // the fronts above, with task parallel dense kernels
+#pragma omp parallel
+#pragma omp single nowait
+      fwd_solve_scheduled(b, bupd, s, etree_level);
+    } else if (task_depth == 0) {
       // tasking when calling the children
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
@@ -248,14 +299,24 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::fwd_solve_phase1
   (DenseM_t& b, DenseM_t& bupd, DenseM_t* work,
-   int etree_level, int task_depth) const {
+   int etree_level, int task_depth, const std::vector<char>* pat) const {
+    // with pat, children without any marked rows are skipped, and only
+    // the ones with nonzero right-hand side rows contribute
+    auto visit = [&](const std::unique_ptr<F_t>& ch) {
+      return ch && (!pat || (*pat)[ch->sep_]); };
+    auto contrib = [&](const std::unique_ptr<F_t>& ch) {
+      return ch && (!pat || ((*pat)[ch->sep_] & SOLVE_FWD)); };
+    auto solve = [&](const std::unique_ptr<F_t>& ch, DenseM_t* w,
+                     int depth) {
+      if (pat) ch->forward_sparse_solve(b, w, *pat, etree_level+1, depth);
+      else ch->forward_multifrontal_solve(b, w, etree_level+1, depth);
+    };
     if (task_depth < params::task_recursion_cutoff_level) {
-      if (lchild_)
+      if (visit(lchild_))
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        lchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth+1);
-      if (rchild_)
+        solve(lchild_, work+1, task_depth+1);
+      if (visit(rchild_))
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         {
@@ -264,28 +325,31 @@ namespace strumpack {
           //   cb = DenseM_t(rchild_->max_dim_upd(), b.cols());
           for (std::size_t i=0; i<work2.size(); i++)
             work2[i] = DenseM_t(rchild_->max_dim_upd(), b.cols());
-          rchild_->forward_multifrontal_solve
-            (b, work2.data(), etree_level+1, task_depth+1);
-          DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work2[0], 0, 0);
-          rchild_->extend_add_b(b, bupd, CBch, this);
+          solve(rchild_, work2.data(), task_depth+1);
+          if (contrib(rchild_)) {
+            DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work2[0], 0, 0);
+            rchild_->extend_add_b(b, bupd, CBch, this);
+          }
         }
 #pragma omp taskwait
-      if (lchild_) {
+      if (contrib(lchild_)) {
         DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
         lchild_->extend_add_b(b, bupd, CBch, this);
       }
     } else {
-      if (lchild_) {
-        lchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth);
-        DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
-        lchild_->extend_add_b(b, bupd, CBch, this);
+      if (visit(lchild_)) {
+        solve(lchild_, work+1, task_depth);
+        if (contrib(lchild_)) {
+          DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
+          lchild_->extend_add_b(b, bupd, CBch, this);
+        }
       }
-      if (rchild_) {
-        rchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth);
-        DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work[1], 0, 0);
-        rchild_->extend_add_b(b, bupd, CBch, this);
+      if (visit(rchild_)) {
+        solve(rchild_, work+1, task_depth);
+        if (contrib(rchild_)) {
+          DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work[1], 0, 0);
+          rchild_->extend_add_b(b, bupd, CBch, this);
+        }
       }
     }
   }
@@ -294,7 +358,19 @@ namespace strumpack {
   Front<scalar_t,integer_t>::backward_multifrontal_solve
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
-    if (task_depth == 0) {
+    SolveSchedule s;
+    if (task_depth == 0 && solve_schedule(s, etree_level)) {
+      // the fronts above the independent subtrees, with task
+      // parallel dense kernels, this also sets up s.work
+#pragma omp parallel
+#pragma omp single nowait
+      bwd_solve_scheduled(y, yupd, s, etree_level);
+#pragma omp parallel for schedule(dynamic,1)
+      for (std::size_t i=0; i<s.sub.size(); i++)
+        s.sub[i]->backward_multifrontal_solve
+          (y, s.work[i].data(), s.level[i],
+           params::task_recursion_cutoff_level);
+    } else if (task_depth == 0) {
       // no tasking in blas routines, use system threaded blas instead
       bwd_solve_phase1
         (y, yupd, etree_level, params::task_recursion_cutoff_level);
@@ -311,19 +387,26 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::bwd_solve_phase2
   (DenseM_t& y, DenseM_t& yupd, DenseM_t* work,
-   int etree_level, int task_depth) const {
+   int etree_level, int task_depth, const std::vector<char>* pat) const {
+    // with pat, only the children with marked solution rows are visited
+    auto visit = [&](const std::unique_ptr<F_t>& ch) {
+      return ch && (!pat || ((*pat)[ch->sep_] & SOLVE_BWD)); };
+    auto solve = [&](const std::unique_ptr<F_t>& ch, DenseM_t* w,
+                     int depth) {
+      if (pat) ch->backward_sparse_solve(y, w, *pat, etree_level+1, depth);
+      else ch->backward_multifrontal_solve(y, w, etree_level+1, depth);
+    };
     if (task_depth < params::task_recursion_cutoff_level) {
-      if (lchild_) {
+      if (visit(lchild_)) {
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         {
           DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
           lchild_->extract_b(y, yupd, CB, this);
-          lchild_->backward_multifrontal_solve
-            (y, work+1, etree_level+1, task_depth+1);
+          solve(lchild_, work+1, task_depth+1);
         }
       }
-      if (rchild_) {
+      if (visit(rchild_)) {
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         {
@@ -334,27 +417,189 @@ namespace strumpack {
             work2[i] = DenseM_t(rchild_->max_dim_upd(), y.cols());
           DenseMW_t CB(rchild_->dim_upd(), y.cols(), work2[0], 0, 0);
           rchild_->extract_b(y, yupd, CB, this);
-          rchild_->backward_multifrontal_solve
-            (y, work2.data(), etree_level+1, task_depth+1);
+          solve(rchild_, work2.data(), task_depth+1);
         }
       }
 #pragma omp taskwait
     } else {
-      if (lchild_) {
+      if (visit(lchild_)) {
         DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
         lchild_->extract_b(y, yupd, CB, this);
-        lchild_->backward_multifrontal_solve
-          (y, work+1, etree_level+1, task_depth);
+        solve(lchild_, work+1, task_depth);
       }
-      if (rchild_) {
+      if (visit(rchild_)) {
         DenseMW_t CB(rchild_->dim_upd(), y.cols(), work[1], 0, 0);
         rchild_->extract_b(y, yupd, CB, this);
-        rchild_->backward_multifrontal_solve
-          (y, work+1, etree_level+1, task_depth);
+        solve(rchild_, work+1, task_depth);
       }
     }
   }
 
+  template<typename scalar_t,typename integer_t> double
+  Front<scalar_t,integer_t>::solve_cost(std::vector<double>& cost) const {
+    double ds = dim_sep(), du = dim_upd(), c = ds * ds + 2. * ds * du;
+    if (lchild_) c += lchild_->solve_cost(cost);
+    if (rchild_) c += rchild_->solve_cost(cost);
+    if (cost.size() <= std::size_t(sep_)) cost.resize(sep_+1, 0.);
+    return cost[sep_] = c;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::solve_schedule
+  (SolveSchedule& s, int etree_level) const {
+#if defined(_OPENMP)
+    int P = omp_get_max_threads();
+    if (P == 1 || omp_in_parallel() || !solve_per_front() ||
+        !(lchild_ || rchild_))
+      return false;
+    std::vector<double> cost;
+    double total = solve_cost(cost);
+    // Split the most expensive subtree, until all are cheap enough to
+    // balance the work over the threads. The fronts which are split
+    // are solved with the task parallel kernels.
+    const double cutoff = total / (4 * P);
+    using E_t = std::pair<const F_t*,int>;
+    auto cmp = [&](const E_t& a, const E_t& b) {
+      return cost[a.first->sep_] < cost[b.first->sep_]; };
+    std::priority_queue<E_t,std::vector<E_t>,decltype(cmp)> q(cmp);
+    auto push = [&](const F_t* f, int l) { if (f) q.push({f, l}); };
+    push(lchild_.get(), etree_level+1);
+    push(rchild_.get(), etree_level+1);
+    s.id.assign(cost.size(), -1);
+    while (!q.empty()) {
+      auto f = q.top().first;
+      auto l = q.top().second;
+      q.pop();
+      if (cost[f->sep_] > cutoff && f->solve_per_front() &&
+          (f->lchild_ || f->rchild_)) {
+        push(f->lchild_.get(), l+1);
+        push(f->rchild_.get(), l+1);
+      } else {
+        // popped in order of decreasing cost
+        s.id[f->sep_] = s.sub.size();
+        s.sub.push_back(f);
+        s.level.push_back(l);
+      }
+    }
+    s.work.resize(s.sub.size());
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::fwd_solve_scheduled
+  (DenseM_t& b, DenseM_t& bupd, SolveSchedule& s, int etree_level) const {
+    for (auto ch : {lchild_.get(), rchild_.get()}) {
+      if (!ch) continue;
+      auto i = s.id[ch->sep_];
+      if (i >= 0) {
+        DenseMW_t CBch(ch->dim_upd(), b.cols(), s.work[i][0], 0, 0);
+        ch->extend_add_b(b, bupd, CBch, this);
+      } else {
+        DenseM_t CBch(ch->dim_upd(), b.cols());
+        CBch.zero();
+        ch->fwd_solve_scheduled(b, CBch, s, etree_level+1);
+        ch->extend_add_b(b, bupd, CBch, this);
+      }
+    }
+    fwd_solve_phase2(b, bupd, etree_level, 0);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::bwd_solve_scheduled
+  (DenseM_t& y, DenseM_t& yupd, SolveSchedule& s, int etree_level) const {
+    bwd_solve_phase1(y, yupd, etree_level, 0);
+    for (auto ch : {lchild_.get(), rchild_.get()}) {
+      if (!ch) continue;
+      auto i = s.id[ch->sep_];
+      if (i >= 0) {
+        auto& w = s.work[i];
+        w.resize(ch->levels());
+        for (std::size_t l=0; l<w.size(); l++)
+          w[l] = DenseM_t(ch->max_dim_upd(), y.cols());
+        DenseMW_t CB(ch->dim_upd(), y.cols(), w[0], 0, 0);
+        ch->extract_b(y, yupd, CB, this);
+      } else {
+        DenseM_t CB(ch->dim_upd(), y.cols());
+        ch->extract_b(y, yupd, CB, this);
+        ch->bwd_solve_scheduled(y, CB, s, etree_level+1);
+      }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::multifrontal_solve_sparse
+  (DenseM_t& b, const std::vector<bool>& brow,
+   const std::vector<bool>& xrow) const {
+    std::vector<char> pat;
+    solve_pattern(brow, xrow, pat);
+    auto max_dupd = max_dim_upd();
+    std::vector<DenseM_t> CB(levels());
+    for (std::size_t i=0; i<CB.size(); i++)
+      CB[i] = DenseM_t(max_dupd, b.cols());
+    TIMER_TIME(TaskType::FORWARD_SOLVE, 0, t_fwd);
+    forward_sparse_solve(b, CB.data(), pat, 0, 0);
+    TIMER_STOP(t_fwd);
+    TIMER_TIME(TaskType::BACKWARD_SOLVE, 0, t_bwd);
+    backward_sparse_solve(b, CB.data(), pat, 0, 0);
+    TIMER_STOP(t_bwd);
+  }
+
+  template<typename scalar_t,typename integer_t> char
+  Front<scalar_t,integer_t>::solve_pattern
+  (const std::vector<bool>& brow, const std::vector<bool>& xrow,
+   std::vector<char>& pat) const {
+    char p = 0;
+    for (integer_t i=sep_begin_; i<sep_end_; i++) {
+      if (brow[i]) p |= SOLVE_FWD;
+      if (xrow[i]) p |= SOLVE_BWD;
+    }
+    if (lchild_) p |= lchild_->solve_pattern(brow, xrow, pat);
+    if (rchild_) p |= rchild_->solve_pattern(brow, xrow, pat);
+    if (pat.size() <= std::size_t(sep_)) pat.resize(sep_+1, 0);
+    pat[sep_] = p;
+    return p;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::forward_sparse_solve
+  (DenseM_t& b, DenseM_t* work, const std::vector<char>& pat,
+   int etree_level, int task_depth) const {
+    // nothing to do if the right-hand side is zero in this subtree
+    if (!(pat[sep_] & SOLVE_FWD)) return;
+    DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
+    bupd.zero();
+    if (task_depth == 0) {
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth, &pat);
+      fwd_solve_phase2(b, bupd, etree_level, params::task_recursion_cutoff_level);
+    } else {
+      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth, &pat);
+      fwd_solve_phase2(b, bupd, etree_level, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::backward_sparse_solve
+  (DenseM_t& y, DenseM_t* work, const std::vector<char>& pat,
+   int etree_level, int task_depth) const {
+    if (!(pat[sep_] & SOLVE_BWD)) return;
+    DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
+    if (task_depth == 0) {
+      bwd_solve_phase1
+        (y, yupd, etree_level, params::task_recursion_cutoff_level);
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth, &pat);
+    } else {
+      bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth, &pat);
+    }
+  }
+
   template<typename scalar_t,typename integer_t> long long
   Front<scalar_t,integer_t>::factor_nonzeros(int task_depth) const {
     long long nnz = node_factor_nonzeros(), nnzl = 0, nnzr = 0;
@@ -397,6 +642,69 @@ namespace strumpack {
     return node_inertia(neg, zero, pos);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  Front<scalar_t,integer_t>::selected_inverse
+  (DenseM_t& Zuu, const std::vector<integer_t>& r,
+   const std::vector<integer_t>& c, const std::vector<std::size_t>& ord,
+   scalar_t* v, int task_depth) const {
+    DenseM_t Z;
+    auto e = node_selected_inverse(Zuu, Z, task_depth);
+    Zuu.clear();
+    if (e != ReturnCode::SUCCESS) return e;
+    const std::size_t ds = dim_sep(), dz = Z.rows();
+    auto key = [&](std::size_t k) { return std::min(r[k], c[k]); };
+    auto lo = std::partition_point
+      (ord.begin(), ord.end(),
+       [&](std::size_t k) { return key(k) < sep_begin_; });
+    auto hi = std::partition_point
+      (lo, ord.end(), [&](std::size_t k) { return key(k) < sep_end_; });
+    // index in this front, dz if not in the sparsity pattern
+    auto local = [&](integer_t i) {
+      if (i < sep_end_) return std::size_t(i - sep_begin_);
+      auto u = std::lower_bound(upd_.begin(), upd_.end(), i);
+      return (u == upd_.end() || *u != i) ? dz :
+        ds + std::size_t(u - upd_.begin());
+    };
+    for (auto k=lo; k!=hi; k++) {
+      auto i = local(r[*k]), j = local(c[*k]);
+      if (i == dz || j == dz) e = ReturnCode::NOT_SUPPORTED;
+      else v[*k] = Z(i, j);
+    }
+    // the blocks of the inverse needed by the children
+    DenseM_t Zl, Zr;
+    auto extract = [&](const F_t* ch, DenseM_t& Zc) {
+      auto I = ch->upd_to_parent(this);
+      const std::size_t du = I.size();
+      Zc = DenseM_t(du, du);
+      for (std::size_t j=0; j<du; j++)
+        for (std::size_t i=0; i<du; i++)
+          Zc(i, j) = Z(I[i], I[j]);
+    };
+    if (lchild_) extract(lchild_.get(), Zl);
+    if (rchild_) extract(rchild_.get(), Zr);
+    Z.clear();
+    ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    if (task_depth < params::task_recursion_cutoff_level) {
+      if (lchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        el = lchild_->selected_inverse(Zl, r, c, ord, v, task_depth+1);
+      if (rchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        er = rchild_->selected_inverse(Zr, r, c, ord, v, task_depth+1);
+#pragma omp taskwait
+    } else {
+      if (lchild_)
+        el = lchild_->selected_inverse(Zl, r, c, ord, v, task_depth);
+      if (rchild_)
+        er = rchild_->selected_inverse(Zr, r, c, ord, v, task_depth);
+    }
+    if (el != ReturnCode::SUCCESS) return el;
+    if (er != ReturnCode::SUCCESS) return er;
+    return e;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   Front<scalar_t,integer_t>::subnormals(std::size_t& ns,
                                         std::size_t& nz) const {
@@ -466,7 +774,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::extend_add_copy_from_buffers
   (DistM_t& F11, DistM_t& F12, DistM_t& F21, DistM_t& F22,
-   scalar_t** pbuf, const FMPI_t* pa) const {
+   scalar_t** pbuf, const FMPI_t* pa, int) const {
     ExtendAdd<scalar_t,integer_t>::extend_add_seq_copy_from_buffers
       (F11, F12, F21, F22, *pbuf, pa, this);
   }
@@ -602,6 +910,24 @@ namespace strumpack {
     partition(opts, A, sorder, is_root, task_depth);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::partition_fronts
+  (const Opts_t& opts, const SpMat_t& A, const DenseMatrix<real_t>& coords,
+   integer_t* sorder, bool is_root, int task_depth) {
+    auto lch = lchild_.get();
+    auto rch = rchild_.get();
+    if (lch)
+#pragma omp task default(shared) firstprivate(sorder,task_depth,lch)    \
+  if(task_depth < params::task_recursion_cutoff_level)
+      lch->partition_fronts(opts, A, coords, sorder, false, task_depth+1);
+    if (rch)
+#pragma omp task default(shared) firstprivate(sorder,task_depth,rch)    \
+  if(task_depth < params::task_recursion_cutoff_level)
+      rch->partition_fronts(opts, A, coords, sorder, false, task_depth+1);
+#pragma omp taskwait
+    partition_coordinates(opts, A, coords, sorder, is_root, task_depth);
+  }
+
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::partition
   (const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
@@ -611,6 +937,30 @@ namespace strumpack {
     std::iota(sorder+sep_begin_, sorder+sep_end_, sep_begin_);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::partition_coordinates
+  (const Opts_t& opts, const SpMat_t& A, const DenseMatrix<real_t>& coords,
+   integer_t* sorder, bool is_root, int task_depth) {
+    partition(opts, A, sorder, is_root, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> structured::ClusterTree
+  Front<scalar_t,integer_t>::cluster_separator
+  (const DenseMatrix<real_t>& coords, integer_t* sorder,
+   int leaf_size) const {
+    DenseMatrix<real_t> p(coords.rows(), dim_sep());
+    for (integer_t i=0; i<dim_sep(); i++)
+      for (std::size_t k=0; k<p.rows(); k++)
+        p(k, i) = coords(k, sep_begin_+i);
+    std::vector<int> cperm;
+    auto tree = binary_tree_clustering
+      (ClusteringAlgorithm::PCA, p, cperm, leaf_size);
+    // cperm is 1-based, cperm[i] is the old position of i
+    for (integer_t i=0; i<dim_sep(); i++)
+      sorder[sep_begin_+cperm[i]-1] = sep_begin_ + i;
+    return tree;
+  }
+
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::permute_CB
   (const integer_t* perm, int task_depth) {
@@ -627,9 +977,138 @@ namespace strumpack {
     for (integer_t i=0; i<dim_upd(); i++)
       upd_[i] = perm[upd_[i]];
     std::sort(upd_.begin(), upd_.end());
+    pa_map_ = ParentMap();
+    pa_map_front_ = nullptr;
+#pragma omp taskwait
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::write_analysis(std::ostream& os) const {
+    write_binary(os, sep_);
+    write_binary(os, upd_);
+    write_binary(os, type());
+    write_partition(os);
+    if (lchild_) lchild_->write_analysis(os);
+    if (rchild_) rchild_->write_analysis(os);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::write_cluster_tree
+  (std::ostream& os, const structured::ClusterTree& t) {
+    write_binary(os, t.serialize());
+  }
+
+  template<typename scalar_t,typename integer_t> structured::ClusterTree
+  Front<scalar_t,integer_t>::read_cluster_tree
+  (std::istream& is, std::size_t n) {
+    std::vector<int> buf;
+    read_binary(is, buf);
+    if (buf.empty() || buf[0] < 1 || buf.size() != 3*std::size_t(buf[0])+1)
+      throw std::runtime_error("invalid cluster tree");
+    auto t = structured::ClusterTree::deserialize(buf);
+    if (std::size_t(t.size) != n)
+      throw std::runtime_error("cluster tree does not match separator");
+    return t;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::cluster_CB
+  (const Opts_t& opts, int task_depth) {
+    cluster_CB_rec(opts, {}, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::cluster_CB_rec
+  (const Opts_t& opts, std::vector<const F_t*> anc, int task_depth) {
+    if (dim_upd()) cluster_CB_node(opts, anc);
+    anc.push_back(this);
+    auto lch = lchild_.get();
+    auto rch = rchild_.get();
+    if (lch)
+#pragma omp task default(shared) firstprivate(anc,task_depth,lch)       \
+  if(task_depth < params::task_recursion_cutoff_level)
+      lch->cluster_CB_rec(opts, anc, task_depth+1);
+    if (rch)
+#pragma omp task default(shared) firstprivate(anc,task_depth,rch)       \
+  if(task_depth < params::task_recursion_cutoff_level)
+      rch->cluster_CB_rec(opts, anc, task_depth+1);
 #pragma omp taskwait
   }
 
+  /*
+   * Restrict cluster tree T, for the index range [lo, lo+T.size), to
+   * the sorted indices [ib, ie). Empty subtrees are removed, and
+   * nodes with at most leaf_size indices become leafs.
+   */
+  template<typename integer_t> structured::ClusterTree
+  restrict_cluster_tree(const structured::ClusterTree& T, integer_t lo,
+                        const integer_t* ib, const integer_t* ie,
+                        int leaf_size) {
+    structured::ClusterTree R(ie - ib);
+    if (T.c.empty() || R.size <= leaf_size) return R;
+    auto hi = lo + T.c[0].size;
+    auto im = std::lower_bound(ib, ie, hi);
+    if (im == ib)
+      return restrict_cluster_tree(T.c[1], hi, ib, ie, leaf_size);
+    if (im == ie)
+      return restrict_cluster_tree(T.c[0], lo, ib, ie, leaf_size);
+    R.c.reserve(2);
+    R.c.push_back(restrict_cluster_tree(T.c[0], lo, ib, im, leaf_size));
+    R.c.push_back(restrict_cluster_tree(T.c[1], hi, im, ie, leaf_size));
+    return R;
+  }
+
+  inline structured::ClusterTree
+  merge_cluster_trees(std::vector<structured::ClusterTree>& T,
+                      std::size_t b, std::size_t e) {
+    if (e - b == 1) return std::move(T[b]);
+    auto m = (b + e) / 2;
+    structured::ClusterTree R;
+    R.c.reserve(2);
+    R.c.push_back(merge_cluster_trees(T, b, m));
+    R.c.push_back(merge_cluster_trees(T, m, e));
+    R.size = R.c[0].size + R.c[1].size;
+    return R;
+  }
+
+  /*
+   * The upd_ indices are a subset of the ancestor separators, and
+   * since upd_ is sorted, the indices that belong to the same
+   * ancestor are contiguous. After separator reordering, each
+   * ancestor separator is ordered according to its cluster tree, so
+   * restricting that tree to the upd_ indices gives a clustering of
+   * the CB that follows the graph partitioning of the ancestor.
+   * Indices of ancestors without a cluster tree are just refined
+   * uniformly.
+   */
+  template<typename scalar_t,typename integer_t> structured::ClusterTree
+  Front<scalar_t,integer_t>::CB_cluster_tree
+  (const std::vector<const F_t*>& anc, int leaf_size) const {
+    std::vector<structured::ClusterTree> parts;
+    auto ub = upd_.data(), ue = ub + upd_.size();
+    // the parent has the lowest separator indices
+    for (auto a=anc.rbegin(); a!=anc.rend() && ub!=ue; a++) {
+      auto se = std::lower_bound(ub, ue, (*a)->sep_end_);
+      if (se == ub) continue;
+      assert(*ub >= (*a)->sep_begin_);
+      auto T = (*a)->sep_cluster_tree();
+      if (T && T->size == (*a)->dim_sep())
+        parts.push_back
+          (restrict_cluster_tree(*T, (*a)->sep_begin_, ub, se, leaf_size));
+      else {
+        parts.emplace_back(se - ub);
+        parts.back().refine(leaf_size);
+      }
+      ub = se;
+    }
+    if (ub != ue) { // should not happen, upd_ not in ancestors
+      parts.emplace_back(ue - ub);
+      parts.back().refine(leaf_size);
+    }
+    if (parts.empty()) return structured::ClusterTree(dim_upd());
+    return merge_cluster_trees(parts, 0, parts.size());
+  }
+
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::get_level_fronts
   (std::vector<const F_t*>& ldata, int elvl, int l) const {
@@ -32,13 +32,16 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <chrono>
 #include <typeinfo>
 
 #include "StrumpackParameters.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/Trace.hpp"
 #include "dense/DenseMatrix.hpp"
 #include "sparse/CompressedSparseMatrix.hpp"
 #include "BLR/BLRMatrix.hpp"
+#include "structured/ClusterTree.hpp"
 #if defined(_OPENMP)
 #include "omp.h"
 #endif
@@ -49,6 +52,52 @@
 
 namespace strumpack {
 
+  /**
+   * Record an event for the current front, see Trace.
+   */
+#define TRACE_FRONT(name)                                               \
+  TRACE_SCOPE(name, this->sep_begin_, this->dim_sep(), this->dim_upd())
+
+  /**
+   * Adds the wall clock time, and the flops counted by the calling
+   * thread, from construction to destruction, to the factorization
+   * counters of a type of front, see
+   * SolverStatistics::factor_fronts. A scope nested in another scope
+   * on the same thread is ignored, so work is not counted twice.
+   */
+  class FrontFactorStats {
+  public:
+    FrontFactorStats(params::FrontType t, bool count_front=true)
+      : t_(int(t)), outer_(!active()) {
+      if (!outer_) return;
+      active() = true;
+      if (count_front) params::front_type_counters[t_].fronts += 1;
+      f0_ = params::thread_flops();
+      t0_ = std::chrono::steady_clock::now();
+    }
+    ~FrontFactorStats() {
+      if (!outer_) return;
+      auto& c = params::front_type_counters[t_];
+      c.time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now() - t0_).count();
+      c.flops += params::thread_flops() - f0_;
+      active() = false;
+    }
+    FrontFactorStats(const FrontFactorStats&) = delete;
+    FrontFactorStats& operator=(const FrontFactorStats&) = delete;
+
+  private:
+    int t_;
+    bool outer_;
+    long long int f0_ = 0;
+    std::chrono::steady_clock::time_point t0_;
+
+    static bool& active() {
+      static thread_local bool a = false;
+      return a;
+    }
+  };
+
   template<typename scalar_t,typename integer_t> class FrontMPI;
   template<typename scalar_t,typename integer_t> class FrontBLRMPI;
 
@@ -60,6 +109,7 @@ namespace strumpack {
     using F_t = Front<scalar_t,integer_t>;
     using Opts_t = SPOptions<scalar_t>;
     using BLRM_t = BLR::BLRMatrix<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 #if defined(STRUMPACK_USE_MPI)
     using DistM_t = DistributedMatrix<scalar_t>;
     using FMPI_t = FrontMPI<scalar_t,integer_t>;
@@ -86,6 +136,12 @@ namespace strumpack {
                           std::vector<std::size_t>& lI,
                           std::vector<std::size_t>& oI) const;
 
+    // Store the map from upd_ to the parent front (see
+    // upd_to_parent) in all descendants of this front, with its
+    // contiguous runs, for the extend-add. Call this after the
+    // symbolic analysis, permute_CB clears the stored maps.
+    void setup_parent_maps(int task_depth=0);
+
     void upd_to_parent(const F_t* pa, std::size_t& upd2sep,
                        std::size_t* I) const;
     void upd_to_parent(const F_t* pa, std::size_t* I) const;
@@ -124,6 +180,19 @@ namespace strumpack {
 
     virtual void multifrontal_solve(DenseM_t& b) const;
 
+    /**
+     * Multifrontal solve for a right-hand side b which is zero
+     * outside of the rows marked in brow, computing the solution only
+     * for the rows marked in xrow. brow and xrow are indexed in the
+     * permuted numbering. Subtrees without any marked row in brow are
+     * skipped in the forward sweep, and subtrees without any marked
+     * row in xrow are skipped in the backward sweep. On return, the
+     * rows of b which are not marked in xrow do not hold the solution.
+     */
+    void multifrontal_solve_sparse(DenseM_t& b,
+                                   const std::vector<bool>& brow,
+                                   const std::vector<bool>& xrow) const;
+
     virtual void
     forward_multifrontal_solve(DenseM_t& b, DenseM_t* work,
                                int etree_level=0,
@@ -133,13 +202,17 @@ namespace strumpack {
                                 int etree_level=0,
                                 int task_depth=0) const;
 
+    // solve for the children, pruned using pat if not null, see
+    // forward_sparse_solve/backward_sparse_solve
     void fwd_solve_phase1(DenseM_t& b, DenseM_t& bupd, DenseM_t* work,
-                          int etree_level, int task_depth) const;
+                          int etree_level, int task_depth,
+                          const std::vector<char>* pat=nullptr) const;
     virtual
     void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
                           int etree_level, int task_depth) const {};
     void bwd_solve_phase2(DenseM_t& y, DenseM_t& yupd, DenseM_t* work,
-                          int etree_level, int task_depth) const;
+                          int etree_level, int task_depth,
+                          const std::vector<char>* pat=nullptr) const;
     virtual
     void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
                           int etree_level, int task_depth) const {};
@@ -150,6 +223,21 @@ namespace strumpack {
     ReturnCode subnormals(std::size_t& ns, std::size_t& nz) const;
     ReturnCode pivot_growth(scalar_t& pgL, scalar_t& pgU) const;
 
+    /**
+     * Selected inversion, top-down over this subtree. Zuu is the
+     * block of the inverse (of the permuted matrix) for the update
+     * indices of this front, it is cleared on return. Entry k of the
+     * inverse, at row r[k] and column c[k], is written to v[k]. The
+     * entries are handled by the front with min(r[k], c[k]) in its
+     * separator, and should be in the (symmetric) sparsity pattern of
+     * the factors. ord lists the entries sorted by min(r[k], c[k]).
+     */
+    ReturnCode selected_inverse(DenseM_t& Zuu,
+                                const std::vector<integer_t>& r,
+                                const std::vector<integer_t>& c,
+                                const std::vector<std::size_t>& ord,
+                                scalar_t* v, int task_depth=0) const;
+
 
     virtual std::size_t get_device_F22_worksize() {
       return dim_upd()*dim_upd();
@@ -166,23 +254,31 @@ namespace strumpack {
                     DenseM_t& CB, const F_t* p) {
       const std::size_t pdsep = F11.rows();
       const std::size_t dupd = CB.rows();
-      std::size_t upd2sep;
-      auto I = upd_to_parent(p, upd2sep);
+      ParentMap tmp;
+      const auto& M = parent_map(p, tmp);
+      const auto& I = M.I;
+      const auto upd2sep = M.upd2sep;
+      const std::size_t nruns = M.runs.size() - 1;
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)
 #endif
       for (std::size_t c=0; c<dupd; c++) {
         auto pc = I[c];
-        if (pc < pdsep) {
-          for (std::size_t r=0; r<upd2sep; r++)
-            F11(I[r],pc) += CB(r,c);
-          for (std::size_t r=upd2sep; r<dupd; r++)
-            F21(I[r]-pdsep,pc) += CB(r,c);
-        } else {
-          for (std::size_t r=0; r<upd2sep; r++)
-            F12(I[r],pc-pdsep) += CB(r, c);
-          for (std::size_t r=upd2sep; r<dupd; r++)
-            F22(I[r]-pdsep,pc-pdsep) += CB(r,c);
+        auto cb = CB.ptr(0, c);
+        // each run of rows maps to a contiguous part of a column of
+        // the parent, this loop vectorizes
+        for (std::size_t k=0; k<nruns; k++) {
+          auto rb = M.runs[k], re = M.runs[k+1];
+          scalar_t* d;
+          if (rb < upd2sep)
+            d = (pc < pdsep) ? F11.ptr(I[rb], pc) :
+              F12.ptr(I[rb], pc-pdsep);
+          else
+            d = (pc < pdsep) ? F21.ptr(I[rb]-pdsep, pc) :
+              F22.ptr(I[rb]-pdsep, pc-pdsep);
+          const scalar_t* s = cb + rb;
+          for (std::size_t r=0; r<re-rb; r++)
+            d[r] += s[r];
         }
       }
       STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
@@ -281,7 +377,29 @@ namespace strumpack {
     virtual void
     partition_fronts(const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
                      bool is_root=true, int task_depth=0);
+    // Same as above, but with the point coordinates (d x N, in the
+    // current order), used to cluster the separators geometrically.
+    void partition_fronts(const Opts_t& opts, const SpMat_t& A,
+                          const DenseMatrix<real_t>& coords,
+                          integer_t* sorder,
+                          bool is_root=true, int task_depth=0);
     void permute_CB(const integer_t* perm, int task_depth=0);
+    // Build the clustering of the contribution block (the upd_
+    // indices) from the clustering of the ancestor separators, after
+    // partition_fronts and permute_CB. Only changes compressed fronts.
+    void cluster_CB(const Opts_t& opts, int task_depth=0);
+
+    // Write the symbolic analysis of this front and its descendants,
+    // in preorder: separator index, update indices, front type and
+    // the partition of the separator. See EliminationTree for the
+    // counterpart.
+    void write_analysis(std::ostream& os) const;
+    // Write/read the result of partition (after permute_CB), nothing
+    // by default. read_partition throws std::runtime_error on invalid
+    // input.
+    virtual void write_partition(std::ostream& os) const {}
+    virtual void read_partition(const Opts_t& opts, std::istream& is,
+                                bool is_root) {}
 
     int levels() const {
       int ll = 0, lr = 0;
@@ -357,10 +475,17 @@ namespace strumpack {
                 << std::endl;
       abort();
     }
+    /*
+     * Add the contribution block data from pbuf to the parent front
+     * pa. pbuf points to the receive buffers, starting at the master
+     * of this child. If src >= 0, only the data received from rank
+     * src (relative to the master of this child) is added.
+     */
     virtual void
     extend_add_copy_from_buffers(DistM_t& F11, DistM_t& F12,
                                  DistM_t& F21, DistM_t& F22,
-                                 scalar_t** pbuf, const FMPI_t* pa) const;
+                                 scalar_t** pbuf, const FMPI_t* pa,
+                                 int src=-1) const;
 
     virtual void
     extadd_blr_copy_to_buffers(std::vector<std::vector<scalar_t>>& sbuf,
@@ -440,13 +565,105 @@ namespace strumpack {
     std::vector<integer_t> upd_;
     std::unique_ptr<F_t> lchild_, rchild_;
 
+    /*
+     * Relative index map from the contribution block to the front of
+     * the parent: row/column r of the CB maps to row/column I[r] of
+     * the parent front, with r < upd2sep mapping to the parent
+     * separator. The runs [runs[k], runs[k+1]) are maximal ranges
+     * with I[r+1] == I[r]+1, which do not cross upd2sep. The last
+     * element of runs is dim_upd().
+     */
+    struct ParentMap {
+      std::vector<std::size_t> I, runs;
+      std::size_t upd2sep = 0;
+    };
+    // the stored map, valid if pa_map_front_ is the parent
+    ParentMap pa_map_;
+    const F_t* pa_map_front_ = nullptr;
+
+    // returns the stored map for parent pa, or computes it in tmp
+    const ParentMap& parent_map(const F_t* pa, ParentMap& tmp) const;
+    void compute_parent_map(const F_t* pa, ParentMap& M) const;
+
     virtual long long node_factor_nonzeros() const {
       return dense_node_factor_nonzeros();
     }
 
+    // pat[sep_] & SOLVE_FWD if the subtree has a row marked in brow,
+    // pat[sep_] & SOLVE_BWD if it has a row marked in xrow, see
+    // multifrontal_solve_sparse
+    enum : char { SOLVE_FWD = 1, SOLVE_BWD = 2 };
+    char solve_pattern(const std::vector<bool>& brow,
+                       const std::vector<bool>& xrow,
+                       std::vector<char>& pat) const;
+    // forward/backward sweep, skipping the subtrees which are not
+    // needed according to pat. Fronts which can not be solved one
+    // front at a time (HSS, HODLR) do the full sweep on their subtree
+    virtual void
+    forward_sparse_solve(DenseM_t& b, DenseM_t* work,
+                         const std::vector<char>& pat,
+                         int etree_level, int task_depth) const;
+    virtual void
+    backward_sparse_solve(DenseM_t& y, DenseM_t* work,
+                          const std::vector<char>& pat,
+                          int etree_level, int task_depth) const;
+
+    // false for fronts which do the solve for their whole subtree in
+    // forward/backward_multifrontal_solve (HSS, HODLR), these are
+    // never split in the scheduled solve
+    virtual bool solve_per_front() const { return true; }
+
+    // Schedule for the multithreaded solve. The subtrees in sub are
+    // solved independently by the threads, in order of decreasing
+    // solve cost, each with its own workspace. The fronts above these
+    // subtrees are solved one at a time, with the task parallel dense
+    // kernels. id[sep_] is the index of a front in sub, or -1.
+    struct SolveSchedule {
+      std::vector<const F_t*> sub;
+      std::vector<int> level, id;
+      std::vector<std::vector<DenseM_t>> work;
+    };
+    // flops for the solve of the subtree with a single right-hand
+    // side, stored in cost[sep_] and returned
+    double solve_cost(std::vector<double>& cost) const;
+    // false if the subtree should be solved with the recursive tasks
+    bool solve_schedule(SolveSchedule& s, int etree_level) const;
+    void fwd_solve_scheduled(DenseM_t& b, DenseM_t& bupd,
+                             SolveSchedule& s, int etree_level) const;
+    void bwd_solve_scheduled(DenseM_t& y, DenseM_t& yupd,
+                             SolveSchedule& s, int etree_level) const;
+
     virtual void partition(const Opts_t& opts, const SpMat_t& A,
                            integer_t* sorder,
                            bool is_root=true, int task_depth=0);
+    // default ignores the coordinates and calls partition
+    virtual void partition_coordinates(const Opts_t& opts, const SpMat_t& A,
+                                       const DenseMatrix<real_t>& coords,
+                                       integer_t* sorder, bool is_root=true,
+                                       int task_depth=0);
+
+    // cluster tree of the separator, as computed in partition, or
+    // nullptr if the separator was not clustered
+    virtual const structured::ClusterTree* sep_cluster_tree() const {
+      return nullptr;
+    }
+    // ancestors are ordered from the root to the parent
+    virtual void cluster_CB_node(const Opts_t& opts,
+                                 const std::vector<const F_t*>& ancestors) {}
+    structured::ClusterTree
+    CB_cluster_tree(const std::vector<const F_t*>& ancestors,
+                    int leaf_size) const;
+    // used in write_partition/read_partition, read_cluster_tree
+    // checks that the tree has size n
+    static void write_cluster_tree(std::ostream& os,
+                                   const structured::ClusterTree& t);
+    static structured::ClusterTree
+    read_cluster_tree(std::istream& is, std::size_t n);
+    // Recursive inertial (PCA) clustering of the separator points,
+    // sets sorder for the separator, like partition
+    structured::ClusterTree
+    cluster_separator(const DenseMatrix<real_t>& coords,
+                      integer_t* sorder, int leaf_size) const;
 
     virtual ReturnCode node_inertia(integer_t& neg,
                                     integer_t& zero,
@@ -462,11 +679,21 @@ namespace strumpack {
                                          scalar_t& pgU) const {
       return ReturnCode::INACCURATE_INERTIA;
     }
+    // Z = the inverse on [sep, upd] of this front, given its block
+    // Zuu on the update indices, see factors_selected_inverse
+    virtual ReturnCode node_selected_inverse(const DenseM_t& Zuu,
+                                             DenseM_t& Z,
+                                             int task_depth) const {
+      return ReturnCode::NOT_SUPPORTED;
+    }
 
   private:
     Front(const Front&) = delete;
     Front& operator=(Front const&) = delete;
 
+    void cluster_CB_rec(const Opts_t& opts, std::vector<const F_t*> anc,
+                        int task_depth);
+
     virtual void draw_node(std::ostream& of, bool is_root) const;
 
     virtual long long dense_node_factor_nonzeros() const {
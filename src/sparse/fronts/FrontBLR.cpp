@@ -34,6 +34,7 @@
 #include "sparse/CSRGraph.hpp"
 #include "misc/TaskTimer.hpp"
 #include "dense/BLASLAPACKWrapper.hpp"
+#include "PanelSolve.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "BLR/BLRExtendAdd.hpp"
@@ -60,9 +61,8 @@ namespace strumpack {
     workspace.restore(CBstorage_);
     F22_.clear();
     F22blr_.clear();
-    admissibility_.clear();
-    sep_tiles_.clear();
-    upd_tiles_.clear();
+    // the partition (sep_tree_, tiles and admissibility) is small, it
+    // is kept for a refactorization and for save_analysis
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -300,6 +300,8 @@ namespace strumpack {
         er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
     }
     ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
+    TRACE_FRONT("factor_blr");
+    FrontFactorStats fs(params::FrontType::BLR);
     TaskTimer t("");
 #if defined(STRUMPACK_COUNT_FLOPS)
     long long int f0 = 0, ftot = 0;
@@ -405,20 +407,26 @@ namespace strumpack {
 #endif
           {
             DenseM_t F11(dsep, dsep), F12(dsep, dupd), F21(dupd, dsep);
-            F11.zero(); F12.zero(); F21.zero();
-            A.extract_front
-              (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
-            if (dupd) {
-              CBstorage_ = workspace.get(std::size_t(dupd)*dupd);
-              F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
-              F22_.zero();
+            {
+              TRACE_FRONT("assemble");
+              F11.zero(); F12.zero(); F21.zero();
+              A.extract_front
+                (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
+              if (dupd) {
+                CBstorage_ = workspace.get(std::size_t(dupd)*dupd);
+                F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
+                F22_.zero();
+              }
+            }
+            {
+              TRACE_FRONT("extend_add");
+              if (lchild_)
+                lchild_->extend_add_to_dense
+                  (F11, F12, F21, F22_, this, task_depth);
+              if (rchild_)
+                rchild_->extend_add_to_dense
+                  (F11, F12, F21, F22_, this, task_depth);
             }
-            if (lchild_)
-              lchild_->extend_add_to_dense
-                (F11, F12, F21, F22_, this, task_depth);
-            if (rchild_)
-              rchild_->extend_add_to_dense
-                (F11, F12, F21, F22_, this, task_depth);
             if (dsep) {
               auto nF11 = F11.normF();
               auto nF12 = F12.normF();
@@ -524,6 +532,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontBLR<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("fwd_solve");
     if (dim_sep()) {
       DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
       bloc.laswp(F11blr_.piv(), true);
@@ -549,6 +558,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontBLR<scalar_t,integer_t>::bwd_solve_phase1
   (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("bwd_solve");
     if (dim_sep()) {
       DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
 #if 1
@@ -618,6 +628,22 @@ namespace strumpack {
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontBLR<scalar_t,integer_t>::node_selected_inverse
+  (const DenseM_t& Zuu, DenseM_t& Z, int task_depth) const {
+    // the low-rank blocks are expanded, so the result is only as
+    // accurate as the BLR approximation of the factors
+    auto F11 = F11blr_.dense();
+    DenseM_t F12, F21;
+    if (dim_upd()) {
+      F12 = F12blr_.dense();
+      F21 = F21blr_.dense();
+    }
+    factors_selected_inverse
+      (F11, F12, F21, F11blr_.piv(), Zuu, Z, task_depth);
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontBLR<scalar_t,integer_t>::partition
   (const Opts_t& opts, const SpMat_t& A,
@@ -626,10 +652,10 @@ namespace strumpack {
       auto g = A.extract_graph
         (opts.separator_ordering_level(), sep_begin_, sep_end_);
 #if 1
-      auto sep_tree = g.recursive_bisection
+      sep_tree_ = g.recursive_bisection
         (opts.BLR_options().leaf_size(), 0,
          sorder+sep_begin_, nullptr, 0, 0, dim_sep());
-      sep_tiles_ = sep_tree.template leaf_sizes<std::size_t>();
+      sep_tiles_ = sep_tree_.template leaf_sizes<std::size_t>();
 #else
       int K = std::round((1.* dim_sep()) / opts.BLR_options().leaf_size());
       if (K > 1)
@@ -647,16 +673,77 @@ namespace strumpack {
       if (opts.BLR_options().admissibility() == BLR::Admissibility::STRONG) {
         g.permute(sorder+sep_begin_, siorder.data());
         admissibility_ = g.admissibility(sep_tiles_);
-      } else {
-        auto nt = sep_tiles_.size();
-        admissibility_ = DenseMatrix<bool>(nt, nt);
-        admissibility_.fill(true);
-        for (std::size_t t=0; t<nt; t++)
-          admissibility_(t, t) = false;
-      }
+      } else set_weak_admissibility();
       for (integer_t i=sep_begin_; i<sep_end_; i++)
         sorder[i] += sep_begin_;
     }
+    set_upd_tiles(opts);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::partition_coordinates
+  (const Opts_t& opts, const SpMat_t& A, const DenseMatrix<real_t>& coords,
+   integer_t* sorder, bool is_root, int task_depth) {
+    if (dim_sep()) {
+      sep_tree_ = this->cluster_separator
+        (coords, sorder, opts.BLR_options().leaf_size());
+      sep_tiles_ = sep_tree_.template leaf_sizes<std::size_t>();
+      if (opts.BLR_options().admissibility() == BLR::Admissibility::STRONG) {
+        auto g = A.extract_graph
+          (opts.separator_ordering_level(), sep_begin_, sep_end_);
+        std::vector<integer_t> lorder(dim_sep()), liorder(dim_sep());
+        for (integer_t i=0; i<dim_sep(); i++) {
+          lorder[i] = sorder[sep_begin_+i] - sep_begin_;
+          liorder[lorder[i]] = i;
+        }
+        g.permute(lorder.data(), liorder.data());
+        admissibility_ = g.admissibility(sep_tiles_);
+      } else set_weak_admissibility();
+    }
+    set_upd_tiles(opts);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::write_partition(std::ostream& os) const {
+    if (!dim_sep()) return;
+    this->write_cluster_tree(os, sep_tree_);
+    std::vector<char> adm(admissibility_.rows()*admissibility_.cols());
+    for (std::size_t j=0, k=0; j<admissibility_.cols(); j++)
+      for (std::size_t i=0; i<admissibility_.rows(); i++)
+        adm[k++] = admissibility_(i, j);
+    write_binary(os, adm);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::read_partition
+  (const Opts_t& opts, std::istream& is, bool is_root) {
+    if (dim_sep()) {
+      sep_tree_ = this->read_cluster_tree(is, dim_sep());
+      sep_tiles_ = sep_tree_.template leaf_sizes<std::size_t>();
+      auto nt = sep_tiles_.size();
+      std::vector<char> adm;
+      read_binary(is, adm);
+      if (adm.size() != nt*nt)
+        throw std::runtime_error("invalid BLR admissibility");
+      admissibility_ = DenseMatrix<bool>(nt, nt);
+      for (std::size_t j=0, k=0; j<nt; j++)
+        for (std::size_t i=0; i<nt; i++)
+          admissibility_(i, j) = adm[k++];
+    }
+    set_upd_tiles(opts);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::set_weak_admissibility() {
+    auto nt = sep_tiles_.size();
+    admissibility_ = DenseMatrix<bool>(nt, nt);
+    admissibility_.fill(true);
+    for (std::size_t t=0; t<nt; t++)
+      admissibility_(t, t) = false;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::set_upd_tiles(const Opts_t& opts) {
     if (dim_upd()) {
       auto leaf = opts.BLR_options().leaf_size();
       auto nt = std::ceil(float(dim_upd()) / leaf);
@@ -665,6 +752,14 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::cluster_CB_node
+  (const Opts_t& opts, const std::vector<const F_t*>& ancestors) {
+    upd_tiles_ = this->CB_cluster_tree
+      (ancestors, opts.BLR_options().leaf_size()).
+      template leaf_sizes<std::size_t>();
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontBLR<scalar_t,integer_t>::draw_node
   (std::ostream& of, bool is_root) const {
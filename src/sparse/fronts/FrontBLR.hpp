@@ -42,6 +42,7 @@ namespace strumpack {
     using DenseMW_t = DenseMatrixWrapper<scalar_t>;
     using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
     using Opts_t = SPOptions<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
     using F_t = Front<scalar_t,integer_t>;
     using BLRM_t = BLR::BLRMatrix<scalar_t>;
 #if defined(STRUMPACK_USE_MPI)
@@ -114,6 +115,13 @@ namespace strumpack {
 
     void partition(const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
                    bool is_root=true, int task_depth=0) override;
+    void partition_coordinates(const Opts_t& opts, const SpMat_t& A,
+                               const DenseMatrix<real_t>& coords,
+                               integer_t* sorder, bool is_root=true,
+                               int task_depth=0) override;
+    void write_partition(std::ostream& os) const override;
+    void read_partition(const Opts_t& opts, std::istream& is,
+                        bool is_root) override;
 
   private:
     BLRM_t F11blr_, F12blr_, F21blr_, F22blr_;
@@ -123,8 +131,17 @@ namespace strumpack {
 #endif
     std::vector<scalar_t,NoInit<scalar_t>> CBstorage_;
     std::vector<std::size_t> sep_tiles_, upd_tiles_;
+    structured::ClusterTree sep_tree_;
     DenseMatrix<bool> admissibility_;
 
+    const structured::ClusterTree* sep_cluster_tree() const override {
+      return &sep_tree_;
+    }
+    void cluster_CB_node(const Opts_t& opts,
+                         const std::vector<const F_t*>& ancestors) override;
+    void set_weak_admissibility();
+    void set_upd_tiles(const Opts_t& opts);
+
     FrontBLR(const FrontBLR&) = delete;
     FrontBLR& operator=(FrontBLR const&) = delete;
 
@@ -139,6 +156,9 @@ namespace strumpack {
 
     virtual ReturnCode node_subnormals(std::size_t& ns,
                                        std::size_t& nz) const override;
+    virtual ReturnCode node_selected_inverse(const DenseM_t& Zuu,
+                                             DenseM_t& Z,
+                                             int task_depth) const override;
 
     using F_t::lchild_;
     using F_t::rchild_;
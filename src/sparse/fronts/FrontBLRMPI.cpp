@@ -54,6 +54,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontBLRMPI<scalar_t,integer_t>::extend_add() {
     if (!lchild_ && !rchild_) return;
+    TRACE_FRONT("extend_add");
     std::vector<std::vector<scalar_t>> sbuf(this->P());
     for (auto& ch : {lchild_.get(), rchild_.get()}) {
       if (ch && Comm().is_root()) {
@@ -161,6 +162,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontBLRMPI<scalar_t,integer_t>::build_front
   (const SpMat_t& A) {
+    TRACE_FRONT("assemble");
     const auto dupd = dim_upd();
     const auto dsep = dim_sep();
     if (dsep) {
@@ -247,6 +249,8 @@ namespace strumpack {
     // TODO use the existing workspace
     // now this is cleared to save space
     workspace.clear();
+    TRACE_FRONT("factor_blr");
+    FrontFactorStats fs(params::FrontType::BLR, Comm().is_root());
     TaskTimer t("FrontBLRMPI_factor");
     if (opts.print_compressed_front_stats()) t.start();
     if (opts.BLR_options().BLR_factor_algorithm() ==
@@ -388,6 +392,7 @@ namespace strumpack {
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
     if (dim_sep()) {
+      TRACE_FRONT("fwd_solve");
       TIMER_TIME(TaskType::SOLVE_LOWER, 0, t_s);
       std::vector<std::size_t> col_tiles(1, b.cols());
       auto b_blr = BLRMPI_t::from_ScaLAPACK
@@ -417,6 +422,7 @@ namespace strumpack {
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
     if (dim_sep()) {
+      TRACE_FRONT("bwd_solve");
       TIMER_TIME(TaskType::SOLVE_UPPER, 0, t_s);
       std::vector<std::size_t> col_tiles(1, y.cols());
       auto y_blr = BLRMPI_t::from_ScaLAPACK
@@ -28,6 +28,7 @@
  */
 
 #include "FrontDense.hpp"
+#include "PanelSolve.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontMPI.hpp"
@@ -102,6 +103,17 @@ namespace strumpack {
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::node_selected_inverse
+  (const DenseM_t& Zuu, DenseM_t& Z, int task_depth) const {
+    // the factors are not stored as dense matrices, for instance when
+    // compressed by one of the derived classes
+    if (F11_.rows() != std::size_t(dim_sep()))
+      return ReturnCode::NOT_SUPPORTED;
+    factors_selected_inverse(F11_, F12_, F21_, piv_, Zuu, Z, task_depth);
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontDense<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
@@ -195,15 +207,38 @@ namespace strumpack {
 #pragma omp single nowait
       {
         e1 = factor_phase1(A, opts, workspace, etree_level, task_depth+1);
+        FrontFactorStats fs(front_type());
         e2 = factor_phase2(A, opts, etree_level, task_depth);
       }
     } else {
       e1 = factor_phase1(A, opts, workspace, etree_level, task_depth);
+      FrontFactorStats fs(front_type());
       e2 = factor_phase2(A, opts, etree_level, task_depth);
     }
     return (e1 == ReturnCode::SUCCESS) ? e2 : e1;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::partial_factorization
+  (const SpMat_t& A, const Opts_t& opts) {
+    VectorPool<scalar_t> workspace;
+    ReturnCode e;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    e = factor_phase1(A, opts, workspace, 0, 1);
+    return e;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::factor_node
+  (const SpMat_t& A, const Opts_t& opts) {
+    ReturnCode e;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    e = factor_phase2(A, opts, 0, 0);
+    return e;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontDense<scalar_t,integer_t>::factor_phase1
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
@@ -227,36 +262,136 @@ namespace strumpack {
         er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
     }
     ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
+    // the front itself is counted with the factorization, in factor
+    FrontFactorStats fs(front_type(), false);
     // TODO can we allocate the memory in one go??
     const auto dsep = dim_sep();
     const auto dupd = dim_upd();
-    F11_ = DenseM_t(dsep, dsep); F11_.zero();
-    F12_ = DenseM_t(dsep, dupd); F12_.zero();
-    F21_ = DenseM_t(dupd, dsep); F21_.zero();
-    A.extract_front
-      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
-       this->upd_, task_depth);
-    if (dupd) {
-      CBstorage_ = workspace.get(std::size_t(dupd)*dupd);
-      F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
-      F22_.zero();
+    // F22_ is built in the CB storage of this child, if any
+    auto ich = (dupd && opts.inplace_assembly()) ? inplace_child() : nullptr;
+    {
+      TRACE_FRONT("assemble");
+      F11_ = DenseM_t(dsep, dsep); F11_.zero();
+      F12_ = DenseM_t(dsep, dupd); F12_.zero();
+      F21_ = DenseM_t(dupd, dsep); F21_.zero();
+      A.extract_front
+        (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+         this->upd_, task_depth);
+      if (dupd && !ich) {
+        CBstorage_ = workspace.get(std::size_t(dupd)*dupd);
+        F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
+        F22_.zero();
+      }
+    }
+    {
+      TRACE_FRONT("extend_add");
+      if (ich) extend_add_inplace(*ich);
+      if (lchild_ && lchild_.get() != ich)
+        lchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, workspace, task_depth);
+      if (rchild_ && rchild_.get() != ich)
+        rchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, workspace, task_depth);
     }
-    if (lchild_)
-      lchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, workspace, task_depth);
-    if (rchild_)
-      rchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, workspace, task_depth);
     if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
     return err_code;
   }
 
+  template<typename scalar_t,typename integer_t>
+  FrontDense<scalar_t,integer_t>*
+  FrontDense<scalar_t,integer_t>::inplace_child() const {
+    FrontDense* ich = nullptr;
+    for (auto& ch : {lchild_.get(), rchild_.get()}) {
+      auto c = dynamic_cast<FrontDense*>(ch);
+      if (c && c->dim_upd() && c->F22_.data() == c->CBstorage_.data() &&
+          (!ich || c->dim_upd() > ich->dim_upd()))
+        ich = c;
+    }
+    return ich;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::extend_add_inplace(FrontDense& ch) {
+    const std::size_t pdsep = dim_sep(), pdupd = dim_upd(),
+      dupd = ch.dim_upd();
+    typename F_t::ParentMap tmp;
+    const auto& M = ch.parent_map(this, tmp);
+    const auto& I = M.I;
+    const std::size_t u2s = M.upd2sep, m = dupd - u2s;
+    // first add the parts of the child CB that map to F11, F12 and
+    // F21, these get overwritten below
+    const auto& CB = ch.F22_;
+    for (std::size_t c=0; c<dupd; c++) {
+      auto pc = I[c];
+      if (pc < pdsep) {
+        for (std::size_t r=0; r<u2s; r++)
+          F11_(I[r],pc) += CB(r,c);
+        for (std::size_t r=u2s; r<dupd; r++)
+          F21_(I[r]-pdsep,pc) += CB(r,c);
+      } else
+        for (std::size_t r=0; r<u2s; r++)
+          F12_(I[r],pc-pdsep) += CB(r,c);
+    }
+    CBstorage_ = std::move(ch.CBstorage_);
+    ch.F22_.clear();
+    // Compact the m x m trailing part of the child CB to the start
+    // of the buffer (leading dimension m). Every element moves to a
+    // lower (or the same) address, so this is done front to back.
+    auto d = CBstorage_.data();
+    for (std::size_t j=0; j<m; j++)
+      for (std::size_t i=0; i<m; i++)
+        d[i+j*m] = d[u2s+i+(u2s+j)*dupd];
+    const std::size_t os = CBstorage_.size(), ns = pdupd*pdupd;
+    if (ns > CBstorage_.capacity())
+      CBstorage_.resize(m*m); // avoid copying the stale part
+    CBstorage_.resize(ns);
+    if (ns > os) {
+      STRUMPACK_ADD_MEMORY((ns-os)*sizeof(scalar_t));
+    } else {
+      STRUMPACK_SUB_MEMORY((os-ns)*sizeof(scalar_t));
+    }
+    // Scatter to F22_, with leading dimension pdupd, and zero all
+    // other entries. Element (i,j) moves to (I[u2s+i]-pdsep,
+    // I[u2s+j]-pdsep), with I[u2s+i]-pdsep >= i, which is a higher
+    // (or the same) address, so this is done back to front.
+    d = CBstorage_.data();
+    std::size_t j = m;
+    for (std::size_t pc=pdupd; pc-- > 0; ) {
+      auto dc = d + pc*pdupd;
+      if (j > 0 && I[u2s+j-1]-pdsep == pc) {
+        j--;
+        std::size_t i = m;
+        for (std::size_t pr=pdupd; pr-- > 0; ) {
+          if (i > 0 && I[u2s+i-1]-pdsep == pr) {
+            i--;
+            dc[pr] = d[i+j*m];
+          } else dc[pr] = scalar_t(0.);
+        }
+      } else std::fill(dc, dc+pdupd, scalar_t(0.));
+    }
+    F22_ = DenseMW_t(pdupd, pdupd, d, pdupd);
+    STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+    STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontDense<scalar_t,integer_t>::factor_phase2
   (const SpMat_t& A, const Opts_t& opts,
    int etree_level, int task_depth) {
+    TRACE_FRONT("factor_dense");
     ReturnCode err_code = ReturnCode::SUCCESS;
-    if (dim_sep()) {
+#if defined(_OPENMP) && defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+    const int nb = opts.dense_tile_size();
+    bool tiled = nb > 0 && dim_sep() > integer_t(nb) &&
+      task_depth < params::task_recursion_cutoff_level &&
+      omp_in_parallel();
+#else
+    bool tiled = false;
+#endif
+    if (tiled) {
+      if (factor_tiled(opts))
+        err_code = ReturnCode::ZERO_PIVOT;
+    } else if (dim_sep()) {
       if (F11_.LU(piv_, task_depth))
         err_code = ReturnCode::ZERO_PIVOT;
       if (opts.replace_tiny_pivots()) {
@@ -283,9 +418,135 @@ namespace strumpack {
     return err_code;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  FrontDense<scalar_t,integer_t>::factor_tiled(const Opts_t& opts) {
+    // Right looking LU over column blocks of [F11 F12; F21 F22], with
+    // partial pivoting in the rows of F11. The F11 part of a column
+    // block is a single task (the row interchanges touch all its
+    // rows), the F21/F22 part is split in row tiles. Every task only
+    // waits for the data it needs, so the factorization of panel k+1
+    // can start as soon as column block k+1 is updated, while the
+    // updates of the rest of the front by panel k continue.
+    const std::size_t dsep = dim_sep(), dupd = dim_upd(),
+      nb = opts.dense_tile_size(), nk = (dsep + nb - 1) / nb,
+      nr = (dupd + nb - 1) / nb, nc = nk + nr;
+    // no nested tasks in the tile operations
+    const int depth = params::task_recursion_cutoff_level;
+    const bool replace = opts.replace_tiny_pivots();
+    const auto thresh = opts.pivot_threshold();
+    piv_.resize(dsep);
+    int info = 0;
+    // columns of block j, in F11_ or F12_
+    auto cols = [&](std::size_t j) {
+      return (j < nk) ? std::min(nb, dsep-j*nb) :
+        std::min(nb, dupd-(j-nk)*nb);
+    };
+    // rows [r0, r0+m) of the F11_/F12_ part of column block j
+    auto top = [&](std::size_t j, std::size_t r0, std::size_t m) {
+      return (j < nk) ? DenseMW_t(m, cols(j), F11_, r0, j*nb) :
+        DenseMW_t(m, cols(j), F12_, r0, (j-nk)*nb);
+    };
+    // row tile i of the F21_/F22_ part of column block j
+    auto bot = [&](std::size_t i, std::size_t j) {
+      auto m = std::min(nb, dupd-i*nb);
+      return (j < nk) ? DenseMW_t(m, cols(j), F21_, i*nb, j*nb) :
+        DenseMW_t(m, cols(j), F22_, i*nb, (j-nk)*nb);
+    };
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+    // dummies for task synchronization: C for the F11_/F12_ part of
+    // column blocks, U for the rows of a column block finished by
+    // panel k, T for the F21_/F22_ tiles
+    std::unique_ptr<int[]> C_(new int[nc + nk*nc + nr*nc]);
+    auto C = C_.get(), U = C + nc, T = U + nk*nc;
+#pragma omp taskgroup
+#else
+    int *C = nullptr, *U = nullptr, *T = nullptr;
+#endif
+    {
+      for (std::size_t k=0; k<nk; k++) {
+        const std::size_t kb = k*nb, bk = cols(k);
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(k,kb,bk)  \
+  depend(inout:C[k]) priority(nc)
+#endif
+        {
+          auto P = top(k, kb, dsep-kb);
+          int pinfo = blas::getrf
+            (P.rows(), P.cols(), P.data(), P.ld(), piv_.data()+kb);
+          if (pinfo && !info) info = pinfo + kb;
+          if (replace)
+            for (std::size_t i=0; i<bk; i++)
+              if (std::abs(P(i,i)) < thresh)
+                P(i,i) = (std::real(P(i,i)) < 0) ? -thresh : thresh;
+        }
+        for (std::size_t i=0; i<nr; i++) {
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+          [[maybe_unused]] std::size_t ik = i+nr*k;
+#pragma omp task default(shared) firstprivate(i,k,kb,bk,ik)     \
+  depend(in:C[k]) depend(inout:T[ik]) priority(nc-k)
+#endif
+          {
+            auto B = bot(i, k);
+            trsm(Side::R, UpLo::U, Trans::N, Diag::N, scalar_t(1.),
+                 top(k, kb, bk), B, depth);
+          }
+        }
+        for (std::size_t j=k+1; j<nc; j++) {
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+          [[maybe_unused]] std::size_t kj = k*nc+j;
+#pragma omp task default(shared) firstprivate(j,k,kb,bk,kj)     \
+  depend(in:C[k]) depend(inout:C[j]) depend(out:U[kj]) priority(nc-j)
+#endif
+          {
+            auto A = top(j, kb, dsep-kb);
+            blas::laswp(A.cols(), A.data(), A.ld(), 1, bk,
+                        piv_.data()+kb, 1);
+            auto Akj = top(j, kb, bk);
+            trsm(Side::L, UpLo::L, Trans::N, Diag::U, scalar_t(1.),
+                 top(k, kb, bk), Akj, depth);
+            if (dsep > kb+bk) {
+              auto A2 = top(j, kb+bk, dsep-kb-bk);
+              gemm(Trans::N, Trans::N, scalar_t(-1.),
+                   top(k, kb+bk, dsep-kb-bk), Akj, scalar_t(1.), A2, depth);
+            }
+          }
+          for (std::size_t i=0; i<nr; i++) {
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+            [[maybe_unused]] std::size_t kj = k*nc+j, ik = i+nr*k,
+              ij = i+nr*j;
+#pragma omp task default(shared) firstprivate(i,j,k,kb,bk,kj,ik,ij) \
+  depend(in:U[kj],T[ik]) depend(inout:T[ij]) priority(nc-j)
+#endif
+            {
+              auto B = bot(i, j);
+              gemm(Trans::N, Trans::N, scalar_t(-1.), bot(i, k),
+                   top(j, kb, bk), scalar_t(1.), B, depth);
+            }
+          }
+        }
+      }
+    }
+    // apply the row interchanges of each panel to the columns left
+    // of it, and make the pivots relative to the start of F11_
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+    for (std::size_t j=0; j<nk; j++)
+      for (std::size_t k=j+1; k<nk; k++) {
+        auto A = top(j, k*nb, dsep-k*nb);
+        blas::laswp(A.cols(), A.data(), A.ld(), 1, cols(k),
+                    piv_.data()+k*nb, 1);
+      }
+    for (std::size_t k=1; k<nk; k++)
+      for (std::size_t i=k*nb; i<k*nb+cols(k); i++)
+        piv_[i] += k*nb;
+    return info;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontDense<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("fwd_solve");
     if (dim_sep()) {
       DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
       bloc.laswp(piv_, true);
@@ -307,6 +568,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontDense<scalar_t,integer_t>::bwd_solve_phase1
   (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("bwd_solve");
     if (dim_sep()) {
       DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
       if (y.cols() == 1) {
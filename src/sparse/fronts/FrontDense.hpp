@@ -101,6 +101,19 @@ namespace strumpack {
                               VectorPool<scalar_t>& workspace,
                               int etree_level=0, int task_depth=0) override;
 
+    /**
+     * Factor all descendants of this (root) front, and assemble
+     * this front, but do not factor it. F11() is then the Schur
+     * complement of the separator of this front, with respect to all
+     * other unknowns. Use factor_node to complete the factorization.
+     */
+    ReturnCode partial_factorization(const SpMat_t& A, const Opts_t& opts);
+    /**
+     * Factor this front, after partial_factorization.
+     */
+    ReturnCode factor_node(const SpMat_t& A, const Opts_t& opts);
+    const DenseM_t& F11() const { return F11_; }
+
     void
     extract_CB_sub_matrix(const std::vector<std::size_t>& I,
                           const std::vector<std::size_t>& J,
@@ -141,8 +154,24 @@ namespace strumpack {
     ReturnCode factor_phase1(const SpMat_t& A, const Opts_t& opts,
                              VectorPool<scalar_t>& workspace,
                              int etree_level, int task_depth);
-    ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
-                             int etree_level, int task_depth);
+    virtual ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
+                                     int etree_level, int task_depth);
+
+    // type of this front in SolverStatistics::factor_fronts
+    virtual params::FrontType front_type() const
+    { return params::FrontType::DENSE; }
+
+    // task based LU of F11_ (using tiles of size
+    // opts.dense_tile_size()), the solves for F12_ and F21_ and the
+    // Schur complement update of F22_, returns LAPACK getrf info
+    int factor_tiled(const Opts_t& opts);
+
+    // child with the largest dense contribution block, which can be
+    // reused as storage for F22_, or nullptr
+    FrontDense* inplace_child() const;
+    // take over the CB storage of child ch for F22_ and assemble the
+    // CB of ch in it, in place. F11_, F12_ and F21_ must be allocated
+    void extend_add_inplace(FrontDense& ch);
 
     virtual void
     fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd, int etree_level,
@@ -162,6 +191,9 @@ namespace strumpack {
                                        std::size_t& nz) const override;
     virtual ReturnCode node_pivot_growth(scalar_t& pgL,
                                          scalar_t& pgU) const override;
+    virtual ReturnCode node_selected_inverse(const DenseM_t& Zuu,
+                                             DenseM_t& Z,
+                                             int task_depth) const override;
 
     using F_t::lchild_;
     using F_t::rchild_;
@@ -89,41 +89,74 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> long long
   FrontDenseMPI<scalar_t,integer_t>::node_factor_nonzeros() const {
+    if (lossless_)
+      return (F11l_.compressed_size() + F12l_.compressed_size() +
+              F21l_.compressed_size()) / sizeof(scalar_t);
 #if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_)
       return (F11c_.compressed_size() + F12c_.compressed_size() +
               F21c_.compressed_size()) / sizeof(scalar_t);
-    else
 #endif
-      return FMPI_t::node_factor_nonzeros();
+    return FMPI_t::node_factor_nonzeros();
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::extend_add() {
+    std::vector<std::vector<scalar_t>> sbuf;
+    std::vector<MPIRequest> sreq;
+    extend_add_isend(sbuf, sreq);
+    extend_add_recv();
+    wait_all(sreq);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseMPI<scalar_t,integer_t>::extend_add_isend
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   std::vector<MPIRequest>& sreq) const {
+    if (!visit(lchild_) && !visit(rchild_)) return;
+    sbuf.resize(this->P());
+    for (auto& ch : {lchild_.get(), rchild_.get()})
+      if (visit(ch))
+        ch->extend_add_copy_to_buffers(sbuf, this);
+    // one message to every rank, even if empty, so the receiver
+    // knows how many messages to expect
+    sreq.reserve(this->P());
+    for (int p=0; p<this->P(); p++)
+      sreq.emplace_back(Comm().isend(sbuf[p], p, extend_add_tag_));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseMPI<scalar_t,integer_t>::extend_add_recv() {
     if (!lchild_ && !rchild_) return;
-    std::vector<std::vector<scalar_t>> sbuf(this->P());
-    for (auto& ch : {lchild_.get(), rchild_.get()}) {
-      if (ch) {
-        STRUMPACK_FLOPS
-          (static_cast<long long int>(ch->dim_upd())*ch->dim_upd()/
-           grid()->npactives());
-      }
-      if (!visit(ch)) continue;
-      ch->extend_add_copy_to_buffers(sbuf, this);
-    }
-    std::vector<scalar_t,NoInit<scalar_t>> rbuf;
-    std::vector<scalar_t*> pbuf;
-    Comm().all_to_all_v(sbuf, rbuf, pbuf);
+    TRACE_FRONT("extend_add");
+    std::vector<char> sender(this->P(), 0);
     for (auto& ch : {lchild_.get(), rchild_.get()}) {
       if (!ch) continue;
-      ch->extend_add_copy_from_buffers
-        (F11_, F12_, F21_, F22_, pbuf.data()+this->master(ch), this);
+      STRUMPACK_FLOPS
+        (static_cast<long long int>(ch->dim_upd())*ch->dim_upd()/
+         grid()->npactives());
+      std::fill_n(sender.begin()+this->master(ch), ch->P(), 1);
+    }
+    // assemble the messages in the order in which they arrive
+    std::vector<scalar_t*> pbuf(this->P());
+    for (int i=std::count(sender.begin(), sender.end(), 1); i>0; i--) {
+      auto msg = Comm().template recv_any_src<scalar_t>(extend_add_tag_);
+      auto p = msg.first;
+      pbuf[p] = msg.second.data();
+      for (auto& ch : {lchild_.get(), rchild_.get()}) {
+        if (!ch) continue;
+        auto m = this->master(ch);
+        if (p < m || p >= m + ch->P()) continue;
+        ch->extend_add_copy_from_buffers
+          (F11_, F12_, F21_, F22_, pbuf.data()+m, this, p-m);
+      }
     }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::build_front
   (const SpMat_t& A) {
+    TRACE_FRONT("assemble");
     const auto dupd = this->dim_upd();
     const auto dsep = this->dim_sep();
     if (dsep) {
@@ -143,7 +176,6 @@ namespace strumpack {
       F22_ = DistM_t(grid(), dupd, dupd);
       F22_.zero();
     }
-    extend_add();
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -152,6 +184,7 @@ namespace strumpack {
     ReturnCode err_code = ReturnCode::SUCCESS;
     if (!this->dim_sep() || !grid()->active())
       return err_code;
+    TRACE_FRONT("factor_dense");
     TaskTimer pf("FrontDenseMPI_factor");
     pf.start();
 #if defined(STRUMPACK_USE_SLATE_SCALAPACK)
@@ -247,7 +280,18 @@ namespace strumpack {
         (A, opts, etree_level+1, task_depth);
       if (er != ReturnCode::SUCCESS) err_code = er;
     }
+    FrontFactorStats fs(front_type(opts), Comm().is_root());
+    // Send the contribution block(s) as soon as they are ready,
+    // without waiting for the other child. Assemble the original
+    // matrix entries while the messages are in flight, then add the
+    // contribution blocks as they arrive.
+    std::vector<std::vector<scalar_t>> sbuf;
+    std::vector<MPIRequest> sreq;
+    extend_add_isend(sbuf, sreq);
     build_front(A);
+    extend_add_recv();
+    wait_all(sreq);
+    std::vector<std::vector<scalar_t>>().swap(sbuf);
     if (etree_level == 0 && opts.write_root_front()) {
       auto Fs = F11_.gather();
       std::string fname = is_complex<scalar_t>() ?
@@ -264,52 +308,85 @@ namespace strumpack {
     if (rchild_) rchild_->release_work_memory();
     auto ef = partial_factorization(opts);
     if (ef != ReturnCode::SUCCESS) err_code = ef;
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     compress(opts);
-#endif
     return err_code;
   }
 
+  template<typename scalar_t,typename integer_t> params::FrontType
+  FrontDenseMPI<scalar_t,integer_t>::front_type
+  (const SPOptions<scalar_t>& opts) const {
+    switch (opts.compression()) {
+    case CompressionType::LOSSLESS: return params::FrontType::LOSSLESS;
 #if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
+    case CompressionType::LOSSY:
+    case CompressionType::ZFP_BLR_HODLR: return params::FrontType::LOSSY;
+#endif
+    default: return params::FrontType::DENSE;
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::compress
   (const SPOptions<scalar_t>& opts) {
-    if (opts.compression() == CompressionType::LOSSY ||
-        opts.compression() == CompressionType::LOSSLESS ||
-        opts.compression() == CompressionType::ZFP_BLR_HODLR) {
+    compressed_ = lossless_ = false;
+    if (opts.compression() == CompressionType::LOSSLESS) {
+      // same codec as FrontLossless, applied to the local blocks of
+      // the 2D block-cyclic factors, does not require ZFP
+      F11l_ = LosslessMatrix<scalar_t>(F11_.dense_wrapper());
+      F12l_ = LosslessMatrix<scalar_t>(F12_.dense_wrapper());
+      F21l_ = LosslessMatrix<scalar_t>(F21_.dense_wrapper());
+      lossless_ = true;
+    }
+#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
+    else if (opts.compression() == CompressionType::LOSSY ||
+             opts.compression() == CompressionType::ZFP_BLR_HODLR) {
       auto prec = opts.lossy_precision();
       auto acc = opts.lossy_accuracy();
       F11c_ = LossyMatrix<scalar_t>(F11_.dense_wrapper(), prec, acc);
       F12c_ = LossyMatrix<scalar_t>(F12_.dense_wrapper(), prec, acc);
       F21c_ = LossyMatrix<scalar_t>(F21_.dense_wrapper(), prec, acc);
-      F11_.clear();
-      F12_.clear();
-      F21_.clear();
-      compressed_ = true;
     }
+#endif
+    else return;
+    F11_.clear();
+    F12_.clear();
+    F21_.clear();
+    compressed_ = true;
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::decompress
-  (DistM_t& F11, DistM_t& F12, DistM_t& F21) const {
-    if (this->dim_sep()) {
-      auto wF11 = F11.dense_wrapper();
-      F11c_.decompress(wF11);
-      if (this->dim_upd()) {
+  (DistM_t& F11, DistM_t& F12, DistM_t& F21, bool only_F11) const {
+    if (!this->dim_sep()) return;
+    auto wF11 = F11.dense_wrapper();
+    bool upd = this->dim_upd() && !only_F11;
+    if (lossless_) {
+      F11l_.decompress(wF11);
+      if (upd) {
         auto wF12 = F12.dense_wrapper();
-        F12c_.decompress(wF12);
+        F12l_.decompress(wF12);
         auto wF21 = F21.dense_wrapper();
-        F21c_.decompress(wF21);
+        F21l_.decompress(wF21);
       }
+      return;
+    }
+#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
+    F11c_.decompress(wF11);
+    if (upd) {
+      auto wF12 = F12.dense_wrapper();
+      F12c_.decompress(wF12);
+      auto wF21 = F21.dense_wrapper();
+      F21c_.decompress(wF21);
     }
-  }
 #endif
+  }
 
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::fwd_solve_phase2
   (const DistM_t& F11, const DistM_t& F12, const DistM_t& F21,
    DistM_t& b, DistM_t& bupd) const {
     if (!grid()->active()) return;
+    TRACE_FRONT("fwd_solve");
     TIMER_TIME(TaskType::SOLVE_LOWER, 0, t_s);
 #if defined(STRUMPACK_USE_SLATE_SCALAPACK)
     if (this->dim_sep()) {
@@ -365,7 +442,6 @@ namespace strumpack {
     bupd = DistM_t(grid(), this->dim_upd(), b.cols());
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
       const auto dupd = this->dim_upd();
       const auto dsep = this->dim_sep();
@@ -374,7 +450,6 @@ namespace strumpack {
       decompress(F11, F12, F21);
       fwd_solve_phase2(F11, F12, F21, b, bupd);
     } else
-#endif
       fwd_solve_phase2(F11_, F12_, F21_, b, bupd);
   }
 
@@ -383,6 +458,7 @@ namespace strumpack {
   (const DistM_t& F11, const DistM_t& F12, const DistM_t& F21,
    DistM_t& y, DistM_t& yupd) const {
     if (!grid()->active()) return;
+    TRACE_FRONT("bwd_solve");
 #if defined(STRUMPACK_USE_SLATE_SCALAPACK) // && (SLATE_VERSION > 20220700)
     if (this->dim_sep()) {
       if (this->dim_upd()) {
@@ -421,7 +497,6 @@ namespace strumpack {
   (DenseM_t& yloc, DistM_t* ydist, DistM_t& yupd, DenseM_t&,
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
       const auto dupd = this->dim_upd();
       const auto dsep = this->dim_sep();
@@ -430,7 +505,6 @@ namespace strumpack {
       decompress(F11, F12, F21);
       bwd_solve_phase1(F11, F12, F21, y, yupd);
     } else
-#endif
       bwd_solve_phase1(F11_, F12_, F21_, y, yupd);
     DistM_t CBl, CBr;
     DenseM_t seqCBl, seqCBr;
@@ -514,6 +588,10 @@ namespace strumpack {
     F12_ = DistM_t();
     F21_ = DistM_t();
     F22_ = DistM_t();
+    F11l_ = LosslessMatrix<scalar_t>();
+    F12l_ = LosslessMatrix<scalar_t>();
+    F21l_ = LosslessMatrix<scalar_t>();
+    compressed_ = lossless_ = false;
     piv = std::vector<int>();
   }
 
@@ -543,14 +621,11 @@ namespace strumpack {
   (integer_t& neg, integer_t& zero, integer_t& pos) const {
     if (!this->dim_sep() || !grid()->active())
       return ReturnCode::SUCCESS;
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
-      DistM_t F11(grid(), this->dim_sep(), this->dim_sep());
-      auto f = F11.dense_wrapper();
-      F11c_.decompress(f);
+      DistM_t F11(grid(), this->dim_sep(), this->dim_sep()), F12, F21;
+      decompress(F11, F12, F21, true);
       return matrix_inertia(F11, neg, zero, pos);
     }
-#endif
     return matrix_inertia(F11_, neg, zero, pos);
   }
 
@@ -560,28 +635,17 @@ namespace strumpack {
     const auto dsep = this->dim_sep();
     if (!dsep || !grid()->active())
       return ReturnCode::SUCCESS;
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
-      if (dsep) {
-        DistM_t F11(grid(), dsep, dsep);
-        auto wF11 = F11.dense_wrapper();
-        F11c_.decompress(wF11);
-        ns += wF11.subnormals();
-        nz += wF11.zeros();
-        const auto dupd = this->dim_upd();
-        if (dupd) {
-          DistM_t F12(grid(), dsep, dupd), F21(grid(), dupd, dsep);
-          auto wF12 = F12.dense_wrapper();
-          auto wF21 = F21.dense_wrapper();
-          F12c_.decompress(wF12);
-          F21c_.decompress(wF21);
-          ns += wF12.subnormals() + wF21.subnormals();
-          nz += wF12.zeros() + wF21.zeros();
-        }
-      }
+      const auto dupd = this->dim_upd();
+      DistM_t F11(grid(), dsep, dsep), F12(grid(), dsep, dupd),
+        F21(grid(), dupd, dsep);
+      decompress(F11, F12, F21);
+      ns += F11.dense_wrapper().subnormals() +
+        F12.dense_wrapper().subnormals() + F21.dense_wrapper().subnormals();
+      nz += F11.dense_wrapper().zeros() +
+        F12.dense_wrapper().zeros() + F21.dense_wrapper().zeros();
       return ReturnCode::SUCCESS;
     }
-#endif
     ns += F11_.subnormals() + F12_.subnormals() + F21_.subnormals();
     nz += F11_.zeros() + F12_.zeros() + F21_.zeros();
     return ReturnCode::SUCCESS;
@@ -30,6 +30,7 @@
 #define FRONTAL_MATRIX_DENSE_MPI_HPP
 
 #include "FrontMPI.hpp"
+#include "FrontLossless.hpp"
 #if defined(STRUMPACK_USE_ZFP)
 #include "FrontLossy.hpp"
 #endif
@@ -68,6 +69,10 @@ namespace strumpack {
 
     void release_work_memory() override;
 
+    /**
+     * Blocking extend-add, same as extend_add_isend followed by
+     * extend_add_recv.
+     */
     void extend_add();
     void
     extend_add_copy_to_buffers(std::vector<std::vector<scalar_t>>& sbuf,
@@ -130,6 +135,21 @@ namespace strumpack {
     void build_front(const SpMat_t& A);
     ReturnCode partial_factorization(const SPOptions<scalar_t>& opts);
 
+    static const int extend_add_tag_ = 3;
+    /*
+     * Pack the contribution blocks of the children visited by this
+     * rank, and post nonblocking sends to all ranks of this front. The
+     * send buffers and requests should be kept until the sends are
+     * completed, with wait_all(sreq).
+     */
+    void extend_add_isend(std::vector<std::vector<scalar_t>>& sbuf,
+                          std::vector<MPIRequest>& sreq) const;
+    /*
+     * Receive the contribution blocks from all ranks of the children
+     * and add them to this front, in the order in which they arrive.
+     */
+    void extend_add_recv();
+
     void fwd_solve_phase2(const DistM_t& F11, const DistM_t& F12,
                           const DistM_t& F21,
                           DistM_t& b, DistM_t& bupd) const;
@@ -146,11 +166,17 @@ namespace strumpack {
 
 #if defined(STRUMPACK_USE_ZFP)
     LossyMatrix<scalar_t> F11c_, F12c_, F21c_;
-    bool compressed_ = false;
+#endif
+    // local blocks of the factors, compressed with the built-in
+    // codec, for CompressionType::LOSSLESS
+    LosslessMatrix<scalar_t> F11l_, F12l_, F21l_;
+    bool compressed_ = false, lossless_ = false;
 
     void compress(const SPOptions<scalar_t>& opts);
-    void decompress(DistM_t& F11, DistM_t& F12, DistM_t& F21) const;
-#endif
+    // type of this front in SolverStatistics::factor_fronts
+    params::FrontType front_type(const SPOptions<scalar_t>& opts) const;
+    void decompress(DistM_t& F11, DistM_t& F12, DistM_t& F21,
+                    bool only_F11=false) const;
 
     ReturnCode matrix_inertia(const DistM_t& F,
                               integer_t& neg,
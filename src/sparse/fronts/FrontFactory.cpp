@@ -58,6 +58,9 @@
 #if defined(STRUMPACK_USE_ZFP)
 #include "FrontLossy.hpp"
 #endif
+#include "FrontLossless.hpp"
+#include "FrontMixedPrecision.hpp"
+#include "FrontHalfPrecision.hpp"
 
 namespace strumpack {
 
@@ -131,7 +134,13 @@ namespace strumpack {
       }
 #endif
     } break;
-    case CompressionType::LOSSLESS:
+    case CompressionType::LOSSLESS: {
+      if (is_lossless(dsep, dupd, opts)) {
+        front = std::make_unique<FrontLossless<scalar_t,integer_t>>
+          (s, sbegin, send, upd);
+        if (root) fc.lossless++;
+      }
+    } break;
     case CompressionType::LOSSY: {
 #if defined(STRUMPACK_USE_ZFP)
       if (is_lossy(dsep, dupd, opts)) {
@@ -162,6 +171,18 @@ namespace strumpack {
       if (root && front) fc.dense++;
     }
     if (front) return front;
+    if (is_half_precision(opts)) {
+      front = std::make_unique<FrontHalfPrecision<scalar_t,integer_t>>
+        (s, sbegin, send, upd);
+      if (root) fc.half++;
+      return front;
+    }
+    if (is_mixed_precision(dsep, dupd, level, opts)) {
+      front = std::make_unique<FrontMixedPrecision<scalar_t,integer_t>>
+        (s, sbegin, send, upd);
+      if (root) fc.dense++;
+      return front;
+    }
     // fallback in case support for cublas/zfp/hodlr is missing
     front = std::make_unique<FrontDense<scalar_t,integer_t>>
       (s, sbegin, send, upd);
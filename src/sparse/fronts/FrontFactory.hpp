@@ -30,6 +30,8 @@
 #define FRONT_FACTORY_HPP
 
 #include <array>
+#include <complex>
+#include <type_traits>
 
 #include "StrumpackConfig.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -41,13 +43,18 @@
 namespace strumpack {
 
   struct FrontCounter {
-    int dense, HSS, BLR, HODLR, lossy;
-    FrontCounter() : dense(0), HSS(0), BLR(0), HODLR(0), lossy(0) {}
+    // half: dense fronts with fp16/bfloat16 factor storage
+    int dense, HSS, BLR, HODLR, lossy, lossless, half;
+    FrontCounter() :
+      dense(0), HSS(0), BLR(0), HODLR(0), lossy(0), lossless(0),
+      half(0) {}
     FrontCounter(int* c) :
-      dense(c[0]), HSS(c[1]), BLR(c[2]), HODLR(c[3]), lossy(c[4]) {}
+      dense(c[0]), HSS(c[1]), BLR(c[2]), HODLR(c[3]), lossy(c[4]),
+      lossless(c[5]), half(c[6]) {}
 #if defined(STRUMPACK_USE_MPI)
     FrontCounter reduce(const MPIComm& comm) const {
-      std::array<int,5> w = {dense, HSS, BLR, HODLR, lossy};
+      std::array<int,7> w =
+        {dense, HSS, BLR, HODLR, lossy, lossless, half};
       comm.reduce(w.data(), w.size(), MPI_SUM);
       return FrontCounter(w.data());
     }
@@ -110,11 +117,24 @@ namespace strumpack {
 #endif
   }
 
+  template<typename scalar_t> bool is_half_precision
+  (const SPOptions<scalar_t>& opts) {
+    return opts.factor_storage() != FactorStorage::FULL;
+  }
+
+  template<typename scalar_t> bool is_mixed_precision
+  (int dsep, int dupd, int level, const SPOptions<scalar_t>& opts) {
+    return opts.mixed_precision_fronts() &&
+      (std::is_same<scalar_t,double>::value ||
+       std::is_same<scalar_t,std::complex<double>>::value) &&
+      level >= opts.mixed_precision_level() &&
+      dsep + dupd <= opts.mixed_precision_max_front_size();
+  }
+
   template<typename scalar_t> bool is_lossy
   (int dsep, int dupd, const SPOptions<scalar_t>& opts, int l=0) {
 #if defined(STRUMPACK_USE_ZFP)
     return (opts.compression() == CompressionType::LOSSY ||
-            opts.compression() == CompressionType::LOSSLESS ||
             opts.compression() == CompressionType::ZFP_BLR_HODLR) &&
       (dsep >= opts.compression_min_sep_size(l) ||
        dsep + dupd >= opts.compression_min_front_size(l));
@@ -123,13 +143,21 @@ namespace strumpack {
 #endif
   }
 
+  template<typename scalar_t> bool is_lossless
+  (int dsep, int dupd, const SPOptions<scalar_t>& opts, int l=0) {
+    return opts.compression() == CompressionType::LOSSLESS &&
+      (dsep >= opts.compression_min_sep_size(l) ||
+       dsep + dupd >= opts.compression_min_front_size(l));
+  }
+
   template<typename scalar_t> bool is_compressed
   (int dsep, int dupd, const SPOptions<scalar_t>& opts) {
     return opts.compression() != CompressionType::NONE &&
       (is_HSS(dsep, dupd, opts) ||
        is_BLR(dsep, dupd, opts, 1) ||
        is_HODLR(dsep, dupd, opts) ||
-       is_lossy(dsep, dupd, opts, 2));
+       is_lossy(dsep, dupd, opts, 2) ||
+       is_lossless(dsep, dupd, opts));
   }
 
   // forward definition
@@ -436,6 +436,8 @@ namespace strumpack {
       if (er != ReturnCode::SUCCESS) err_code = er;
     }
     if (!this->dim_blk()) return err_code;
+    TRACE_FRONT("factor_hodlr");
+    FrontFactorStats fs(params::FrontType::HODLR);
     TaskTimer t("");
     if (opts.print_compressed_front_stats()) t.start();
     construct_hierarchy(A, opts, task_depth);
@@ -879,6 +881,7 @@ namespace strumpack {
       rchild_->extend_add_b(b, bupd, CBch, this);
     }
     if (dim_sep()) {
+      TRACE_FRONT("fwd_solve");
       DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
       DenseM_t rhs(bloc);
 #if defined(STRUMPACK_COUNT_FLOPS)
@@ -905,11 +908,29 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLR<scalar_t,integer_t>::forward_sparse_solve
+  (DenseM_t& b, DenseM_t* work, const std::vector<char>& pat,
+   int etree_level, int task_depth) const {
+    // the backward solve uses the forward solve for this front
+    if (pat[this->sep_])
+      forward_multifrontal_solve(b, work, etree_level, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLR<scalar_t,integer_t>::backward_sparse_solve
+  (DenseM_t& y, DenseM_t* work, const std::vector<char>& pat,
+   int etree_level, int task_depth) const {
+    if (pat[this->sep_] & F_t::SOLVE_BWD)
+      backward_multifrontal_solve(y, work, etree_level, task_depth);
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontHODLR<scalar_t,integer_t>::backward_multifrontal_solve
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
     if (dim_sep() && dim_upd()) {
+      TRACE_FRONT("bwd_solve");
       DenseM_t tmp(dim_sep(), y.cols()), tmp2(dim_sep(), y.cols());
 #if defined(STRUMPACK_PERMUTE_CB)
       DenseM_t pyupd(yupd.rows(), yupd.cols());
@@ -992,6 +1013,17 @@ namespace strumpack {
       sorder[i] += sep_begin_;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLR<scalar_t,integer_t>::write_partition(std::ostream& os) const {
+    this->write_cluster_tree(os, sep_tree_);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLR<scalar_t,integer_t>::read_partition
+  (const Opts_t& opts, std::istream& is, bool is_root) {
+    sep_tree_ = this->read_cluster_tree(is, dim_sep());
+  }
+
   // explicit template instantiations
   template class FrontHODLR<float,int>;
   template class FrontHODLR<double,int>;
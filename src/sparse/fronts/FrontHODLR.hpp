@@ -137,6 +137,9 @@ namespace strumpack {
 
     void partition(const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
                    bool is_root=true, int task_depth=0) override;
+    void write_partition(std::ostream& os) const override;
+    void read_partition(const Opts_t& opts, std::istream& is,
+                        bool is_root) override;
 
   private:
     HODLR::HODLRMatrix<scalar_t> F11_;
@@ -158,6 +161,16 @@ namespace strumpack {
     void bwd_solve_node(DenseM_t& y, DenseM_t* work,
                         int etree_level, int task_depth) const;
 
+    // the solve for this front can not be split from the solve for
+    // its descendants, so the full subtree is solved
+    void forward_sparse_solve(DenseM_t& b, DenseM_t* work,
+                              const std::vector<char>& pat,
+                              int etree_level, int task_depth) const override;
+    void backward_sparse_solve(DenseM_t& y, DenseM_t* work,
+                               const std::vector<char>& pat,
+                               int etree_level, int task_depth) const override;
+    bool solve_per_front() const override { return false; }
+
     long long node_factor_nonzeros() const override;
 
     void construct_hierarchy(const SpMat_t& A, const Opts_t& opts,
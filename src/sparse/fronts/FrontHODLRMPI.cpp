@@ -218,6 +218,8 @@ namespace strumpack {
       if (er != ReturnCode::SUCCESS) err_code = er;
     }
     if (!dim_blk()) return err_code;
+    TRACE_FRONT("factor_hodlr");
+    FrontFactorStats fs(params::FrontType::HODLR, Comm().is_root());
     TaskTimer t("FrontHODLRMPI_factor");
     if (opts.print_compressed_front_stats()) t.start();
     construct_hierarchy(A, opts);
@@ -566,6 +568,7 @@ namespace strumpack {
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
     if (this->dim_sep()) {
+      TRACE_FRONT("fwd_solve");
       TIMER_TIME(TaskType::SOLVE_LOWER, 0, t_s);
       DistM_t rhs(b);
 #if defined(STRUMPACK_COUNT_FLOPS)
@@ -598,6 +601,7 @@ namespace strumpack {
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
     if (this->dim_sep() && this->dim_upd()) {
+      TRACE_FRONT("bwd_solve");
       TIMER_TIME(TaskType::SOLVE_UPPER, 0, t_s);
       DistM_t tmp(y.grid(), y.rows(), y.cols()),
         tmp2(y.grid(), y.rows(), y.cols());
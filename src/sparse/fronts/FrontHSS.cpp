@@ -360,6 +360,7 @@ namespace strumpack {
     ReturnCode err_code = ReturnCode::SUCCESS;
     if (el != ReturnCode::SUCCESS) err_code = el;
     if (er != ReturnCode::SUCCESS) err_code = er;
+    FrontFactorStats fs(params::FrontType::HSS);
     TaskTimer t("FrontHSS_factor");
     if (opts.print_compressed_front_stats()) t.start();
     H_.set_openmp_task_depth(task_depth);
@@ -382,10 +383,14 @@ namespace strumpack {
     HSSopts.set_d0(std::max(child_samples - HSSopts.dd(), HSSopts.d0()));
     if (opts.indirect_sampling())
       HSSopts.set_user_defined_random(true);
-    H_.compress(mult, elem, HSSopts);
+    {
+      TRACE_FRONT("compress_hss");
+      H_.compress(mult, elem, HSSopts);
+    }
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
     if (dim_sep()) {
+      TRACE_FRONT("factor_hss");
       if (etree_level > 0) {
         TIMER_TIME(TaskType::HSS_PARTIALLY_FACTOR, 0, t_pfact);
         H_.partial_factor();
@@ -449,6 +454,7 @@ namespace strumpack {
     DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
     bupd.zero();
     this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
+    TRACE_FRONT("fwd_solve");
     if (etree_level) {
       if (Theta_.cols() && Phi_.cols()) {
         DenseMW_t bloc(dim_sep(), b.cols(), b, sep_begin_, 0);
@@ -469,6 +475,23 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::forward_sparse_solve
+  (DenseM_t& b, DenseM_t* work, const std::vector<char>& pat,
+   int etree_level, int task_depth) const {
+    // the backward solve uses the forward solve for this front
+    if (pat[this->sep_])
+      forward_multifrontal_solve(b, work, etree_level, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::backward_sparse_solve
+  (DenseM_t& y, DenseM_t* work, const std::vector<char>& pat,
+   int etree_level, int task_depth) const {
+    if (pat[this->sep_] & F_t::SOLVE_BWD)
+      backward_multifrontal_solve(y, work, etree_level, task_depth);
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontHSS<scalar_t,integer_t>::backward_multifrontal_solve
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
@@ -483,19 +506,22 @@ namespace strumpack {
   FrontHSS<scalar_t,integer_t>::bwd_solve_node
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
-    if (etree_level) {
-      if (Phi_.cols() && Theta_.cols()) {
-        if (dim_upd()) {
-          gemm(Trans::C, Trans::N, scalar_t(-1.), Phi_, yupd,
-               scalar_t(1.), ULVwork_->x, task_depth);
+    {
+      TRACE_FRONT("bwd_solve");
+      if (etree_level) {
+        if (Phi_.cols() && Theta_.cols()) {
+          if (dim_upd()) {
+            gemm(Trans::C, Trans::N, scalar_t(-1.), Phi_, yupd,
+                 scalar_t(1.), ULVwork_->x, task_depth);
+          }
+          DenseMW_t yloc(dim_sep(), y.cols(), y, sep_begin_, 0);
+          H_.child(0)->backward_solve(*ULVwork_, yloc);
+          ULVwork_.reset();
         }
+      } else {
         DenseMW_t yloc(dim_sep(), y.cols(), y, sep_begin_, 0);
-        H_.child(0)->backward_solve(*ULVwork_, yloc);
-        ULVwork_.reset();
+        H_.backward_solve(*ULVwork_, yloc);
       }
-    } else {
-      DenseMW_t yloc(dim_sep(), y.cols(), y, sep_begin_, 0);
-      H_.backward_solve(*ULVwork_, yloc);
     }
     this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
   }
@@ -533,23 +559,66 @@ namespace strumpack {
    integer_t* sorder, bool is_root, int task_depth) {
     auto g = A.extract_graph
       (opts.separator_ordering_level(), sep_begin_, sep_end_);
-    auto sep_tree = g.recursive_bisection
+    sep_tree_ = g.recursive_bisection
       (opts.compression_leaf_size(), 0,
        sorder+sep_begin_, nullptr, 0, 0, dim_sep());
     for (integer_t i=sep_begin_; i<sep_end_; i++)
       sorder[i] += sep_begin_;
+    setup_HSS_tree(opts, is_root);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::partition_coordinates
+  (const Opts_t& opts, const SpMat_t& A, const DenseMatrix<real_t>& coords,
+   integer_t* sorder, bool is_root, int task_depth) {
+    if (dim_sep())
+      sep_tree_ = this->cluster_separator
+        (coords, sorder, opts.compression_leaf_size());
+    setup_HSS_tree(opts, is_root);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::write_partition(std::ostream& os) const {
+    this->write_cluster_tree(os, sep_tree_);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::read_partition
+  (const Opts_t& opts, std::istream& is, bool is_root) {
+    sep_tree_ = this->read_cluster_tree(is, dim_sep());
+    setup_HSS_tree(opts, is_root);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::setup_HSS_tree
+  (const Opts_t& opts, bool is_root) {
     if (is_root)
-      H_ = HSS::HSSMatrix<scalar_t>(sep_tree, opts.HSS_options());
+      H_ = HSS::HSSMatrix<scalar_t>(sep_tree_, opts.HSS_options());
     else {
-      structured::ClusterTree tree(this->dim_blk());
-      tree.c.reserve(2);
-      tree.c.push_back(sep_tree);
-      tree.c.emplace_back(dim_upd());
-      tree.c.back().refine(opts.HSS_options().leaf_size());
-      H_ = HSS::HSSMatrix<scalar_t>(tree, opts.HSS_options());
+      structured::ClusterTree upd_tree(dim_upd());
+      upd_tree.refine(opts.HSS_options().leaf_size());
+      set_HSS_tree(opts, std::move(upd_tree));
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::cluster_CB_node
+  (const Opts_t& opts, const std::vector<const F_t*>& ancestors) {
+    set_HSS_tree
+      (opts, this->CB_cluster_tree
+       (ancestors, opts.HSS_options().leaf_size()));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHSS<scalar_t,integer_t>::set_HSS_tree
+  (const Opts_t& opts, structured::ClusterTree&& upd_tree) {
+    structured::ClusterTree tree(this->dim_blk());
+    tree.c.reserve(2);
+    tree.c.push_back(sep_tree_);
+    tree.c.push_back(std::move(upd_tree));
+    H_ = HSS::HSSMatrix<scalar_t>(tree, opts.HSS_options());
+  }
+
   // explicit template instantiations
   template class FrontHSS<float,int>;
   template class FrontHSS<double,int>;
@@ -45,6 +45,7 @@ namespace strumpack {
     using DenseMW_t = DenseMatrixWrapper<scalar_t>;
     using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
     using Opts_t = SPOptions<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 
   public:
     FrontHSS(integer_t sep, integer_t sep_begin, integer_t sep_end,
@@ -98,6 +99,13 @@ namespace strumpack {
 
     void partition(const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
                    bool is_root=true, int task_depth=0) override;
+    void partition_coordinates(const Opts_t& opts, const SpMat_t& A,
+                               const DenseMatrix<real_t>& coords,
+                               integer_t* sorder, bool is_root=true,
+                               int task_depth=0) override;
+    void write_partition(std::ostream& os) const override;
+    void read_partition(const Opts_t& opts, std::istream& is,
+                        bool is_root) override;
 
 
     // TODO make private?
@@ -121,6 +129,8 @@ namespace strumpack {
     std::uint32_t sampled_columns_ = 0;
 
   private:
+    structured::ClusterTree sep_tree_;
+
     FrontHSS(const FrontHSS&) = delete;
     FrontHSS& operator=(FrontHSS const&) = delete;
 
@@ -136,8 +146,27 @@ namespace strumpack {
     void bwd_solve_node(DenseM_t& y, DenseM_t* work,
                         int etree_level, int task_depth) const;
 
+    // the solve for this front can not be split from the solve for
+    // its descendants, so the full subtree is solved
+    void forward_sparse_solve(DenseM_t& b, DenseM_t* work,
+                              const std::vector<char>& pat,
+                              int etree_level, int task_depth) const override;
+    void backward_sparse_solve(DenseM_t& y, DenseM_t* work,
+                               const std::vector<char>& pat,
+                               int etree_level, int task_depth) const override;
+    bool solve_per_front() const override { return false; }
+
     long long node_factor_nonzeros() const override;
 
+    const structured::ClusterTree* sep_cluster_tree() const override {
+      return &sep_tree_;
+    }
+    void cluster_CB_node(const Opts_t& opts,
+                         const std::vector<const F_t*>& ancestors) override;
+    void set_HSS_tree(const Opts_t& opts,
+                      structured::ClusterTree&& upd_tree);
+    void setup_HSS_tree(const Opts_t& opts, bool is_root);
+
     using F_t::lchild_;
     using F_t::rchild_;
     using F_t::dim_sep;
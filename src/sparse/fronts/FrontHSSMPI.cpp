@@ -140,6 +140,7 @@ namespace strumpack {
       if (er != ReturnCode::SUCCESS) err_code = er;
     }
     if (!dim_blk()) return err_code;
+    FrontFactorStats fs(params::FrontType::HSS, Comm().is_root());
     TaskTimer t("FrontHSSMPI_factor");
     if (opts.print_compressed_front_stats()) t.start();
     auto mult = [&](DistM_t& R, DistM_t& Sr, DistM_t& Sc) {
@@ -152,12 +153,16 @@ namespace strumpack {
        std::vector<DistMW_t>& B) {
       element_extraction(A, I, J, B);
     };
-    H_->compress(mult, elem_blocks, opts.HSS_options());
+    {
+      TRACE_FRONT("compress_hss");
+      H_->compress(mult, elem_blocks, opts.HSS_options());
+    }
 
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
 
     if (dim_sep()) {
+      TRACE_FRONT("factor_hss");
       if (etree_level > 0) {
         {
           TIMER_TIME(TaskType::HSS_PARTIALLY_FACTOR, 0, t_pfact);
@@ -224,6 +229,7 @@ namespace strumpack {
     bupd = DistM_t(H_->grid(), dim_upd(), b.cols());
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
+    TRACE_FRONT("fwd_solve");
     if (etree_level) {
       if (theta_.cols() && phi_.cols()) {
         TIMER_TIME(TaskType::SOLVE_LOWER, 0, t_reduce);
@@ -256,6 +262,7 @@ namespace strumpack {
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
     {
+      TRACE_FRONT("bwd_solve");
       TIMER_TIME(TaskType::SOLVE_UPPER, 0, t_expand);
       if (etree_level) {
         if (phi_.cols() && theta_.cols()) {
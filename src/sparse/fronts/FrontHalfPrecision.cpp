@@ -0,0 +1,268 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "FrontHalfPrecision.hpp"
+
+namespace strumpack {
+
+  namespace half {
+
+    inline std::uint32_t float_bits(float f) {
+      std::uint32_t u;
+      std::memcpy(&u, &f, sizeof(u));
+      return u;
+    }
+    inline float bits_float(std::uint32_t u) {
+      float f;
+      std::memcpy(&f, &u, sizeof(f));
+      return f;
+    }
+
+    // round to nearest even, NaN stays NaN
+    inline std::uint16_t to_bf16(float f) {
+      auto u = float_bits(f);
+      if ((u & 0x7fffffffu) > 0x7f800000u)
+        return std::uint16_t((u >> 16) | 0x40);
+      u += 0x7fffu + ((u >> 16) & 1u);
+      return std::uint16_t(u >> 16);
+    }
+    inline float from_bf16(std::uint16_t h) {
+      return bits_float(std::uint32_t(h) << 16);
+    }
+
+    // round to nearest even, overflow to inf, with subnormals
+    inline std::uint16_t to_fp16(float f) {
+      const std::uint32_t f32inf = 255u << 23, f16max = (127u + 16u) << 23;
+      const float denorm_magic =
+        bits_float(((127u - 15u) + (23u - 10u) + 1u) << 23);
+      auto u = float_bits(f);
+      const std::uint32_t sign = u & 0x80000000u;
+      u ^= sign;
+      std::uint16_t o;
+      if (u >= f16max) o = (u > f32inf) ? 0x7e00 : 0x7c00;
+      else if (u < (113u << 23))
+        o = std::uint16_t
+          (float_bits(bits_float(u) + denorm_magic) -
+           float_bits(denorm_magic));
+      else {
+        std::uint32_t odd = (u >> 13) & 1u;
+        u += (std::uint32_t(15 - 127) << 23) + 0xfffu + odd;
+        o = std::uint16_t(u >> 13);
+      }
+      return o | std::uint16_t(sign >> 16);
+    }
+    inline float from_fp16(std::uint16_t h) {
+      const std::uint32_t shifted_exp = 0x7c00u << 13;
+      std::uint32_t o = std::uint32_t(h & 0x7fffu) << 13;
+      const std::uint32_t exp = shifted_exp & o;
+      o += (127u - 15u) << 23;
+      if (exp == shifted_exp) o += (128u - 16u) << 23;  // inf/NaN
+      else if (exp == 0) {                             // subnormal
+        o += 1u << 23;
+        o = float_bits(bits_float(o) - bits_float(113u << 23));
+      }
+      return bits_float(o | (std::uint32_t(h & 0x8000u) << 16));
+    }
+
+    template<typename real_t, typename C> void
+    encode(const real_t* x, std::size_t n, real_t s,
+           std::uint16_t* h, C&& conv) {
+      const real_t is = real_t(1.) / s;
+      for (std::size_t i=0; i<n; i++)
+        h[i] = conv(float(x[i] * is));
+    }
+
+    template<typename real_t, typename C> void
+    decode(const std::uint16_t* h, std::size_t n, real_t s,
+           real_t* x, C&& conv) {
+      for (std::size_t i=0; i<n; i++)
+        x[i] = real_t(conv(h[i])) * s;
+    }
+
+  } // end namespace half
+
+  template<typename T> HalfMatrix<T>&
+  HalfMatrix<T>::operator=(HalfMatrix<T>&& B) {
+    STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
+    rows_ = B.rows_;  cols_ = B.cols_;  fs_ = B.fs_;
+    data_ = std::move(B.data_);
+    scale_ = std::move(B.scale_);
+    B.data_.clear();
+    B.scale_.clear();
+    B.rows_ = B.cols_ = 0;
+    return *this;
+  }
+
+  template<typename T> HalfMatrix<T>::HalfMatrix
+  (const DenseMatrix<T>& F, FactorStorage fs, int task_depth)
+    : rows_(F.rows()), cols_(F.cols()), fs_(fs) {
+    assert(fs != FactorStorage::FULL);
+    if (!rows_ || !cols_) return;
+    const std::size_t m = rows_ * c;
+    data_.resize(m * cols_);
+    scale_.resize(cols_);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t j=0; j<cols_; j++) {
+      auto x = reinterpret_cast<const real_t*>(F.ptr(0, j));
+      real_t s(0.);
+      for (std::size_t i=0; i<m; i++)
+        if (std::isfinite(x[i])) s = std::max(s, std::abs(x[i]));
+      if (s == real_t(0.)) s = real_t(1.);
+      scale_[j] = s;
+      if (fs_ == FactorStorage::FP16)
+        half::encode(x, m, s, &data_[j*m], half::to_fp16);
+      else half::encode(x, m, s, &data_[j*m], half::to_bf16);
+    }
+    STRUMPACK_ADD_MEMORY(compressed_size()*sizeof(unsigned char));
+  }
+
+  template<typename T> void HalfMatrix<T>::decompress_panel
+  (std::size_t c0, std::size_t r0, std::size_t r1,
+   DenseMatrix<T>& P, int task_depth) const {
+    assert(P.rows() == rows_ && c0 + P.cols() <= cols_);
+    if (r0 >= r1 || !cols_) return;
+    const std::size_t m = rows_ * c, n = (r1 - r0) * c, w = P.cols();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t j=0; j<w; j++) {
+      auto h = &data_[(c0+j)*m + r0*c];
+      auto x = reinterpret_cast<real_t*>(P.ptr(r0, j));
+      if (fs_ == FactorStorage::FP16)
+        half::decode(h, n, scale_[c0+j], x, half::from_fp16);
+      else half::decode(h, n, scale_[c0+j], x, half::from_bf16);
+    }
+  }
+
+  // explicit template instantiations
+  template class HalfMatrix<float>;
+  template class HalfMatrix<double>;
+  template class HalfMatrix<std::complex<float>>;
+  template class HalfMatrix<std::complex<double>>;
+
+
+  template<typename scalar_t,typename integer_t>
+  FrontHalfPrecision<scalar_t,integer_t>::FrontHalfPrecision
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd)
+    : FD_t(sep, sep_begin, sep_end, upd) {}
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontHalfPrecision<scalar_t,integer_t>::node_factor_nonzeros() const {
+    return (F11c_.compressed_size() + F12c_.compressed_size() +
+            F21c_.compressed_size()) / sizeof(scalar_t);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHalfPrecision<scalar_t,integer_t>::compress
+  (FactorStorage fs, int task_depth) {
+    TRACE_FRONT("compress_half");
+    F11c_ = HalfMatrix<scalar_t>(this->F11_, fs, task_depth);
+    F12c_ = HalfMatrix<scalar_t>(this->F12_, fs, task_depth);
+    F21c_ = HalfMatrix<scalar_t>(this->F21_, fs, task_depth);
+    this->F11_.clear();
+    this->F12_.clear();
+    this->F21_.clear();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontHalfPrecision<scalar_t,integer_t>::factor
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
+    auto e = FD_t::factor(A, opts, workspace, etree_level, task_depth);
+    FrontFactorStats fs(front_type(), false);
+    compress(opts.factor_storage(), task_depth);
+    return e;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHalfPrecision<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("fwd_solve");
+    if (this->dim_sep()) {
+      DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      bloc.laswp(this->piv_, true);
+      panel_fwd_solve<scalar_t>
+        (panel_width,
+         [&](std::size_t j, std::size_t r0, std::size_t r1, DenseM_t& P) {
+           F11c_.decompress_panel(j*panel_width, r0, r1, P, task_depth); },
+         [&](std::size_t j, DenseM_t& P) {
+           F21c_.decompress_panel
+             (j*panel_width, 0, P.rows(), P, task_depth); },
+         bloc, bupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHalfPrecision<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("bwd_solve");
+    if (this->dim_sep()) {
+      DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      panel_bwd_solve<scalar_t>
+        (panel_width,
+         [&](std::size_t j, std::size_t r0, std::size_t r1, DenseM_t& P) {
+           F11c_.decompress_panel(j*panel_width, r0, r1, P, task_depth); },
+         [&](std::size_t j, DenseM_t& P) {
+           F12c_.decompress_panel
+             (j*panel_width, 0, P.rows(), P, task_depth); },
+         yloc, yupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontHalfPrecision<scalar_t,integer_t>::node_inertia
+  (integer_t& neg, integer_t& zero, integer_t& pos) const {
+    return this->matrix_inertia(F11c_.decompress(), neg, zero, pos);
+  }
+
+  // explicit template instantiations
+  template class FrontHalfPrecision<float,int>;
+  template class FrontHalfPrecision<double,int>;
+  template class FrontHalfPrecision<std::complex<float>,int>;
+  template class FrontHalfPrecision<std::complex<double>,int>;
+
+  template class FrontHalfPrecision<float,long int>;
+  template class FrontHalfPrecision<double,long int>;
+  template class FrontHalfPrecision<std::complex<float>,long int>;
+  template class FrontHalfPrecision<std::complex<double>,long int>;
+
+  template class FrontHalfPrecision<float,long long int>;
+  template class FrontHalfPrecision<double,long long int>;
+  template class FrontHalfPrecision<std::complex<float>,long long int>;
+  template class FrontHalfPrecision<std::complex<double>,long long int>;
+
+} // end namespace strumpack
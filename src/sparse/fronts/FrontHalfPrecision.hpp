@@ -0,0 +1,156 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_HALF_PRECISION_HPP
+#define FRONTAL_MATRIX_HALF_PRECISION_HPP
+
+#include <cstdint>
+
+#include "FrontDense.hpp"
+#include "PanelSolve.hpp"
+#include "structured/StructuredMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * Dense matrix stored in a 16 bit floating point format, fp16 or
+   * bfloat16, see FactorStorage. Every column is scaled by its
+   * largest (real or imaginary) component before conversion, so the
+   * stored values are in [-1, 1], which avoids overflow and keeps
+   * most values out of the fp16 subnormal range. Complex values
+   * store the real and imaginary parts as two 16 bit numbers.
+   */
+  template<typename T> class HalfMatrix
+    : public structured::StructuredMatrix<T> {
+    using real_t = typename RealType<T>::value_type;
+  public:
+    HalfMatrix() {}
+    HalfMatrix(const HalfMatrix<T>&) = delete;
+    HalfMatrix(HalfMatrix<T>&& B) { *this = std::move(B); }
+    HalfMatrix& operator=(const HalfMatrix<T>&) = delete;
+    HalfMatrix& operator=(HalfMatrix<T>&& B);
+
+    HalfMatrix(const DenseMatrix<T>& F, FactorStorage fs,
+               int task_depth=0);
+    virtual ~HalfMatrix() {
+      STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
+    }
+
+    DenseMatrix<T> decompress(int task_depth=0) const {
+      DenseMatrix<T> F(rows_, cols_);
+      decompress_panel(0, 0, rows_, F, task_depth);
+      return F;
+    }
+
+    /**
+     * Convert rows [r0, r1) of the columns [c0, c0+P.cols()) back to
+     * T. The values are written to P at the same row positions as in
+     * the full matrix, so P should have rows() rows. Rows of P
+     * outside [r0, r1) are not touched.
+     */
+    void decompress_panel(std::size_t c0, std::size_t r0, std::size_t r1,
+                          DenseMatrix<T>& P, int task_depth=0) const;
+
+    FactorStorage storage() const { return fs_; }
+
+    std::size_t compressed_size() const {
+      return data_.size()*sizeof(std::uint16_t) +
+        scale_.size()*sizeof(real_t);
+    }
+    std::size_t memory() const override { return compressed_size(); }
+    std::size_t nonzeros() const override { return rows()*cols(); }
+    std::size_t rank() const override { return std::min(rows(), cols()); }
+    std::size_t rows() const override { return rows_; }
+    std::size_t cols() const override { return cols_; }
+
+  private:
+    std::size_t rows_ = 0, cols_ = 0;
+    FactorStorage fs_ = FactorStorage::BF16;
+    // column j is stored at data_[j*rows_*c], with c = 1 for real,
+    // and c = 2 for complex T
+    std::vector<std::uint16_t> data_;
+    std::vector<real_t> scale_;
+
+    static constexpr std::size_t c = sizeof(T) / sizeof(real_t);
+  };
+
+
+  /**
+   * Dense front, factored in the working precision, but with the
+   * factors stored as HalfMatrix. The solve converts the factors
+   * back one column panel at a time, so it reads only 2 bytes per
+   * (real) factor entry from memory.
+   *
+   * \see SPOptions::set_factor_storage
+   */
+  template<typename scalar_t,typename integer_t> class FrontHalfPrecision
+    : public FrontDense<scalar_t,integer_t> {
+    using F_t = Front<scalar_t,integer_t>;
+    using FD_t = FrontDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+    using Opts_t = SPOptions<scalar_t>;
+
+  public:
+    FrontHalfPrecision(integer_t sep, integer_t sep_begin,
+                       integer_t sep_end, std::vector<integer_t>& upd);
+
+    ReturnCode factor(const SpMat_t& A, const Opts_t& opts,
+                      VectorPool<scalar_t>& workspace,
+                      int etree_level=0, int task_depth=0) override;
+
+    std::string type() const override { return "FrontHalfPrecision"; }
+
+    void compress(FactorStorage fs, int task_depth);
+
+    long long node_factor_nonzeros() const override;
+
+  private:
+    params::FrontType front_type() const override
+    { return params::FrontType::HALF; }
+
+    // width of the column panels converted at once in the solve
+    static constexpr std::size_t panel_width = 128;
+    HalfMatrix<scalar_t> F11c_, F12c_, F21c_;
+
+    void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+
+    ReturnCode node_inertia(integer_t& neg, integer_t& zero,
+                            integer_t& pos) const override;
+
+    FrontHalfPrecision(const FrontHalfPrecision&) = delete;
+    FrontHalfPrecision& operator=(FrontHalfPrecision const&) = delete;
+  };
+
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_HALF_PRECISION_HPP
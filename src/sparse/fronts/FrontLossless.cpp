@@ -0,0 +1,486 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <array>
+#include <cassert>
+#include <queue>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include "FrontLossless.hpp"
+
+namespace strumpack {
+
+  namespace lossless {
+
+    /*
+     * Byte plane modes. A plane is stored as
+     *  RAW:      mode, n bytes
+     *  CONSTANT: mode, value
+     *  HUFFMAN:  mode, 128 bytes with the 4 bit code lengths of the
+     *            256 symbols, 4 bytes for the size of the bit stream,
+     *            the bit stream
+     */
+    enum : unsigned char { RAW = 0, CONSTANT = 1, HUFFMAN = 2 };
+
+    // maximum Huffman code length, decoding uses a 2^MAXLEN table
+    const int MAXLEN = 12;
+
+    /*
+     * Compute (length limited) Huffman code lengths for the symbols
+     * with nonzero frequency. If the lengths exceed MAXLEN, the
+     * frequencies are flattened and the code is recomputed.
+     */
+    inline void code_lengths(std::array<std::uint32_t,256> f,
+                             std::array<unsigned char,256>& len) {
+      while (true) {
+        len.fill(0);
+        using node_t = std::pair<std::uint64_t,int>;
+        std::priority_queue<node_t,std::vector<node_t>,
+                            std::greater<node_t>> q;
+        std::vector<int> parent(512, -1);
+        int nodes = 256;
+        for (int s=0; s<256; s++)
+          if (f[s]) q.push({f[s], s});
+        while (q.size() > 1) {
+          auto a = q.top(); q.pop();
+          auto b = q.top(); q.pop();
+          parent[a.second] = parent[b.second] = nodes;
+          q.push({a.first + b.first, nodes++});
+        }
+        int maxlen = 0;
+        for (int s=0; s<256; s++) {
+          if (!f[s]) continue;
+          int l = 0;
+          for (int p=parent[s]; p != -1; p=parent[p]) l++;
+          len[s] = l;
+          maxlen = std::max(maxlen, l);
+        }
+        if (maxlen <= MAXLEN) return;
+        for (auto& fs : f)
+          if (fs) fs = (fs + 1) / 2;
+      }
+    }
+
+    // canonical codes, bit reversed for LSB first output
+    inline void canonical_codes(const std::array<unsigned char,256>& len,
+                                std::array<std::uint32_t,256>& code) {
+      std::array<int,MAXLEN+2> cnt = {}, next = {};
+      for (int s=0; s<256; s++) cnt[len[s]]++;
+      cnt[0] = 0;
+      for (int l=1, c=0; l<=MAXLEN; l++) {
+        c = (c + cnt[l-1]) << 1;
+        next[l] = c;
+      }
+      for (int s=0; s<256; s++) {
+        int l = len[s];
+        if (!l) continue;
+        std::uint32_t c = next[l]++, r = 0;
+        for (int i=0; i<l; i++) { r = (r << 1) | (c & 1); c >>= 1; }
+        code[s] = r;
+      }
+    }
+
+    inline void encode_plane(const unsigned char* p, std::size_t n,
+                             std::vector<unsigned char>& out) {
+      std::array<std::uint32_t,256> f = {};
+      for (std::size_t i=0; i<n; i++) f[p[i]]++;
+      int nsym = 0;
+      for (auto fs : f) if (fs) nsym++;
+      if (nsym <= 1) {
+        out.push_back(CONSTANT);
+        out.push_back(n ? p[0] : 0);
+        return;
+      }
+      std::array<unsigned char,256> len;
+      code_lengths(f, len);
+      std::uint64_t bits = 0;
+      for (int s=0; s<256; s++) bits += std::uint64_t(f[s]) * len[s];
+      std::size_t hbytes = 1 + 128 + 4 + (bits + 7) / 8;
+      if (hbytes >= 1 + n) {
+        out.push_back(RAW);
+        out.insert(out.end(), p, p+n);
+        return;
+      }
+      std::array<std::uint32_t,256> code = {};
+      canonical_codes(len, code);
+      out.push_back(HUFFMAN);
+      for (int s=0; s<256; s+=2)
+        out.push_back(len[s] | (len[s+1] << 4));
+      std::uint32_t nb = (bits + 7) / 8;
+      for (int i=0; i<4; i++) out.push_back((nb >> (8*i)) & 0xff);
+      auto pos = out.size();
+      out.resize(pos + nb);
+      auto o = out.data() + pos;
+      std::uint64_t acc = 0;
+      int na = 0;
+      for (std::size_t i=0; i<n; i++) {
+        acc |= std::uint64_t(code[p[i]]) << na;
+        na += len[p[i]];
+        while (na >= 8) { *o++ = acc & 0xff; acc >>= 8; na -= 8; }
+      }
+      if (na) *o++ = acc & 0xff;
+    }
+
+    inline const unsigned char*
+    decode_plane(const unsigned char* in, unsigned char* p, std::size_t n) {
+      auto mode = *in++;
+      if (mode == CONSTANT) {
+        std::memset(p, *in, n);
+        return in + 1;
+      }
+      if (mode == RAW) {
+        std::memcpy(p, in, n);
+        return in + n;
+      }
+      std::array<unsigned char,256> len;
+      for (int s=0; s<256; s+=2) {
+        len[s] = in[s/2] & 0xf;
+        len[s+1] = in[s/2] >> 4;
+      }
+      in += 128;
+      std::uint32_t nb = 0;
+      for (int i=0; i<4; i++) nb |= std::uint32_t(in[i]) << (8*i);
+      in += 4;
+      std::array<std::uint32_t,256> code = {};
+      canonical_codes(len, code);
+      // table entry: symbol in the low byte, code length in the high
+      std::vector<std::uint16_t> table(1 << MAXLEN);
+      for (int s=0; s<256; s++) {
+        int l = len[s];
+        if (!l) continue;
+        for (std::uint32_t c=code[s]; c<(1u << MAXLEN); c+=(1u << l))
+          table[c] = s | (l << 8);
+      }
+      const auto end = in + nb;
+      std::uint64_t acc = 0;
+      int na = 0;
+      for (std::size_t i=0; i<n; i++) {
+        while (na <= 56) {
+          acc |= std::uint64_t(in < end ? *in++ : 0) << na;
+          na += 8;
+        }
+        auto e = table[acc & ((1u << MAXLEN) - 1)];
+        p[i] = e & 0xff;
+        acc >>= (e >> 8);
+        na -= (e >> 8);
+      }
+      return end;
+    }
+
+    // order 0 entropy (in bits, times the number of symbols)
+    inline double entropy(const std::array<std::uint32_t,256>& f) {
+      double n = 0., e = 0.;
+      for (auto fs : f) n += fs;
+      for (auto fs : f)
+        if (fs) e -= fs * std::log2(fs / n);
+      return e;
+    }
+
+    template<typename T> struct Word {};
+    template<> struct Word<float> { using type = std::uint32_t; };
+    template<> struct Word<double> { using type = std::uint64_t; };
+
+    /*
+     * Encode the r x c tile at A (leading dimension ld), with s real
+     * words per scalar (1 for real, 2 for complex). A tile is stored
+     * as a flag (XOR-delta or not), followed by the sizeof(W) byte
+     * planes.
+     */
+    template<typename W> void
+    encode_tile(const W* A, std::size_t ld, std::size_t r, std::size_t c,
+                int s, std::vector<unsigned char>& out) {
+      const std::size_t m = r * c * s, B = sizeof(W);
+      std::vector<W> d(m);
+      for (std::size_t j=0; j<c; j++)
+        std::copy(A+j*ld*s, A+j*ld*s+r*s, d.data()+j*r*s);
+      // XOR-delta with the previous value (of the same real/imag
+      // part), only if that reduces the entropy of the most
+      // significant (sign/exponent) byte, which is what compresses
+      std::array<std::uint32_t,256> f0 = {}, f1 = {};
+      const int top = 8 * (B - 1);
+      for (std::size_t k=0; k<m; k++) {
+        f0[d[k] >> top]++;
+        f1[(k < std::size_t(s) ? d[k] : d[k] ^ d[k-s]) >> top]++;
+      }
+      bool delta = entropy(f1) < entropy(f0);
+      out.push_back(delta);
+      // from back to front so it can be done in place
+      if (delta)
+        for (std::size_t k=m; k-->std::size_t(s); )
+          d[k] ^= d[k-s];
+      // byte shuffle
+      std::vector<unsigned char> planes(m*B);
+      for (std::size_t k=0; k<m; k++)
+        for (std::size_t b=0; b<B; b++)
+          planes[b*m+k] = (d[k] >> (8*b)) & 0xff;
+      for (std::size_t b=0; b<B; b++)
+        encode_plane(planes.data()+b*m, m, out);
+    }
+
+    template<typename W> void
+    decode_tile(const unsigned char* in, W* A, std::size_t ld,
+                std::size_t r, std::size_t c, int s) {
+      const std::size_t m = r * c * s, B = sizeof(W);
+      bool delta = *in++;
+      std::vector<unsigned char> planes(m*B);
+      for (std::size_t b=0; b<B; b++)
+        in = decode_plane(in, planes.data()+b*m, m);
+      std::vector<W> d(m, W(0));
+      for (std::size_t b=0; b<B; b++)
+        for (std::size_t k=0; k<m; k++)
+          d[k] |= W(planes[b*m+k]) << (8*b);
+      if (delta)
+        for (std::size_t k=s; k<m; k++)
+          d[k] ^= d[k-s];
+      for (std::size_t j=0; j<c; j++)
+        std::copy(d.data()+j*r*s, d.data()+(j+1)*r*s, A+j*ld*s);
+    }
+
+  } // end namespace lossless
+
+
+  template<typename T> LosslessMatrix<T>&
+  LosslessMatrix<T>::operator=(LosslessMatrix<T>&& B) {
+    STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
+    rows_ = B.rows_;  cols_ = B.cols_;  tile_ = B.tile_;
+    buffer_ = std::move(B.buffer_);
+    off_ = std::move(B.off_);
+    B.buffer_.clear();
+    B.off_.clear();
+    B.rows_ = B.cols_ = 0;
+    return *this;
+  }
+
+  template<typename T> LosslessMatrix<T>::LosslessMatrix
+  (const DenseMatrix<T>& F, int tile, int task_depth)
+    : rows_(F.rows()), cols_(F.cols()), tile_(tile) {
+    if (!rows_ || !cols_) return;
+    using real_t = typename RealType<T>::value_type;
+    using W = typename lossless::Word<real_t>::type;
+    const int s = sizeof(T) / sizeof(real_t);
+    const std::size_t rt = tile_rows(), ct = tile_cols(), nt = rt * ct;
+    std::vector<std::vector<unsigned char>> tiles(nt);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t t=0; t<nt; t++) {
+      std::size_t i = (t % rt) * tile_, j = (t / rt) * tile_;
+      lossless::encode_tile
+        (reinterpret_cast<const W*>(F.ptr(i, j)), F.ld(),
+         std::min(std::size_t(tile_), rows_-i),
+         std::min(std::size_t(tile_), cols_-j), s, tiles[t]);
+    }
+    off_.resize(nt+1);
+    off_[0] = 0;
+    for (std::size_t t=0; t<nt; t++)
+      off_[t+1] = off_[t] + tiles[t].size();
+    buffer_.resize(off_[nt]);
+    for (std::size_t t=0; t<nt; t++)
+      std::copy(tiles[t].begin(), tiles[t].end(), &buffer_[off_[t]]);
+    STRUMPACK_ADD_MEMORY(buffer_.size()*sizeof(unsigned char));
+  }
+
+  template<typename T> void LosslessMatrix<T>::decompress
+  (DenseMatrix<T>& F, int task_depth) const {
+    assert(F.rows() == rows_ && F.cols() == cols_);
+    if (!rows_ || !cols_) return;
+    using real_t = typename RealType<T>::value_type;
+    using W = typename lossless::Word<real_t>::type;
+    const int s = sizeof(T) / sizeof(real_t);
+    const std::size_t rt = tile_rows(), nt = rt * tile_cols();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t t=0; t<nt; t++) {
+      std::size_t i = (t % rt) * tile_, j = (t / rt) * tile_;
+      lossless::decode_tile
+        (&buffer_[off_[t]], reinterpret_cast<W*>(F.ptr(i, j)), F.ld(),
+         std::min(std::size_t(tile_), rows_-i),
+         std::min(std::size_t(tile_), cols_-j), s);
+    }
+  }
+
+  template<typename T> void LosslessMatrix<T>::decompress_panel
+  (std::size_t j, std::size_t r0, std::size_t r1,
+   DenseMatrix<T>& P, int task_depth) const {
+    assert(P.rows() == rows_ && j < tile_cols());
+    if (r0 >= r1 || !cols_) return;
+    using real_t = typename RealType<T>::value_type;
+    using W = typename lossless::Word<real_t>::type;
+    const int s = sizeof(T) / sizeof(real_t);
+    const std::size_t rt = tile_rows(), w =
+      std::min(std::size_t(tile_), cols_-j*tile_),
+      i0 = r0 / tile_, i1 = std::min(rt, (r1 + tile_ - 1) / tile_);
+    assert(P.cols() >= w);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t i=i0; i<i1; i++)
+      lossless::decode_tile
+        (&buffer_[off_[i+j*rt]], reinterpret_cast<W*>(P.ptr(i*tile_, 0)),
+         P.ld(), std::min(std::size_t(tile_), rows_-i*tile_), w, s);
+  }
+
+  // explicit template instantiations
+  template class LosslessMatrix<float>;
+  template class LosslessMatrix<double>;
+  template class LosslessMatrix<std::complex<float>>;
+  template class LosslessMatrix<std::complex<double>>;
+
+
+  template<typename scalar_t,typename integer_t>
+  FrontLossless<scalar_t,integer_t>::FrontLossless
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd)
+    : FD_t(sep, sep_begin, sep_end, upd) {}
+
+  template<typename scalar_t,typename integer_t>
+  FrontLossless<scalar_t,integer_t>::~FrontLossless() {
+    Cache_t::instance().erase(this);
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontLossless<scalar_t,integer_t>::node_factor_nonzeros() const {
+    return (F11c_.compressed_size() + F12c_.compressed_size() +
+            F21c_.compressed_size()) / sizeof(scalar_t);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontLossless<scalar_t,integer_t>::compress(int task_depth) {
+    TRACE_FRONT("compress_lossless");
+    Cache_t::instance().erase(this);
+    F11c_ = LosslessMatrix<scalar_t>(this->F11_, 128, task_depth);
+    F12c_ = LosslessMatrix<scalar_t>(this->F12_, 128, task_depth);
+    F21c_ = LosslessMatrix<scalar_t>(this->F21_, 128, task_depth);
+    this->F11_.clear();
+    this->F12_.clear();
+    this->F21_.clear();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontLossless<scalar_t,integer_t>::decompress
+  (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21, int task_depth) const {
+    TRACE_FRONT("decompress_lossless");
+    F11 = F11c_.decompress(task_depth);
+    F12 = F12c_.decompress(task_depth);
+    F21 = F21c_.decompress(task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontLossless<scalar_t,integer_t>::factor
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
+    auto e = FD_t::factor(A, opts, workspace, etree_level, task_depth);
+    cache_ = opts.compressed_solve_cache();
+    FrontFactorStats fs(front_type(), false);
+    compress(task_depth);
+    return e;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  typename DecompressedFrontCache<scalar_t>::Factors_ptr
+  FrontLossless<scalar_t,integer_t>::cached_factors(int task_depth) const {
+    if (!cache_) return nullptr;
+    auto& cache = Cache_t::instance();
+    auto f = cache.find(this);
+    std::size_t ds = this->dim_sep(), du = this->dim_upd();
+    if (f || (ds*ds + 2*ds*du) * sizeof(scalar_t) > cache_) return f;
+    auto nf = std::make_shared<typename Cache_t::Factors>();
+    decompress(nf->F11, nf->F12, nf->F21, task_depth);
+    cache.insert(this, nf, cache_);
+    return nf;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontLossless<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("fwd_solve");
+    if (this->dim_sep()) {
+      DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      bloc.laswp(this->piv_, true);
+      if (auto F = cached_factors(task_depth))
+        factors_fwd_solve(F->F11, F->F21, bloc, bupd, task_depth);
+      else
+        panel_fwd_solve<scalar_t>
+          (F11c_.tile(),
+           [&](std::size_t j, std::size_t r0, std::size_t r1, DenseM_t& P) {
+             F11c_.decompress_panel(j, r0, r1, P, task_depth); },
+           [&](std::size_t j, DenseM_t& P) {
+             F21c_.decompress_panel(j, 0, P.rows(), P, task_depth); },
+           bloc, bupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontLossless<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    TRACE_FRONT("bwd_solve");
+    if (this->dim_sep()) {
+      DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (auto F = cached_factors(task_depth))
+        factors_bwd_solve(F->F11, F->F12, yloc, yupd, task_depth);
+      else
+        panel_bwd_solve<scalar_t>
+          (F11c_.tile(),
+           [&](std::size_t j, std::size_t r0, std::size_t r1, DenseM_t& P) {
+             F11c_.decompress_panel(j, r0, r1, P, task_depth); },
+           [&](std::size_t j, DenseM_t& P) {
+             F12c_.decompress_panel(j, 0, P.rows(), P, task_depth); },
+           yloc, yupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontLossless<scalar_t,integer_t>::node_inertia
+  (integer_t& neg, integer_t& zero, integer_t& pos) const {
+    return this->matrix_inertia(F11c_.decompress(), neg, zero, pos);
+  }
+
+  // explicit template instantiations
+  template class FrontLossless<float,int>;
+  template class FrontLossless<double,int>;
+  template class FrontLossless<std::complex<float>,int>;
+  template class FrontLossless<std::complex<double>,int>;
+
+  template class FrontLossless<float,long int>;
+  template class FrontLossless<double,long int>;
+  template class FrontLossless<std::complex<float>,long int>;
+  template class FrontLossless<std::complex<double>,long int>;
+
+  template class FrontLossless<float,long long int>;
+  template class FrontLossless<double,long long int>;
+  template class FrontLossless<std::complex<float>,long long int>;
+  template class FrontLossless<std::complex<double>,long long int>;
+
+} // end namespace strumpack
@@ -0,0 +1,159 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_LOSSLESS_HPP
+#define FRONTAL_MATRIX_LOSSLESS_HPP
+
+#include "FrontDense.hpp"
+#include "PanelSolve.hpp"
+#include "structured/StructuredMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * Dense matrix stored with a built-in lossless codec, does not
+   * depend on any external compression library. The matrix is split
+   * in square tiles, which are compressed and decompressed
+   * independently (and in parallel). Each tile is encoded as an
+   * XOR-delta between consecutive floating point values, followed by
+   * a byte shuffle (all first bytes, then all second bytes, ..) and
+   * a canonical Huffman code per byte plane. The sign/exponent planes
+   * compress well, mantissa planes that do not compress are stored
+   * as is.
+   */
+  template<typename T> class LosslessMatrix
+    : public structured::StructuredMatrix<T> {
+  public:
+    LosslessMatrix() {}
+    LosslessMatrix(const LosslessMatrix<T>&) = delete;
+    LosslessMatrix(LosslessMatrix<T>&& B) { *this = std::move(B); }
+    LosslessMatrix& operator=(const LosslessMatrix<T>&) = delete;
+    LosslessMatrix& operator=(LosslessMatrix<T>&& B);
+
+    LosslessMatrix(const DenseMatrix<T>& F, int tile=128,
+                   int task_depth=0);
+    virtual ~LosslessMatrix() {
+      STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
+    }
+
+    DenseMatrix<T> decompress(int task_depth=0) const {
+      DenseMatrix<T> F(rows_, cols_);
+      decompress(F, task_depth);
+      return F;
+    }
+    void decompress(DenseMatrix<T>& F, int task_depth=0) const;
+
+    /**
+     * Decompress only the tiles of tile column j that overlap with
+     * rows [r0, r1). The tiles are written to P at the same row
+     * positions as in the full matrix, so P should have rows() rows
+     * and (at least) as many columns as tile column j. Rows of P
+     * outside the overlapping tiles are not touched.
+     */
+    void decompress_panel(std::size_t j, std::size_t r0, std::size_t r1,
+                          DenseMatrix<T>& P, int task_depth=0) const;
+
+    /**
+     * Size of the (square) tiles, and the width of the column
+     * panels used by decompress_panel.
+     */
+    int tile() const { return tile_; }
+
+    std::size_t compressed_size() const { return buffer_.size(); }
+    std::size_t memory() const override { return compressed_size(); }
+    std::size_t nonzeros() const override { return rows()*cols(); }
+    std::size_t rank() const override { return std::min(rows(), cols()); }
+    std::size_t rows() const override { return rows_; }
+    std::size_t cols() const override { return cols_; }
+
+  private:
+    std::size_t rows_ = 0, cols_ = 0;
+    int tile_ = 128;
+    // compressed tiles, tile (i,j) is stored at
+    // buffer_[off_[i+j*rt]], with rt the number of tile rows
+    std::vector<unsigned char> buffer_;
+    std::vector<std::size_t> off_;
+
+    std::size_t tile_rows() const { return (rows_ + tile_ - 1) / tile_; }
+    std::size_t tile_cols() const { return (cols_ + tile_ - 1) / tile_; }
+  };
+
+
+  template<typename scalar_t,typename integer_t> class FrontLossless
+    : public FrontDense<scalar_t,integer_t> {
+    using F_t = Front<scalar_t,integer_t>;
+    using FD_t = FrontDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+    using Opts_t = SPOptions<scalar_t>;
+
+  public:
+    FrontLossless(integer_t sep, integer_t sep_begin, integer_t sep_end,
+                  std::vector<integer_t>& upd);
+    ~FrontLossless();
+
+    ReturnCode factor(const SpMat_t& A, const Opts_t& opts,
+                      VectorPool<scalar_t>& workspace,
+                      int etree_level=0, int task_depth=0) override;
+
+    std::string type() const override { return "FrontLossless"; }
+
+    void compress(int task_depth);
+    void decompress(DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+                    int task_depth) const;
+
+    long long node_factor_nonzeros() const override;
+
+  private:
+    params::FrontType front_type() const override
+    { return params::FrontType::LOSSLESS; }
+
+    LosslessMatrix<scalar_t> F11c_, F12c_, F21c_;
+    // capacity (bytes) of the decompressed front cache, 0 to stream
+    // the factors panel by panel in the solve
+    std::size_t cache_ = 0;
+
+    using Cache_t = DecompressedFrontCache<scalar_t>;
+    typename Cache_t::Factors_ptr cached_factors(int task_depth) const;
+
+    void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+
+    ReturnCode node_inertia(integer_t& neg, integer_t& zero,
+                            integer_t& pos) const override;
+
+    FrontLossless(const FrontLossless&) = delete;
+    FrontLossless& operator=(FrontLossless const&) = delete;
+  };
+
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_LOSSLESS_HPP
@@ -150,25 +150,72 @@ namespace strumpack {
   template class LossyMatrix<std::complex<double>>;
 
 
+  /*
+   * Compress F per column panel of nb columns. Each panel is copied
+   * to a contiguous buffer first, since ZFP/SZ3 expect ld == rows.
+   */
+  template<typename T> std::vector<LossyMatrix<T>>
+  compress_panels(const DenseMatrix<T>& F, std::size_t nb,
+                  int prec, double acc) {
+    std::vector<LossyMatrix<T>> P;
+    const std::size_t m = F.rows(), n = F.cols();
+    if (!m || !n) return P;
+    // reserve, so the LossyMatrix objects are never moved
+    P.reserve((n + nb - 1) / nb);
+    DenseMatrix<T> buf(m, std::min(nb, n));
+    for (std::size_t c0=0; c0<n; c0+=nb) {
+      DenseMatrixWrapper<T> Fj(m, std::min(nb, n-c0), buf.data(), m);
+      Fj.copy(F, 0, c0);
+      P.emplace_back(Fj, prec, acc);
+    }
+    return P;
+  }
+
+  template<typename T> DenseMatrix<T>
+  decompress_panels(const std::vector<LossyMatrix<T>>& P,
+                    std::size_t m, std::size_t n, std::size_t nb) {
+    DenseMatrix<T> F(m, n);
+    if (!m || !n) return F;
+    for (std::size_t j=0, c0=0; c0<n; j++, c0+=nb) {
+      DenseMatrixWrapper<T> Fj(m, std::min(nb, n-c0), F, 0, c0);
+      P[j].decompress(Fj);
+    }
+    return F;
+  }
+
+  template<typename T> std::size_t
+  compressed_size(const std::vector<LossyMatrix<T>>& P) {
+    std::size_t s = 0;
+    for (auto& Pj : P) s += Pj.compressed_size();
+    return s;
+  }
+
   template<typename scalar_t,typename integer_t>
   FrontLossy<scalar_t,integer_t>::FrontLossy
   (integer_t sep, integer_t sep_begin, integer_t sep_end,
    std::vector<integer_t>& upd)
     : FD_t(sep, sep_begin, sep_end, upd) {}
 
+  template<typename scalar_t,typename integer_t>
+  FrontLossy<scalar_t,integer_t>::~FrontLossy() {
+    Cache_t::instance().erase(this);
+  }
+
   template<typename scalar_t,typename integer_t> long long
   FrontLossy<scalar_t,integer_t>::node_factor_nonzeros() const {
-    return (F11c_.compressed_size() + F12c_.compressed_size() +
-            F21c_.compressed_size()) / sizeof(scalar_t);
+    return (compressed_size(F11c_) + compressed_size(F12c_) +
+            compressed_size(F21c_)) / sizeof(scalar_t);
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontLossy<scalar_t,integer_t>::compress(const Opts_t& opts) {
+    TRACE_FRONT("compress_lossy");
+    Cache_t::instance().erase(this);
     auto prec = opts.lossy_precision();
     auto acc = opts.lossy_accuracy();
-    F11c_ = LossyMatrix<scalar_t>(this->F11_, prec, acc);
-    F12c_ = LossyMatrix<scalar_t>(this->F12_, prec, acc);
-    F21c_ = LossyMatrix<scalar_t>(this->F21_, prec, acc);
+    F11c_ = compress_panels(this->F11_, panel_width, prec, acc);
+    F12c_ = compress_panels(this->F12_, panel_width, prec, acc);
+    F21c_ = compress_panels(this->F21_, panel_width, prec, acc);
     this->F11_.clear();
     this->F12_.clear();
     this->F21_.clear();
@@ -177,9 +224,11 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontLossy<scalar_t,integer_t>::decompress
   (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21) const {
-    F11 = F11c_.decompress();
-    F12 = F12c_.decompress();
-    F21 = F21c_.decompress();
+    TRACE_FRONT("decompress_lossy");
+    std::size_t ds = this->dim_sep(), du = this->dim_upd();
+    F11 = decompress_panels(F11c_, ds, ds, panel_width);
+    F12 = decompress_panels(F12c_, ds, du, panel_width);
+    F21 = decompress_panels(F21c_, du, ds, panel_width);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -187,61 +236,70 @@ namespace strumpack {
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
    int etree_level, int task_depth) {
     auto e = FD_t::factor(A, opts, workspace, etree_level, task_depth);
+    cache_ = opts.compressed_solve_cache();
+    FrontFactorStats fs(front_type(), false);
     compress(opts);
     return e;
   }
 
+  template<typename scalar_t,typename integer_t>
+  typename DecompressedFrontCache<scalar_t>::Factors_ptr
+  FrontLossy<scalar_t,integer_t>::cached_factors() const {
+    if (!cache_) return nullptr;
+    auto& cache = Cache_t::instance();
+    auto f = cache.find(this);
+    std::size_t ds = this->dim_sep(), du = this->dim_upd();
+    if (f || (ds*ds + 2*ds*du) * sizeof(scalar_t) > cache_) return f;
+    auto nf = std::make_shared<typename Cache_t::Factors>();
+    decompress(nf->F11, nf->F12, nf->F21);
+    cache.insert(this, nf, cache_);
+    return nf;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontLossy<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
-    DenseM_t F11, F12, F21;
-    decompress(F11, F12, F21);
+    TRACE_FRONT("fwd_solve");
     if (this->dim_sep()) {
       DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
       bloc.laswp(this->piv_, true);
-      if (b.cols() == 1) {
-        trsv(UpLo::L, Trans::N, Diag::U, F11, bloc, task_depth);
-        if (this->dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F21, bloc,
-               scalar_t(1.), bupd, task_depth);
-      } else {
-        trsm(Side::L, UpLo::L, Trans::N, Diag::U,
-             scalar_t(1.), F11, bloc, task_depth);
-        if (this->dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F21, bloc,
-               scalar_t(1.), bupd, task_depth);
-      }
+      if (auto F = cached_factors())
+        factors_fwd_solve(F->F11, F->F21, bloc, bupd, task_depth);
+      else
+        panel_fwd_solve<scalar_t>
+          (panel_width,
+           [&](std::size_t j, std::size_t, std::size_t, DenseM_t& P) {
+             F11c_[j].decompress(P); },
+           [&](std::size_t j, DenseM_t& P) { F21c_[j].decompress(P); },
+           bloc, bupd, task_depth);
     }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontLossy<scalar_t,integer_t>::bwd_solve_phase1
   (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
-    DenseM_t F11, F12, F21;
-    decompress(F11, F12, F21);
+    TRACE_FRONT("bwd_solve");
     if (this->dim_sep()) {
       DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
-      if (y.cols() == 1) {
-        if (this->dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F12, yupd,
-               scalar_t(1.), yloc, task_depth);
-        trsv(UpLo::U, Trans::N, Diag::N, F11, yloc, task_depth);
-      } else {
-        if (this->dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F12, yupd,
-               scalar_t(1.), yloc, task_depth);
-        trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.),
-             F11, yloc, task_depth);
-      }
+      if (auto F = cached_factors())
+        factors_bwd_solve(F->F11, F->F12, yloc, yupd, task_depth);
+      else
+        panel_bwd_solve<scalar_t>
+          (panel_width,
+           [&](std::size_t j, std::size_t, std::size_t, DenseM_t& P) {
+             F11c_[j].decompress(P); },
+           [&](std::size_t j, DenseM_t& P) { F12c_[j].decompress(P); },
+           yloc, yupd, task_depth);
     }
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontLossy<scalar_t,integer_t>::node_inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) const {
-    return this->matrix_inertia(F11c_.decompress(), neg, zero, pos);
+    return this->matrix_inertia
+      (decompress_panels(F11c_, this->dim_sep(), this->dim_sep(),
+                         panel_width), neg, zero, pos);
   }
-
   // explicit template instantiations
   template class FrontLossy<float,int>;
   template class FrontLossy<double,int>;
@@ -30,6 +30,7 @@
 #define FRONTAL_MATRIX_LOSSY_HPP
 
 #include "FrontDense.hpp"
+#include "PanelSolve.hpp"
 #include "structured/StructuredMatrix.hpp"
 
 namespace strumpack {
@@ -113,6 +114,7 @@ namespace strumpack {
   public:
     FrontLossy(integer_t sep, integer_t sep_begin, integer_t sep_end,
                std::vector<integer_t>& upd);
+    ~FrontLossy();
 
     ReturnCode factor(const SpMat_t& A, const SPOptions<scalar_t>& opts,
                       VectorPool<scalar_t>& workspace,
@@ -127,7 +129,19 @@ namespace strumpack {
     long long node_factor_nonzeros() const override;
 
   private:
-    LossyMatrix<scalar_t> F11c_, F12c_, F21c_;
+    params::FrontType front_type() const override
+    { return params::FrontType::LOSSY; }
+
+    // the factors are compressed per column panel of panel_width
+    // columns, so the solve only needs to decompress one panel at a
+    // time
+    static constexpr std::size_t panel_width = 128;
+    std::vector<LossyMatrix<scalar_t>> F11c_, F12c_, F21c_;
+    // capacity (bytes) of the decompressed front cache
+    std::size_t cache_ = 0;
+
+    using Cache_t = DecompressedFrontCache<scalar_t>;
+    typename Cache_t::Factors_ptr cached_factors() const;
 
     void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
                           int etree_level, int task_depth) const override;
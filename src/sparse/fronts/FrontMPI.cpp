@@ -268,9 +268,9 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontMPI<scalar_t,integer_t>::extend_add_copy_from_buffers
   (DistM_t& F11, DistM_t& F12, DistM_t& F21, DistM_t& F22, scalar_t** pbuf,
-   const FrontMPI<scalar_t,integer_t>* pa) const {
+   const FrontMPI<scalar_t,integer_t>* pa, int src) const {
     ExtendAdd<scalar_t,integer_t>::extend_add_copy_from_buffers
-      (F11, F12, F21, F22, pbuf, pa, this);
+      (F11, F12, F21, F22, pbuf, pa, this, src);
   }
 
   template<typename scalar_t,typename integer_t> void
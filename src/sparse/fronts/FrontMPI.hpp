@@ -104,8 +104,8 @@ namespace strumpack {
 
     void extend_add_copy_from_buffers(DistM_t& F11, DistM_t& F12,
                                       DistM_t& F21, DistM_t& F22,
-                                      scalar_t** pbuf, const FMPI_t* pa)
-      const override;
+                                      scalar_t** pbuf, const FMPI_t* pa,
+                                      int src=-1) const override;
     void extend_add_column_copy_to_buffers(const DistM_t& CB,
                                            const DenseM_t& seqCB,
                                            std::vector<std::vector<scalar_t>>& sbuf,
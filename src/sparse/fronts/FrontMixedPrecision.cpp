@@ -0,0 +1,216 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "FrontMixedPrecision.hpp"
+#include "PanelSolve.hpp"
+
+namespace strumpack {
+
+  // copy of A, converted to scalar type to_t
+  template<typename to_t, typename from_t> DenseMatrix<to_t>
+  convert(const DenseMatrix<from_t>& A) {
+    DenseMatrix<to_t> B(A.rows(), A.cols());
+    copy(A, B, 0, 0);
+    return B;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  FrontMixedPrecision<scalar_t,integer_t>::FrontMixedPrecision
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd)
+    : FD_t(sep, sep_begin, sep_end, upd) {}
+
+  template<typename scalar_t,typename integer_t> void
+  FrontMixedPrecision<scalar_t,integer_t>::delete_factors() {
+    FD_t::delete_factors();
+    F11l_ = DenseML_t();
+    F12l_ = DenseML_t();
+    F21l_ = DenseML_t();
+    low_ = false;
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontMixedPrecision<scalar_t,integer_t>::node_factor_nonzeros() const {
+    auto nnz = FD_t::node_factor_nonzeros();
+    return low_ ? nnz * sizeof(low_t) / sizeof(scalar_t) : nnz;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontMixedPrecision<scalar_t,integer_t>::factor_phase2
+  (const SpMat_t& A, const Opts_t& opts, int etree_level, int task_depth) {
+    using real_t = typename RealType<low_t>::value_type;
+    const std::size_t dsep = this->dim_sep(), dupd = this->dim_upd();
+    low_ = false;
+    if (std::is_same<low_t,scalar_t>::value || !dsep)
+      return FD_t::factor_phase2(A, opts, etree_level, task_depth);
+    TRACE_FRONT("factor_mixed");
+    real_t maxA(0.), maxU(0.);
+    for (std::size_t j=0; j<dsep; j++)
+      for (std::size_t i=0; i<dsep; i++)
+        maxA = std::max(maxA, real_t(std::abs(this->F11_(i, j))));
+    auto F11 = convert<low_t>(this->F11_);
+    std::vector<int> piv;
+    int info = F11.LU(piv, task_depth);
+    // pivot growth, max|U| / max|F11|
+    bool finite = true;
+    for (std::size_t j=0; j<dsep; j++)
+      for (std::size_t i=0; i<=j; i++) {
+        auto u = std::abs(F11(i, j));
+        if (!std::isfinite(u)) finite = false;
+        maxU = std::max(maxU, u);
+      }
+    if (info || !finite ||
+        maxU > opts.mixed_precision_pivot_growth() * maxA)
+      return FD_t::factor_phase2(A, opts, etree_level, task_depth);
+    if (opts.replace_tiny_pivots()) {
+      real_t thresh = opts.pivot_threshold();
+      for (std::size_t i=0; i<dsep; i++)
+        if (std::abs(F11(i,i)) < thresh)
+          F11(i,i) = (std::real(F11(i,i)) < 0) ? -thresh : thresh;
+    }
+    auto F12 = convert<low_t>(this->F12_);
+    auto F21 = convert<low_t>(this->F21_);
+    this->F11_ = DenseM_t();
+    this->F12_ = DenseM_t();
+    this->F21_ = DenseM_t();
+    if (dupd) {
+      F12.laswp(piv, true);
+      trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+           low_t(1.), F11, F12, task_depth);
+      trsm(Side::R, UpLo::U, Trans::N, Diag::N,
+           low_t(1.), F11, F21, task_depth);
+      // compute the Schur complement update in lower precision, one
+      // column panel at a time, and add it to F22 in full precision
+      const std::size_t nb = std::min(dupd, std::size_t(256));
+      DenseML_t W(dupd, nb);
+      for (std::size_t c0=0; c0<dupd; c0+=nb) {
+        const std::size_t w = std::min(nb, dupd-c0);
+        DenseMLW_t Wc(dupd, w, W, 0, 0), F12c(dsep, w, F12, 0, c0);
+        gemm(Trans::N, Trans::N, low_t(1.), F21, F12c,
+             low_t(0.), Wc, task_depth);
+        for (std::size_t j=0; j<w; j++)
+          for (std::size_t i=0; i<dupd; i++)
+            this->F22_(i, c0+j) -= static_cast<scalar_t>(Wc(i, j));
+      }
+    }
+    F11l_ = std::move(F11);
+    F12l_ = std::move(F12);
+    F21l_ = std::move(F21);
+    this->piv_ = std::move(piv);
+    low_ = true;
+    STRUMPACK_FULL_RANK_FLOPS
+      (LU_flops(F11l_) +
+       gemm_flops(Trans::N, Trans::N, low_t(-1.), F21l_, F12l_, low_t(1.)) +
+       trsm_flops(Side::L, low_t(1.), F11l_, F12l_) +
+       trsm_flops(Side::R, low_t(1.), F11l_, F21l_));
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontMixedPrecision<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    if (!low_) {
+      FD_t::fwd_solve_phase2(b, bupd, etree_level, task_depth);
+      return;
+    }
+    TRACE_FRONT("fwd_solve");
+    DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
+    bloc.laswp(this->piv_, true);
+    auto bl = convert<low_t>(bloc);
+    DenseML_t ul(bupd.rows(), bupd.cols());
+    ul.zero();
+    factors_fwd_solve(F11l_, F21l_, bl, ul, task_depth);
+    copy(bl, bloc, 0, 0);
+    for (std::size_t j=0; j<bupd.cols(); j++)
+      for (std::size_t i=0; i<bupd.rows(); i++)
+        bupd(i, j) += static_cast<scalar_t>(ul(i, j));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontMixedPrecision<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    if (!low_) {
+      FD_t::bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      return;
+    }
+    TRACE_FRONT("bwd_solve");
+    DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
+    auto yl = convert<low_t>(yloc);
+    auto ul = convert<low_t>(yupd);
+    factors_bwd_solve(F11l_, F12l_, yl, ul, task_depth);
+    copy(yl, yloc, 0, 0);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontMixedPrecision<scalar_t,integer_t>::node_inertia
+  (integer_t& neg, integer_t& zero, integer_t& pos) const {
+    if (!low_) return FD_t::node_inertia(neg, zero, pos);
+    return this->matrix_inertia
+      (convert<scalar_t>(F11l_), neg, zero, pos);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontMixedPrecision<scalar_t,integer_t>::node_subnormals
+  (std::size_t& ns, std::size_t& nz) const {
+    if (!low_) return FD_t::node_subnormals(ns, nz);
+    ns += F11l_.subnormals() + F12l_.subnormals() + F21l_.subnormals();
+    nz += F11l_.zeros() + F12l_.zeros() + F21l_.zeros();
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontMixedPrecision<scalar_t,integer_t>::node_pivot_growth
+  (scalar_t& pgL, scalar_t& pgU) const {
+    if (!low_) return FD_t::node_pivot_growth(pgL, pgU);
+    for (std::size_t i=0; i<F11l_.rows(); i++)
+      pgU = std::max(std::abs(pgU), std::abs(scalar_t(F11l_(i, i))));
+    pgL = std::max(std::abs(pgL), std::abs(scalar_t(1.)));
+    return ReturnCode::SUCCESS;
+  }
+
+  // explicit template instantiations
+  template class FrontMixedPrecision<float,int>;
+  template class FrontMixedPrecision<double,int>;
+  template class FrontMixedPrecision<std::complex<float>,int>;
+  template class FrontMixedPrecision<std::complex<double>,int>;
+
+  template class FrontMixedPrecision<float,long int>;
+  template class FrontMixedPrecision<double,long int>;
+  template class FrontMixedPrecision<std::complex<float>,long int>;
+  template class FrontMixedPrecision<std::complex<double>,long int>;
+
+  template class FrontMixedPrecision<float,long long int>;
+  template class FrontMixedPrecision<double,long long int>;
+  template class FrontMixedPrecision<std::complex<float>,long long int>;
+  template class FrontMixedPrecision<std::complex<double>,long long int>;
+
+} // end namespace strumpack
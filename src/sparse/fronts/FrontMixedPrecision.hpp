@@ -0,0 +1,114 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_MIXED_PRECISION_HPP
+#define FRONTAL_MATRIX_MIXED_PRECISION_HPP
+
+#include "FrontDense.hpp"
+
+namespace strumpack {
+
+  /**
+   * Lower precision scalar type used to factor a front with scalar
+   * type T, float for double and std::complex<float> for
+   * std::complex<double>. Single precision types map to themselves.
+   */
+  template<typename T> struct LowerPrecision { using type = T; };
+  template<> struct LowerPrecision<double> { using type = float; };
+  template<> struct LowerPrecision<std::complex<double>> {
+    using type = std::complex<float>;
+  };
+
+  /**
+   * Dense front which is assembled in the precision of scalar_t, but
+   * factored and stored in lower precision (see LowerPrecision). The
+   * Schur complement update is computed in lower precision and added
+   * to the contribution block in full precision, so the parent does
+   * not need to know the precision of this front. The forward and
+   * backward solve convert the right hand side to lower precision.
+   *
+   * If the lower precision LU has a zero pivot, or a pivot growth
+   * larger than SPOptions::mixed_precision_pivot_growth(), the front
+   * is factored in full precision instead, as a FrontDense.
+   */
+  template<typename scalar_t,typename integer_t> class FrontMixedPrecision
+    : public FrontDense<scalar_t,integer_t> {
+    using F_t = Front<scalar_t,integer_t>;
+    using FD_t = FrontDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+    using Opts_t = SPOptions<scalar_t>;
+    using low_t = typename LowerPrecision<scalar_t>::type;
+    using DenseML_t = DenseMatrix<low_t>;
+    using DenseMLW_t = DenseMatrixWrapper<low_t>;
+
+  public:
+    FrontMixedPrecision(integer_t sep, integer_t sep_begin,
+                        integer_t sep_end, std::vector<integer_t>& upd);
+
+    std::string type() const override { return "FrontMixedPrecision"; }
+
+    /**
+     * Are the factors of this front stored in lower precision? This
+     * is false before the factorization, or when the front was
+     * factored in full precision.
+     */
+    bool lower_precision() const { return low_; }
+
+    void delete_factors() override;
+
+    // in units of scalar_t, like the compressed fronts
+    long long node_factor_nonzeros() const override;
+
+  private:
+    DenseML_t F11l_, F12l_, F21l_;
+    bool low_ = false;
+
+    ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
+                             int etree_level, int task_depth) override;
+
+    void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+
+    ReturnCode node_inertia(integer_t& neg, integer_t& zero,
+                            integer_t& pos) const override;
+    ReturnCode node_subnormals(std::size_t& ns,
+                               std::size_t& nz) const override;
+    ReturnCode node_pivot_growth(scalar_t& pgL,
+                                 scalar_t& pgU) const override;
+
+    FrontMixedPrecision(const FrontMixedPrecision&) = delete;
+    FrontMixedPrecision& operator=(FrontMixedPrecision const&) = delete;
+  };
+
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_MIXED_PRECISION_HPP
@@ -0,0 +1,308 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_PANEL_SOLVE_HPP
+#define STRUMPACK_PANEL_SOLVE_HPP
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "dense/DenseMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * Least recently used cache of decompressed front factors, shared
+   * by all compressed (lossy/lossless) fronts with the same scalar
+   * type. Repeated solves with the same factorization can keep the
+   * hottest fronts in decompressed form, up to a total number of
+   * bytes, instead of decompressing them again for every solve. An
+   * entry is handed out as a shared_ptr, so it remains valid for the
+   * duration of a solve, even if it is evicted concurrently.
+   *
+   * The cache is only used when a non-zero capacity is set with
+   * SPOptions::set_compressed_solve_cache.
+   */
+  template<typename scalar_t> class DecompressedFrontCache {
+    using DenseM_t = DenseMatrix<scalar_t>;
+  public:
+    struct Factors {
+      DenseM_t F11, F12, F21;
+      std::size_t bytes() const {
+        return (F11.rows()*F11.cols() + F12.rows()*F12.cols() +
+                F21.rows()*F21.cols()) * sizeof(scalar_t);
+      }
+    };
+    using Factors_ptr = std::shared_ptr<const Factors>;
+
+    static DecompressedFrontCache<scalar_t>& instance() {
+      static DecompressedFrontCache<scalar_t> c;
+      return c;
+    }
+
+    /**
+     * Return the cached factors for front key, or nullptr. A hit
+     * moves the entry to the front of the LRU list.
+     */
+    Factors_ptr find(const void* key) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      auto e = map_.find(key);
+      if (e == map_.end()) return nullptr;
+      lru_.splice(lru_.begin(), lru_, e->second);
+      return e->second->f;
+    }
+
+    /**
+     * Insert the factors for front key, evicting least recently used
+     * entries until the total size is at most capacity bytes. Does
+     * nothing if f by itself is larger than capacity.
+     */
+    void insert(const void* key, Factors_ptr f, std::size_t capacity) {
+      auto b = f->bytes();
+      if (b > capacity) return;
+      std::lock_guard<std::mutex> lock(mtx_);
+      erase_locked(key);
+      while (!lru_.empty() && bytes_ + b > capacity) {
+        bytes_ -= lru_.back().bytes;
+        map_.erase(lru_.back().key);
+        lru_.pop_back();
+      }
+      lru_.push_front(Entry{key, std::move(f), b});
+      map_.emplace(key, lru_.begin());
+      bytes_ += b;
+    }
+
+    /**
+     * Remove the entry for front key, should be called whenever the
+     * front is destroyed or refactored, even if the front does not
+     * use the cache (anymore). Does nothing if there is no entry.
+     */
+    void erase(const void* key) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      erase_locked(key);
+    }
+
+    std::size_t bytes() const { return bytes_; }
+
+  private:
+    struct Entry {
+      const void* key;
+      Factors_ptr f;
+      std::size_t bytes;
+    };
+    std::mutex mtx_;
+    std::list<Entry> lru_;
+    std::unordered_map<const void*,
+                       typename std::list<Entry>::iterator> map_;
+    std::size_t bytes_ = 0;
+
+    DecompressedFrontCache() = default;
+
+    void erase_locked(const void* key) {
+      auto e = map_.find(key);
+      if (e == map_.end()) return;
+      bytes_ -= e->second->bytes;
+      lru_.erase(e->second);
+      map_.erase(e);
+    }
+  };
+
+
+  /*
+   * Forward and backward solve with the (fully decompressed) factors
+   * of a front, bloc and yloc have already been permuted.
+   */
+  template<typename scalar_t> void
+  factors_fwd_solve(const DenseMatrix<scalar_t>& F11,
+                    const DenseMatrix<scalar_t>& F21,
+                    DenseMatrix<scalar_t>& bloc, DenseMatrix<scalar_t>& bupd,
+                    int task_depth) {
+    if (bloc.cols() == 1) {
+      trsv(UpLo::L, Trans::N, Diag::U, F11, bloc, task_depth);
+      if (bupd.rows())
+        gemv(Trans::N, scalar_t(-1.), F21, bloc,
+             scalar_t(1.), bupd, task_depth);
+    } else {
+      trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+           scalar_t(1.), F11, bloc, task_depth);
+      if (bupd.rows())
+        gemm(Trans::N, Trans::N, scalar_t(-1.), F21, bloc,
+             scalar_t(1.), bupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t> void
+  factors_bwd_solve(const DenseMatrix<scalar_t>& F11,
+                    const DenseMatrix<scalar_t>& F12,
+                    DenseMatrix<scalar_t>& yloc, DenseMatrix<scalar_t>& yupd,
+                    int task_depth) {
+    if (yloc.cols() == 1) {
+      if (yupd.rows())
+        gemv(Trans::N, scalar_t(-1.), F12, yupd,
+             scalar_t(1.), yloc, task_depth);
+      trsv(UpLo::U, Trans::N, Diag::N, F11, yloc, task_depth);
+    } else {
+      if (yupd.rows())
+        gemm(Trans::N, Trans::N, scalar_t(-1.), F12, yupd,
+             scalar_t(1.), yloc, task_depth);
+      trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.),
+           F11, yloc, task_depth);
+    }
+  }
+
+  /*
+   * Selected inversion (Takahashi recurrences) for a single front,
+   * with LU factors P F11 = L11 U11, F12 = U12 = L11^{-1} P A12 and
+   * F21 = L21 = A21 U11^{-1}. Given the block Zuu of the inverse for
+   * the update indices, this computes the inverse on all indices of
+   * the front, Z = [Zss Zsu; Zus Zuu], as
+   *   Zus = -Zuu L21 L11^{-1} P
+   *   Zsu = -U11^{-1} U12 Zuu
+   *   Zss = U11^{-1} (L11^{-1} P - U12 Zus)
+   */
+  template<typename scalar_t> void
+  factors_selected_inverse(const DenseMatrix<scalar_t>& F11,
+                           const DenseMatrix<scalar_t>& F12,
+                           const DenseMatrix<scalar_t>& F21,
+                           const std::vector<int>& piv,
+                           const DenseMatrix<scalar_t>& Zuu,
+                           DenseMatrix<scalar_t>& Z, int task_depth) {
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    const std::size_t ds = F11.rows(), du = Zuu.rows();
+    Z = DenseMatrix<scalar_t>(ds+du, ds+du);
+    DenseMW_t Zss(ds, ds, Z, 0, 0), Zsu(ds, du, Z, 0, ds),
+      Zus(du, ds, Z, ds, 0), Zu(du, du, Z, ds, ds);
+    Zss.eye();
+    Zss.laswp(piv, true);
+    trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+         scalar_t(1.), F11, Zss, task_depth);
+    if (du) {
+      Zu.copy(Zuu);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), Zuu, F21,
+           scalar_t(0.), Zus, task_depth);
+      trsm(Side::R, UpLo::L, Trans::N, Diag::U,
+           scalar_t(1.), F11, Zus, task_depth);
+      // Zus * P, undo the row interchanges as column interchanges
+      for (std::size_t k=ds; k-->0; ) {
+        std::size_t p = piv[k] - 1;
+        if (p != k)
+          for (std::size_t i=0; i<du; i++)
+            std::swap(Zus(i, k), Zus(i, p));
+      }
+      gemm(Trans::N, Trans::N, scalar_t(-1.), F12, Zuu,
+           scalar_t(0.), Zsu, task_depth);
+      trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+           scalar_t(1.), F11, Zsu, task_depth);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), F12, Zus,
+           scalar_t(1.), Zss, task_depth);
+    }
+    trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+         scalar_t(1.), F11, Zss, task_depth);
+  }
+
+  /*
+   * Forward and backward solve with the factors of a front which
+   * are only available one column panel at a time, for instance
+   * because they are stored compressed. The panels of F11, F12 and
+   * F21 are nb columns wide (the last one can be narrower).
+   *
+   * The F11 panel callback is called as F11(j, r0, r1, P), and
+   * should at least fill rows [r0, r1) of column panel j of F11 in
+   * P, where P has dim_sep rows. Rows outside that range are not
+   * accessed. Likewise F21(j, P) fills panel j (all rows) of F21,
+   * and F12(j, P) fills panel j of F12. Only a single panel of each
+   * is kept in memory.
+   */
+  template<typename scalar_t, typename F11_t, typename F21_t> void
+  panel_fwd_solve(std::size_t nb, F11_t&& F11, F21_t&& F21,
+                  DenseMatrix<scalar_t>& bloc, DenseMatrix<scalar_t>& bupd,
+                  int task_depth) {
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    const std::size_t ds = bloc.rows(), du = bupd.rows(), n = bloc.cols();
+    if (!ds) return;
+    DenseM_t P(ds, std::min(nb, ds)), Q(du, du ? std::min(nb, ds) : 0);
+    for (std::size_t j=0, c0=0; c0<ds; j++, c0+=nb) {
+      const std::size_t w = std::min(nb, ds-c0), c1 = c0 + w;
+      DenseMW_t Pj(ds, w, P.data(), P.ld());
+      F11(j, c0, ds, Pj);
+      DenseMW_t Pd(w, w, Pj, c0, 0), bj(w, n, bloc, c0, 0);
+      if (n == 1) trsv(UpLo::L, Trans::N, Diag::U, Pd, bj, task_depth);
+      else trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+                scalar_t(1.), Pd, bj, task_depth);
+      if (c1 < ds) {
+        DenseMW_t Pl(ds-c1, w, Pj, c1, 0), bl(ds-c1, n, bloc, c1, 0);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Pl, bj,
+             scalar_t(1.), bl, task_depth);
+      }
+      if (du) {
+        DenseMW_t Qj(du, w, Q.data(), Q.ld());
+        F21(j, Qj);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Qj, bj,
+             scalar_t(1.), bupd, task_depth);
+      }
+    }
+  }
+
+  template<typename scalar_t, typename F11_t, typename F12_t> void
+  panel_bwd_solve(std::size_t nb, F11_t&& F11, F12_t&& F12,
+                  DenseMatrix<scalar_t>& yloc, DenseMatrix<scalar_t>& yupd,
+                  int task_depth) {
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    const std::size_t ds = yloc.rows(), du = yupd.rows(), n = yloc.cols();
+    if (!ds) return;
+    DenseM_t P(ds, std::min(nb, std::max(ds, du)));
+    for (std::size_t j=0, c0=0; c0<du; j++, c0+=nb) {
+      const std::size_t w = std::min(nb, du-c0);
+      DenseMW_t Pj(ds, w, P.data(), P.ld()), yj(w, n, yupd, c0, 0);
+      F12(j, Pj);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), Pj, yj,
+           scalar_t(1.), yloc, task_depth);
+    }
+    for (std::size_t j=(ds+nb-1)/nb; j-->0; ) {
+      const std::size_t c0 = j*nb, w = std::min(nb, ds-c0);
+      DenseMW_t Pj(ds, w, P.data(), P.ld());
+      F11(j, 0, c0+w, Pj);
+      DenseMW_t Pd(w, w, Pj, c0, 0), yj(w, n, yloc, c0, 0);
+      if (n == 1) trsv(UpLo::U, Trans::N, Diag::N, Pd, yj, task_depth);
+      else trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+                scalar_t(1.), Pd, yj, task_depth);
+      if (c0) {
+        DenseMW_t Pu(c0, w, Pj, 0, 0), yu(c0, n, yloc, 0, 0);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Pu, yj,
+             scalar_t(1.), yu, task_depth);
+      }
+    }
+  }
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_PANEL_SOLVE_HPP
@@ -28,6 +28,8 @@
  */
 #include <unordered_map>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
 
 #include "GeometricReordering.hpp"
 
@@ -141,6 +143,172 @@ namespace strumpack {
     return SeparatorTree<integer_t>(tree);
   }
 
+  template<typename integer_t,typename real_t> class CoordOrderData {
+  public:
+    const integer_t *ptr, *ind;
+    const DenseMatrix<real_t>* X;
+    integer_t *perm, *iperm;
+    // subdomain of every vertex, used to restrict the graph
+    std::vector<integer_t> dom;
+    integer_t ndoms;
+    int stratpar;
+  };
+
+  /*
+   * Principal axis of the points in ids, by power iteration on the
+   * covariance matrix. Starts from the coordinate axis with the
+   * largest variance, so this is coordinate bisection if the points
+   * are aligned with the axes.
+   */
+  template<typename integer_t,typename real_t> std::vector<real_t>
+  inertial_axis(const DenseMatrix<real_t>& X,
+                const std::vector<integer_t>& ids,
+                std::vector<real_t>& mean) {
+    const std::size_t d = X.rows();
+    mean.assign(d, real_t(0.));
+    for (auto v : ids)
+      for (std::size_t k=0; k<d; k++)
+        mean[k] += X(k, v);
+    for (auto& m : mean) m /= ids.size();
+    std::vector<real_t> C(d*d, real_t(0.)), e(d, real_t(0.)), t(d);
+    for (auto v : ids)
+      for (std::size_t j=0; j<d; j++)
+        for (std::size_t i=0; i<d; i++)
+          C[i+j*d] += (X(i, v) - mean[i]) * (X(j, v) - mean[j]);
+    std::size_t imax = 0;
+    for (std::size_t i=1; i<d; i++)
+      if (C[i+i*d] > C[imax+imax*d]) imax = i;
+    e[imax] = 1.;
+    for (int it=0; it<50; it++) {
+      real_t nrm = 0., dif = 0.;
+      for (std::size_t i=0; i<d; i++) {
+        t[i] = 0.;
+        for (std::size_t j=0; j<d; j++)
+          t[i] += C[i+j*d] * e[j];
+        nrm += t[i] * t[i];
+      }
+      nrm = std::sqrt(nrm);
+      if (nrm == real_t(0.)) break;
+      for (std::size_t i=0; i<d; i++) {
+        t[i] /= nrm;
+        dif += std::abs(t[i] - e[i]);
+      }
+      e.swap(t);
+      if (dif < 1e-6) break;
+    }
+    return e;
+  }
+
+  template<typename integer_t,typename real_t> void
+  recursive_coordinate_ND(integer_t& pbegin, integer_t& nbsep,
+                          std::vector<integer_t>&& ids,
+                          std::vector<Separator<integer_t>>& tree,
+                          CoordOrderData<integer_t,real_t>& cd) {
+    integer_t N = ids.size();
+    auto order = [&](const std::vector<integer_t>& vs) {
+      for (auto v : vs) {
+        cd.perm[v] = pbegin;
+        cd.iperm[pbegin++] = v;
+      }
+    };
+    auto leaf = [&]() {
+      order(ids);
+      if (nbsep) tree.emplace_back(tree.back().sep_end + N, -1, -1, -1);
+      else tree.emplace_back(N, -1, -1, -1);
+      nbsep++;
+    };
+    if (N <= cd.stratpar) { leaf(); return; }
+
+    // split in two halves at the median along the principal axis
+    std::vector<real_t> mean;
+    auto e = inertial_axis(*cd.X, ids, mean);
+    std::vector<std::pair<real_t,integer_t>> proj(N);
+    for (integer_t i=0; i<N; i++) {
+      auto v = ids[i];
+      real_t t = 0.;
+      for (std::size_t k=0; k<e.size(); k++)
+        t += ((*cd.X)(k, v) - mean[k]) * e[k];
+      proj[i] = {t, v};
+    }
+    std::nth_element(proj.begin(), proj.begin()+N/2, proj.end());
+    integer_t dom[3] = {cd.ndoms, cd.ndoms+1, cd.ndoms+2};
+    cd.ndoms += 3;
+    for (integer_t i=0; i<N; i++)
+      cd.dom[proj[i].second] = (i < N/2) ? dom[0] : dom[1];
+    proj = std::vector<std::pair<real_t,integer_t>>();
+
+    // vertex separator from the smallest of the two boundaries
+    auto connected_to = [&](integer_t v, integer_t d) {
+      for (integer_t j=cd.ptr[v]; j<cd.ptr[v+1]; j++)
+        if (cd.ind[j] != v && cd.dom[cd.ind[j]] == d) return true;
+      return false;
+    };
+    std::vector<integer_t> bnd[2];
+    for (auto v : ids) {
+      int s = (cd.dom[v] == dom[0]) ? 0 : 1;
+      if (connected_to(v, dom[1-s])) bnd[s].push_back(v);
+    }
+    auto& sep = (bnd[0].size() <= bnd[1].size()) ? bnd[0] : bnd[1];
+    for (auto v : sep) cd.dom[v] = dom[2];
+    // move separator vertices back if they only connect to one half
+    std::vector<integer_t> part[2], trimmed;
+    for (auto v : sep) {
+      bool c0 = connected_to(v, dom[0]), c1 = connected_to(v, dom[1]);
+      if (c0 && c1) trimmed.push_back(v);
+      else cd.dom[v] = c0 ? dom[0] : dom[1];
+    }
+    for (auto v : ids) {
+      if (cd.dom[v] == dom[0]) part[0].push_back(v);
+      else if (cd.dom[v] == dom[1]) part[1].push_back(v);
+    }
+    if (part[0].empty() || part[1].empty()) { leaf(); return; }
+    ids = std::vector<integer_t>();
+    bnd[0] = bnd[1] = std::vector<integer_t>();
+
+    recursive_coordinate_ND(pbegin, nbsep, std::move(part[0]), tree, cd);
+    auto left_root_id = nbsep - 1;
+    recursive_coordinate_ND(pbegin, nbsep, std::move(part[1]), tree, cd);
+    tree[left_root_id].pa = nbsep;
+    tree[nbsep-1].pa = nbsep;
+    order(trimmed);
+    tree.emplace_back
+      (tree.back().sep_end + integer_t(trimmed.size()),
+       -1, left_root_id, nbsep-1);
+    nbsep++;
+  }
+
+  template<typename integer_t,typename scalar_t>
+  SeparatorTree<integer_t>
+  geometric_ND(const CompressedSparseMatrix<scalar_t,integer_t>& A,
+               const DenseMatrix<typename RealType<scalar_t>::value_type>&
+               coords,
+               std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+               const SPOptions<scalar_t>& opts) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    integer_t n = A.size();
+    if (integer_t(coords.cols()) != n || coords.rows() == 0) {
+      std::cerr << "# ERROR: Geometric reordering failed. \n"
+        "# The coordinates should be a d x N matrix,"
+        " with N the matrix size." << std::endl;
+      return SeparatorTree<integer_t>();
+    }
+    CoordOrderData<integer_t,real_t> cd;
+    cd.ptr = A.ptr();
+    cd.ind = A.ind();
+    cd.X = &coords;
+    cd.perm = perm.data();
+    cd.iperm = iperm.data();
+    cd.dom.assign(n, 0);
+    cd.ndoms = 1;
+    cd.stratpar = std::max(1, opts.nd_param());
+    std::vector<integer_t> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::vector<Separator<integer_t>> tree;
+    integer_t nbsep = 0, pbegin = 0;
+    recursive_coordinate_ND(pbegin, nbsep, std::move(ids), tree, cd);
+    return SeparatorTree<integer_t>(tree);
+  }
+
   template SeparatorTree<int>
   geometric_ND(const CompressedSparseMatrix<float,int>& A,
                int nx, int ny, int nz, int components, int width,
@@ -204,4 +372,67 @@ namespace strumpack {
                std::vector<long long int>& perm, std::vector<long long int>& iperm,
                const SPOptions<std::complex<double>>& opts);
 
+  template SeparatorTree<int>
+  geometric_ND(const CompressedSparseMatrix<float,int>& A,
+               const DenseMatrix<float>& coords,
+               std::vector<int>& perm, std::vector<int>& iperm,
+               const SPOptions<float>& opts);
+  template SeparatorTree<int>
+  geometric_ND(const CompressedSparseMatrix<double,int>& A,
+               const DenseMatrix<double>& coords,
+               std::vector<int>& perm, std::vector<int>& iperm,
+               const SPOptions<double>& opts);
+  template SeparatorTree<int>
+  geometric_ND(const CompressedSparseMatrix<std::complex<float>,int>& A,
+               const DenseMatrix<float>& coords,
+               std::vector<int>& perm, std::vector<int>& iperm,
+               const SPOptions<std::complex<float>>& opts);
+  template SeparatorTree<int>
+  geometric_ND(const CompressedSparseMatrix<std::complex<double>,int>& A,
+               const DenseMatrix<double>& coords,
+               std::vector<int>& perm, std::vector<int>& iperm,
+               const SPOptions<std::complex<double>>& opts);
+
+  template SeparatorTree<long int>
+  geometric_ND(const CompressedSparseMatrix<float,long int>& A,
+               const DenseMatrix<float>& coords,
+               std::vector<long int>& perm, std::vector<long int>& iperm,
+               const SPOptions<float>& opts);
+  template SeparatorTree<long int>
+  geometric_ND(const CompressedSparseMatrix<double,long int>& A,
+               const DenseMatrix<double>& coords,
+               std::vector<long int>& perm, std::vector<long int>& iperm,
+               const SPOptions<double>& opts);
+  template SeparatorTree<long int>
+  geometric_ND(const CompressedSparseMatrix<std::complex<float>,long int>& A,
+               const DenseMatrix<float>& coords,
+               std::vector<long int>& perm, std::vector<long int>& iperm,
+               const SPOptions<std::complex<float>>& opts);
+  template SeparatorTree<long int>
+  geometric_ND(const CompressedSparseMatrix<std::complex<double>,long int>& A,
+               const DenseMatrix<double>& coords,
+               std::vector<long int>& perm, std::vector<long int>& iperm,
+               const SPOptions<std::complex<double>>& opts);
+
+  template SeparatorTree<long long int>
+  geometric_ND(const CompressedSparseMatrix<float,long long int>& A,
+               const DenseMatrix<float>& coords,
+               std::vector<long long int>& perm, std::vector<long long int>& iperm,
+               const SPOptions<float>& opts);
+  template SeparatorTree<long long int>
+  geometric_ND(const CompressedSparseMatrix<double,long long int>& A,
+               const DenseMatrix<double>& coords,
+               std::vector<long long int>& perm, std::vector<long long int>& iperm,
+               const SPOptions<double>& opts);
+  template SeparatorTree<long long int>
+  geometric_ND(const CompressedSparseMatrix<std::complex<float>,long long int>& A,
+               const DenseMatrix<float>& coords,
+               std::vector<long long int>& perm, std::vector<long long int>& iperm,
+               const SPOptions<std::complex<float>>& opts);
+  template SeparatorTree<long long int>
+  geometric_ND(const CompressedSparseMatrix<std::complex<double>,long long int>& A,
+               const DenseMatrix<double>& coords,
+               std::vector<long long int>& perm, std::vector<long long int>& iperm,
+               const SPOptions<std::complex<double>>& opts);
+
 } // end namespace strumpack
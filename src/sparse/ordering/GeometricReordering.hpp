@@ -35,6 +35,7 @@
 #include "StrumpackOptions.hpp"
 #include "sparse/SeparatorTree.hpp"
 #include "sparse/CSRMatrix.hpp"
+#include "dense/DenseMatrix.hpp"
 
 namespace strumpack {
 
@@ -45,6 +46,28 @@ namespace strumpack {
                std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
                const SPOptions<scalar_t>& opts);
 
+  /**
+   * Nested dissection for a matrix with given (mesh) point
+   * coordinates, by recursive inertial bisection. Every subdomain is
+   * split in two halves by the median of the coordinates projected
+   * on the principal axis, and the separator is taken from the
+   * boundary of these halves in the graph of A.
+   *
+   * \param A matrix, should have a symmetric sparsity pattern
+   * \param coords d x A.size() matrix, column i has the coordinates
+   * of point/row i
+   * \param perm on output, permutation
+   * \param iperm on output, inverse permutation
+   * \param opts the opts.nd_param() is used as stopping criterion
+   */
+  template<typename integer_t,typename scalar_t>
+  SeparatorTree<integer_t>
+  geometric_ND(const CompressedSparseMatrix<scalar_t,integer_t>& A,
+               const DenseMatrix<typename RealType<scalar_t>::value_type>&
+               coords,
+               std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+               const SPOptions<scalar_t>& opts);
+
 } // end namespace strumpack
 
 #endif
@@ -35,6 +35,7 @@
 
 #include "StrumpackOptions.hpp"
 #include "StrumpackConfig.hpp"
+#include "StrumpackParameters.hpp"
 #include "sparse/fronts/Front.hpp"
 #include "sparse/SeparatorTree.hpp"
 #include "sparse/CSRMatrix.hpp"
@@ -54,10 +55,11 @@
 #endif
 #include "RCMReordering.hpp"
 #include "ANDSparspak.hpp"
+#include "ParallelND.hpp"
 #include "GeometricReordering.hpp"
 #include "minimum_degree/AMDReordering.hpp"
 #include "minimum_degree/MMDReordering.hpp"
-// #include "spectral/SpectralReordering.hpp"
+#include "minimum_degree/MLFReordering.hpp"
 
 namespace strumpack {
 
@@ -73,6 +75,9 @@ namespace strumpack {
   MatrixReordering<scalar_t,integer_t>::nested_dissection
   (const Opts_t& opts, const CSR_t& A,
    int nx, int ny, int nz, int components, int width) {
+    // the OpenMP parallel nested dissection is only worth it when
+    // the tree is also traversed in parallel
+    bool par_nd = opts.use_openmp_tree() && params::num_threads > 1;
     switch (opts.reordering_method()) {
     case ReorderingStrategy::NATURAL: {
       std::iota(perm_.begin(), perm_.end(), 0);
@@ -80,10 +85,18 @@ namespace strumpack {
       break;
     }
     case ReorderingStrategy::METIS: {
-      tree_ = metis_nested_dissection(A, perm_, iperm_, opts);
+      if (par_nd && opts.use_parallel_nd())
+        tree_ = ordering::parallel_nd_reordering
+          (A, perm_, iperm_, opts.nd_param());
+      else tree_ = metis_nested_dissection(A, perm_, iperm_, opts);
       break;
     }
     case ReorderingStrategy::SCOTCH: {
+      if (par_nd && opts.use_parallel_nd()) {
+        tree_ = ordering::parallel_nd_reordering
+          (A, perm_, iperm_, opts.nd_param());
+        break;
+      }
 #if defined(STRUMPACK_USE_SCOTCH)
       tree_ = scotch_nested_dissection(A, perm_, iperm_, opts);
 #else
@@ -111,19 +124,20 @@ namespace strumpack {
       break;
     }
     case ReorderingStrategy::AND: {
-      tree_ = ordering::and_reordering(A, perm_, iperm_);
+      if (par_nd)
+        tree_ = ordering::parallel_nd_reordering
+          (A, perm_, iperm_, opts.nd_param());
+      else tree_ = ordering::and_reordering(A, perm_, iperm_);
       break;
     }
     case ReorderingStrategy::MLF: {
-      std::cerr << "# ERROR: MLF ordering not supported." << std::endl;
-      return 1;
+      tree_ = ordering::mlf_reordering(A, perm_, iperm_);
+      break;
     }
     case ReorderingStrategy::SPECTRAL: {
-      std::cerr << "# ERROR: spectral ordering not supported." << std::endl;
-      return 1;
-      // tree_ = ordering::spectral_nd
-      //   (A, perm_, iperm_, opts.ND_options());
-      // break;
+      tree_ = ordering::parallel_nd_reordering
+        (A, perm_, iperm_, opts.nd_param(), ordering::NDBisection::SPECTRAL);
+      break;
     }
     default:
       std::cerr << "# ERROR: parallel matrix reorderings are"
@@ -136,6 +150,21 @@ namespace strumpack {
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  MatrixReordering<scalar_t,integer_t>::nested_dissection
+  (const Opts_t& opts, const CSR_t& A, const DenseMatrix<real_t>& coords) {
+    tree_ = geometric_ND(A, coords, perm_, iperm_, opts);
+    if (!tree_.separators()) return 1;
+    auto d = coords.rows();
+    coords_ = DenseMatrix<real_t>(d, coords.cols());
+    for (std::size_t i=0; i<coords.cols(); i++)
+      for (std::size_t k=0; k<d; k++)
+        coords_(k, i) = coords(k, iperm_[i]);
+    tree_.check();
+    nested_dissection_print(opts, A.nnz(), opts.verbose());
+    return 0;
+  }
+
   template<typename scalar_t,typename integer_t> int
   MatrixReordering<scalar_t,integer_t>::set_permutation
   (const Opts_t& opts, const CSR_t& A, const int* p, int base) {
@@ -149,20 +178,121 @@ namespace strumpack {
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::move_to_root
+  (const std::vector<integer_t>& S) {
+    integer_t n = perm_.size(), ns = tree_.separators(), nS = S.size(),
+      nI = n - nS;
+    // nothing to move if the reordering did not produce a tree
+    if (!ns) return;
+    std::vector<bool> inS(n, false);
+    for (auto i : S) inS[i] = true;
+    // new position of each position in the current ordering
+    std::vector<integer_t> pos(n);
+    SeparatorTree<integer_t> t(nI ? ns+2 : 1);
+    integer_t cnt = 0;
+    for (integer_t s=0; s<ns; s++) {
+      t.sizes[s] = cnt;
+      for (integer_t i=tree_.sizes[s]; i<tree_.sizes[s+1]; i++)
+        if (!inS[iperm_[i]]) pos[i] = cnt++;
+    }
+    for (integer_t k=0; k<nS; k++)
+      pos[perm_[S[k]]] = nI + k;
+    if (nI) {
+      std::copy(tree_.parent, tree_.parent+ns, t.parent);
+      std::copy(tree_.lch, tree_.lch+ns, t.lch);
+      std::copy(tree_.rch, tree_.rch+ns, t.rch);
+      // empty leaf ns, new root ns+1
+      t.sizes[ns] = t.sizes[ns+1] = nI;
+      t.sizes[ns+2] = n;
+      t.parent[tree_.root()] = t.parent[ns] = ns+1;
+      t.lch[ns] = t.rch[ns] = -1;
+      t.parent[ns+1] = -1;
+      t.lch[ns+1] = tree_.root();
+      t.rch[ns+1] = ns;
+    } else {
+      t.sizes[0] = 0;
+      t.sizes[1] = n;
+      t.parent[0] = t.lch[0] = t.rch[0] = -1;
+    }
+    for (integer_t i=0; i<n; i++)
+      perm_[iperm_[i]] = pos[i];
+    for (integer_t i=0; i<n; i++)
+      iperm_[perm_[i]] = i;
+    if (coords_.cols()) {
+      DenseMatrix<real_t> c(coords_.rows(), n);
+      for (integer_t i=0; i<n; i++)
+        for (std::size_t k=0; k<c.rows(); k++)
+          c(k, pos[i]) = coords_(k, i);
+      coords_ = std::move(c);
+    }
+    tree_ = std::move(t);
+    tree_.check();
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::clear_tree_data() {
     tree_ = SeparatorTree<integer_t>();
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::write(std::ostream& os) const {
+    write_binary(os, perm_);
+    write_binary(os, tree_.separators());
+    auto ns = tree_.separators();
+    write_binary(os, std::vector<integer_t>(tree_.sizes, tree_.sizes+ns+1));
+    write_binary(os, std::vector<integer_t>(tree_.parent, tree_.parent+ns));
+    write_binary(os, std::vector<integer_t>(tree_.lch, tree_.lch+ns));
+    write_binary(os, std::vector<integer_t>(tree_.rch, tree_.rch+ns));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::read(std::istream& is) {
+    auto n = perm_.size();
+    read_binary(is, perm_);
+    if (perm_.size() != n)
+      throw std::runtime_error("permutation has the wrong size");
+    for (std::size_t i=0; i<n; i++) {
+      if (perm_[i] < 0 || std::size_t(perm_[i]) >= n)
+        throw std::runtime_error("invalid permutation");
+      iperm_[perm_[i]] = i;
+    }
+    integer_t ns;
+    read_binary(is, ns);
+    tree_ = SeparatorTree<integer_t>(ns);
+    std::vector<integer_t> v;
+    integer_t* t[4] = {tree_.sizes, tree_.parent, tree_.lch, tree_.rch};
+    for (int k=0; k<4; k++) {
+      read_binary(is, v);
+      if (v.size() != std::size_t(k ? ns : ns+1))
+        throw std::runtime_error("invalid separator tree");
+      std::copy(v.begin(), v.end(), t[k]);
+    }
+    if (ns && std::size_t(tree_.sizes[ns]) != n)
+      throw std::runtime_error("invalid separator tree");
+    tree_.check();
+  }
+
   // reorder the vertices in the separator to get a better rank structure
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::separator_reordering
   (const Opts_t& opts, CSR_t& A, F_t* F) {
     auto N = A.size();
     std::vector<integer_t> sorder(N);
+    if (coords_.cols()) {
 #pragma omp parallel
 #pragma omp single
-    F->partition_fronts(opts, A, sorder.data());
+      F->partition_fronts(opts, A, coords_, sorder.data());
+      DenseMatrix<real_t> c(coords_.rows(), N);
+      for (integer_t i=0; i<N; i++)
+        for (std::size_t k=0; k<c.rows(); k++)
+          c(k, sorder[i]) = coords_(k, i);
+      coords_ = std::move(c);
+    } else {
+#pragma omp parallel
+#pragma omp single
+      F->partition_fronts(opts, A, sorder.data());
+    }
     for (integer_t i=0; i<N; i++) iperm_[sorder[i]] = i;
     A.permute(iperm_, sorder);
     // product of perm_ and sep_order
@@ -171,7 +301,15 @@ namespace strumpack {
     std::swap(perm_, iperm_);
 #pragma omp parallel
 #pragma omp single
-    F->permute_CB(sorder.data());
+    {
+      F->permute_CB(sorder.data());
+      F->setup_parent_maps();
+    }
+    if (opts.CB_clustering()) {
+#pragma omp parallel
+#pragma omp single
+      F->cluster_CB(opts);
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
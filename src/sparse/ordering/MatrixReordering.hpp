@@ -38,6 +38,7 @@
 #include "misc/MPIWrapper.hpp"
 #endif
 #include "sparse/SeparatorTree.hpp"
+#include "dense/DenseMatrix.hpp"
 
 namespace strumpack {
 
@@ -48,6 +49,7 @@ namespace strumpack {
     using Opts_t = SPOptions<scalar_t>;
     using CSR_t = CSRMatrix<scalar_t,integer_t>;
     using F_t = Front<scalar_t,integer_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 
   public:
     MatrixReordering(integer_t  n);
@@ -58,19 +60,54 @@ namespace strumpack {
                           int nx, int ny, int nz,
                           int components, int width);
 
+    /**
+     * Nested dissection based on the coordinates of the points, see
+     * geometric_ND. The coordinates are kept (in the new order) to
+     * cluster the separators in separator_reordering.
+     */
+    int nested_dissection(const Opts_t& opts, const CSR_t& A,
+                          const DenseMatrix<real_t>& coords);
+
     int set_permutation(const Opts_t& opts, const CSR_t& A,
                         const int* p, int base);
 
     void separator_reordering(const Opts_t& opts, CSR_t& A, F_t* F);
 
+    /**
+     * Modify the current ordering such that the unknowns in S (in
+     * the original numbering) are ordered last, in the order given,
+     * and form the separator of a new root node. The relative order
+     * of the other unknowns is kept, and they are removed from their
+     * separators in the tree, which remains a valid separator
+     * tree. The new root has the old root and an empty leaf as
+     * children. This is used to compute the Schur complement on S.
+     */
+    void move_to_root(const std::vector<integer_t>& S);
+
     virtual void clear_tree_data();
 
+    /**
+     * Write/read the permutation and the separator tree, see
+     * SparseSolver::save_analysis. read throws a std::runtime_error
+     * if the data does not correspond to a matrix of this size.
+     */
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
+
     const std::vector<integer_t>& perm() const { return perm_; }
     const std::vector<integer_t>& iperm() const { return iperm_; }
 
     const SeparatorTree<integer_t>& tree() const { return tree_; }
     SeparatorTree<integer_t>& tree() { return tree_; }
 
+    /**
+     * Point coordinates, d x N, in the current order, so the
+     * coordinates of separator s are columns tree().sizes[s] to
+     * tree().sizes[s+1]. Empty if the ordering was not computed from
+     * coordinates.
+     */
+    const DenseMatrix<real_t>& coordinates() const { return coords_; }
+
   protected:
     virtual void
     separator_reordering_print(integer_t max_nr_neighbours,
@@ -84,6 +121,7 @@ namespace strumpack {
     std::vector<integer_t> perm_, iperm_;
 
     SeparatorTree<integer_t> tree_;
+    DenseMatrix<real_t> coords_;
 
   private:
     void
@@ -50,7 +50,8 @@
 #include "ANDSparspak.hpp"
 #include "minimum_degree/AMDReordering.hpp"
 #include "minimum_degree/MMDReordering.hpp"
-// #include "spectral/SpectralReordering.hpp"
+#include "minimum_degree/MLFReordering.hpp"
+#include "ParallelND.hpp"
 
 
 namespace strumpack {
@@ -114,15 +115,14 @@ namespace strumpack {
           break;
         }
         case ReorderingStrategy::MLF: {
-          std::cerr << "# ERROR: MLF ordering not supported." << std::endl;
-          return 1;
+          global_sep_tree = ordering::mlf_reordering(*Aseq, perm_, iperm_);
+          break;
         }
         case ReorderingStrategy::SPECTRAL: {
-          std::cerr << "# ERROR: spectral ordering not supported." << std::endl;
-          return 1;
-          // global_sep_tree = ordering::spectral_nd
-          //   (*Aseq, perm_, iperm_, opts.ND_options());
-          // break;
+          global_sep_tree = ordering::parallel_nd_reordering
+            (*Aseq, perm_, iperm_, opts.nd_param(),
+             ordering::NDBisection::SPECTRAL);
+          break;
         }
         default: assert(true);
         }
@@ -261,7 +261,15 @@ namespace strumpack {
     std::swap(perm_, iperm_);
 #pragma omp parallel
 #pragma omp single
-    F->permute_CB(sorder.data());
+    {
+      F->permute_CB(sorder.data());
+      F->setup_parent_maps();
+    }
+    if (opts.CB_clustering()) {
+#pragma omp parallel
+#pragma omp single
+      F->cluster_CB(opts);
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -0,0 +1,678 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+#include "ParallelND.hpp"
+#include "StrumpackParameters.hpp"
+#include "dense/BLASLAPACKWrapper.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    namespace {
+
+      // do not use tasks for loops over less than this many vertices
+      const int nd_par_threshold = 20000;
+      // stop coarsening at this number of vertices
+      const int nd_coarsest = 200;
+      // allowed imbalance between the two halves of a bisection
+      const double nd_imbalance = 1.05;
+      // Lanczos steps per restart, and max number of restarts, for
+      // the Fiedler vector
+      const int nd_lanczos_steps = 40;
+      const int nd_lanczos_restarts = 10;
+      // relative residual tolerance for the Fiedler vector
+      const double nd_lanczos_tol = 1e-3;
+
+      /*
+       * Graph with (optional) vertex and edge weights. Empty vw/ew
+       * means unit weights, this is the case for all graphs except
+       * for the coarse graphs in the multilevel bisection.
+       */
+      template<typename integer> struct NDGraph {
+        integer n = 0;
+        std::vector<integer> ptr, ind, vw, ew;
+        integer vwgt(integer v) const { return vw.empty() ? 1 : vw[v]; }
+        integer ewgt(integer e) const { return ew.empty() ? 1 : ew[e]; }
+        integer total_weight() const {
+          return vw.empty() ? n : std::accumulate(vw.begin(), vw.end(),
+                                                  integer(0));
+        }
+      };
+
+      inline std::uint32_t edge_hash(std::uint64_t a, std::uint64_t b,
+                                     std::uint64_t seed) {
+        std::uint64_t x = (std::min(a, b) << 32) ^ std::max(a, b) ^
+          (seed * 0x9E3779B97F4A7C15ull);
+        x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return std::uint32_t(x);
+      }
+
+      /*
+       * Heavy edge matching. In every round, each unmatched vertex
+       * proposes to its unmatched neighbor with the heaviest edge,
+       * with ties broken by a random (but symmetric) edge priority,
+       * and mutual proposals are matched. This only requires reads
+       * of shared data, so both loops are parallel.
+       */
+      template<typename integer> std::vector<integer>
+      heavy_edge_matching(const NDGraph<integer>& g, integer maxvw,
+                          int task_depth) {
+        const integer n = g.n;
+        std::vector<integer> m(n, -1), prop(n);
+        for (int round=0; round<4; round++) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(n > nd_par_threshold)
+#endif
+          for (integer v=0; v<n; v++) {
+            prop[v] = -1;
+            if (m[v] != -1) continue;
+            integer best = -1;
+            std::uint64_t bkey = 0;
+            for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++) {
+              auto u = g.ind[e];
+              if (m[u] != -1 || g.vwgt(v) + g.vwgt(u) > maxvw) continue;
+              std::uint64_t key = (std::uint64_t(g.ewgt(e)) << 32) |
+                edge_hash(u, v, round);
+              if (best == -1 || key > bkey) { best = u; bkey = key; }
+            }
+            prop[v] = best;
+          }
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(n > nd_par_threshold)
+#endif
+          for (integer v=0; v<n; v++)
+            if (m[v] == -1 && prop[v] != -1 && prop[prop[v]] == v)
+              m[v] = prop[v];
+        }
+        for (integer v=0; v<n; v++)
+          if (m[v] == -1) m[v] = v;
+        return m;
+      }
+
+      /*
+       * Contract matched vertices. cmap maps a vertex of g to its
+       * vertex in the coarse graph. Parallel edges are merged and
+       * their weights added.
+       */
+      template<typename integer> NDGraph<integer>
+      contract(const NDGraph<integer>& g, const std::vector<integer>& m,
+               std::vector<integer>& cmap, int task_depth) {
+        const integer n = g.n;
+        cmap.resize(n);
+        integer nc = 0;
+        for (integer v=0; v<n; v++)
+          cmap[v] = (v <= m[v]) ? nc++ : cmap[m[v]];
+        std::vector<integer> rep(nc), ub(nc+1);
+        for (integer v=0; v<n; v++)
+          if (v <= m[v]) rep[cmap[v]] = v;
+        ub[0] = 0;
+        for (integer c=0; c<nc; c++) {
+          auto v = rep[c], u = m[v];
+          ub[c+1] = ub[c] + g.ptr[v+1] - g.ptr[v] +
+            ((u != v) ? g.ptr[u+1] - g.ptr[u] : 0);
+        }
+        NDGraph<integer> cg;
+        cg.n = nc;
+        cg.vw.resize(nc);
+        std::vector<std::pair<integer,integer>> tmp(ub[nc]);
+        std::vector<integer> cnt(nc);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(nc > nd_par_threshold)
+#endif
+        for (integer c=0; c<nc; c++) {
+          auto v = rep[c], u = m[v];
+          cg.vw[c] = g.vwgt(v) + ((u != v) ? g.vwgt(u) : 0);
+          auto b = tmp.data() + ub[c], p = b;
+          for (integer x : {v, u}) {
+            for (integer e=g.ptr[x]; e<g.ptr[x+1]; e++) {
+              auto cu = cmap[g.ind[e]];
+              if (cu != c) *p++ = {cu, g.ewgt(e)};
+            }
+            if (u == v) break;
+          }
+          std::sort(b, p);
+          auto q = b;
+          for (auto r=b; r!=p; r++) {
+            if (q != b && (q-1)->first == r->first)
+              (q-1)->second += r->second;
+            else *q++ = *r;
+          }
+          cnt[c] = q - b;
+        }
+        cg.ptr.resize(nc+1);
+        cg.ptr[0] = 0;
+        for (integer c=0; c<nc; c++)
+          cg.ptr[c+1] = cg.ptr[c] + cnt[c];
+        cg.ind.resize(cg.ptr[nc]);
+        cg.ew.resize(cg.ptr[nc]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(nc > nd_par_threshold)
+#endif
+        for (integer c=0; c<nc; c++)
+          for (integer i=0; i<cnt[c]; i++) {
+            cg.ind[cg.ptr[c]+i] = tmp[ub[c]+i].first;
+            cg.ew[cg.ptr[c]+i] = tmp[ub[c]+i].second;
+          }
+        return cg;
+      }
+
+      template<typename integer> integer
+      edge_cut(const NDGraph<integer>& g, const std::vector<char>& where) {
+        integer cut = 0;
+        for (integer v=0; v<g.n; v++)
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++)
+            if (where[g.ind[e]] != where[v]) cut += g.ewgt(e);
+        return cut / 2;
+      }
+
+      /*
+       * Greedy boundary refinement of a bisection. The gains of all
+       * vertices on one side are computed in parallel, the moves are
+       * then applied in order of decreasing gain, rechecking the gain
+       * and the balance for every move.
+       */
+      template<typename integer> void
+      refine(const NDGraph<integer>& g, std::vector<char>& where,
+             int task_depth) {
+        const integer n = g.n;
+        const integer tw = g.total_weight();
+        integer pw[2] = {0, 0}, maxvw = 1;
+        for (integer v=0; v<n; v++) {
+          pw[int(where[v])] += g.vwgt(v);
+          maxvw = std::max(maxvw, g.vwgt(v));
+        }
+        const integer maxw = std::max
+          (integer(std::ceil(nd_imbalance * tw / 2.)), tw / 2 + maxvw);
+        auto gain = [&](integer v) {
+          integer ext = 0, in = 0;
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++) {
+            if (where[g.ind[e]] == where[v]) in += g.ewgt(e);
+            else ext += g.ewgt(e);
+          }
+          return std::make_pair(ext - in, ext);
+        };
+        std::vector<integer> gains(n);
+        std::vector<std::pair<integer,integer>> cand;
+        for (int pass=0; pass<8; pass++) {
+          integer moved = 0;
+          for (int s=0; s<2; s++) {
+            // start from the heavier side
+            char d = (pw[0] >= pw[1]) ? s : 1 - s;
+            bool heavy = pw[int(d)] > maxw;
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(n > nd_par_threshold)
+#endif
+            for (integer v=0; v<n; v++) {
+              gains[v] = std::numeric_limits<integer>::min();
+              if (where[v] != d) continue;
+              auto ge = gain(v);
+              if (ge.second > 0 && (ge.first > 0 || heavy ||
+                                    (ge.first == 0 && pw[int(d)] > pw[1-d])))
+                gains[v] = ge.first;
+            }
+            cand.clear();
+            for (integer v=0; v<n; v++)
+              if (gains[v] != std::numeric_limits<integer>::min())
+                cand.emplace_back(-gains[v], v);
+            std::sort(cand.begin(), cand.end());
+            for (auto& c : cand) {
+              auto v = c.second;
+              auto w = g.vwgt(v);
+              if (pw[1-d] + w > maxw) continue;
+              auto gv = gain(v).first;
+              bool balance = pw[int(d)] > maxw ||
+                pw[int(d)] - w >= pw[1-d] + w;
+              if (gv < 0 && !(pw[int(d)] > maxw)) continue;
+              if (gv == 0 && !balance) continue;
+              where[v] = 1 - d;
+              pw[int(d)] -= w;
+              pw[1-d] += w;
+              moved++;
+            }
+          }
+          if (!moved) break;
+        }
+      }
+
+      /*
+       * Bisection of a small graph by graph growing, from a
+       * pseudo-peripheral vertex and a few other start vertices.
+       * Disconnected graphs are handled by restarting the search
+       * from an unvisited vertex.
+       */
+      template<typename integer> std::vector<char>
+      initial_bisection(const NDGraph<integer>& g, int task_depth) {
+        const integer n = g.n, tw = g.total_weight();
+        std::vector<char> where(n), best;
+        integer bestcut = 0;
+        std::vector<integer> queue(n);
+        std::vector<char> mark(n);
+        auto bfs_last = [&](integer r) {
+          std::fill(mark.begin(), mark.end(), 0);
+          integer h = 0, t = 0;
+          queue[t++] = r; mark[r] = 1;
+          while (h < t) {
+            auto v = queue[h++];
+            for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++)
+              if (!mark[g.ind[e]]) {
+                mark[g.ind[e]] = 1;
+                queue[t++] = g.ind[e];
+              }
+          }
+          return queue[t-1];
+        };
+        std::vector<integer> seeds;
+        seeds.push_back(bfs_last(bfs_last(0)));
+        for (int s=1; s<4 && s<n; s++)
+          seeds.push_back(integer(edge_hash(s, n, 7) % n));
+        for (auto r : seeds) {
+          std::fill(where.begin(), where.end(), 1);
+          std::fill(mark.begin(), mark.end(), 0);
+          integer w0 = 0, h = 0, t = 0, next = 0;
+          queue[t++] = r; mark[r] = 1;
+          while (2 * w0 < tw) {
+            if (h == t) { // disconnected, restart from unvisited vertex
+              while (next < n && mark[next]) next++;
+              if (next == n) break;
+              queue[t++] = next; mark[next] = 1;
+            }
+            auto v = queue[h++];
+            if (2 * (w0 + g.vwgt(v)) > tw + g.vwgt(v)) break;
+            where[v] = 0;
+            w0 += g.vwgt(v);
+            for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++)
+              if (!mark[g.ind[e]]) {
+                mark[g.ind[e]] = 1;
+                queue[t++] = g.ind[e];
+              }
+          }
+          refine(g, where, task_depth);
+          auto cut = edge_cut(g, where);
+          if (best.empty() || cut < bestcut) {
+            best = where;
+            bestcut = cut;
+          }
+        }
+        return best;
+      }
+
+      template<typename integer> std::vector<char>
+      multilevel_bisection(const NDGraph<integer>& g, int task_depth) {
+        std::vector<NDGraph<integer>> levels;
+        std::vector<std::vector<integer>> cmaps;
+        const integer maxvw = std::max
+          (integer(1), integer(1.5 * g.total_weight() / nd_coarsest));
+        while (true) {
+          auto& cur = levels.empty() ? g : levels.back();
+          if (cur.n <= nd_coarsest) break;
+          auto m = heavy_edge_matching(cur, maxvw, task_depth);
+          std::vector<integer> cmap;
+          auto cg = contract(cur, m, cmap, task_depth);
+          if (cg.n > 0.95 * cur.n) break;
+          levels.push_back(std::move(cg));
+          cmaps.push_back(std::move(cmap));
+        }
+        auto where = initial_bisection
+          (levels.empty() ? g : levels.back(), task_depth);
+        for (auto l=levels.size(); l-->0; ) {
+          auto& fine = l ? levels[l-1] : g;
+          auto& cmap = cmaps[l];
+          std::vector<char> fwhere(fine.n);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(fine.n > nd_par_threshold)
+#endif
+          for (integer v=0; v<fine.n; v++)
+            fwhere[v] = where[cmap[v]];
+          where.swap(fwhere);
+          levels.pop_back();
+          cmaps.pop_back();
+          refine(fine, where, task_depth);
+        }
+        return where;
+      }
+
+      /*
+       * y = L x, with L = D - W the Laplacian of g, W the edge
+       * weights and D the weighted degrees.
+       */
+      template<typename integer> void
+      laplacian_mv(const NDGraph<integer>& g, const double* x, double* y) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(g.n > nd_par_threshold)
+#endif
+        for (integer v=0; v<g.n; v++) {
+          double d = 0., s = 0.;
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++) {
+            double w = g.ewgt(e);
+            d += w;
+            s += w * x[g.ind[e]];
+          }
+          y[v] = d * x[v] - s;
+        }
+      }
+
+      /*
+       * Dot product, summed per block of nd_par_threshold entries, in
+       * a fixed order, so the result does not depend on the number
+       * of threads.
+       */
+      inline double nd_dot(std::size_t n, const double* x, const double* y) {
+        const std::size_t B = nd_par_threshold, nb = (n + B - 1) / B;
+        std::vector<double> part(nb);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(nb > 1)
+#endif
+        for (std::size_t b=0; b<nb; b++) {
+          double s = 0.;
+          for (std::size_t i=b*B; i<std::min(n, (b+1)*B); i++)
+            s += x[i] * y[i];
+          part[b] = s;
+        }
+        return std::accumulate(part.begin(), part.end(), 0.);
+      }
+
+      // y += a x
+      inline void nd_axpy(std::size_t n, double a,
+                          const double* x, double* y) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(n > nd_par_threshold)
+#endif
+        for (std::size_t i=0; i<n; i++)
+          y[i] += a * x[i];
+      }
+
+      // remove the component along the constant vector (the null
+      // space of L for a connected graph)
+      inline void nd_deflate(std::size_t n, double* x) {
+        const std::size_t B = nd_par_threshold, nb = (n + B - 1) / B;
+        std::vector<double> part(nb);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(nb > 1)
+#endif
+        for (std::size_t b=0; b<nb; b++) {
+          double s = 0.;
+          for (std::size_t i=b*B; i<std::min(n, (b+1)*B); i++)
+            s += x[i];
+          part[b] = s;
+        }
+        auto mean = std::accumulate(part.begin(), part.end(), 0.) / n;
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(n > nd_par_threshold)
+#endif
+        for (std::size_t i=0; i<n; i++)
+          x[i] -= mean;
+      }
+
+      /*
+       * Approximation of the Fiedler vector, the eigenvector of the
+       * smallest nonzero eigenvalue of the Laplacian, with restarted
+       * Lanczos and full reorthogonalization. The constant vector is
+       * projected out. The restart vector is the current Ritz vector.
+       * The SpMV, dot products and vector updates are done with
+       * OpenMP tasks for large graphs.
+       */
+      template<typename integer> std::vector<double>
+      fiedler_vector(const NDGraph<integer>& g) {
+        const std::size_t n = g.n;
+        const int m = std::min(std::size_t(nd_lanczos_steps), n - 1);
+        std::vector<double> Q(n * (m + 1)), x(n), alpha(m), beta(m);
+        for (std::size_t i=0; i<n; i++)
+          x[i] = double(edge_hash(i, n, 11)) / 4294967296. - .5;
+        for (int r=0; r<nd_lanczos_restarts; r++) {
+          nd_deflate(n, x.data());
+          auto nx = std::sqrt(nd_dot(n, x.data(), x.data()));
+          if (nx == 0.) break;
+          for (std::size_t i=0; i<n; i++) Q[i] = x[i] / nx;
+          int k = 0;
+          while (k < m) {
+            auto q = &Q[k*n], w = q + n;
+            laplacian_mv(g, q, w);
+            alpha[k] = nd_dot(n, q, w);
+            // full reorthogonalization, twice is enough
+            for (int pass=0; pass<2; pass++) {
+              nd_deflate(n, w);
+              for (int j=0; j<=k; j++)
+                nd_axpy(n, -nd_dot(n, &Q[j*n], w), &Q[j*n], w);
+            }
+            beta[k] = std::sqrt(nd_dot(n, w, w));
+            k++;
+            if (beta[k-1] <= 1e-12 * std::abs(alpha[0])) break;
+            for (std::size_t i=0; i<n; i++) w[i] /= beta[k-1];
+          }
+          // eigenvectors of the k x k tridiagonal Lanczos matrix
+          std::vector<double> T(k*k), lambda(k);
+          for (int j=0; j<k; j++) {
+            T[j+j*k] = alpha[j];
+            if (j+1 < k) T[j+1+j*k] = T[j+(j+1)*k] = beta[j];
+          }
+          if (blas::syev('V', 'L', k, T.data(), k, lambda.data())) break;
+          // Ritz vector for the smallest eigenvalue
+          std::fill(x.begin(), x.end(), 0.);
+          for (int j=0; j<k; j++)
+            nd_axpy(n, T[j], &Q[j*n], x.data());
+          auto res = beta[k-1] * std::abs(T[k-1]);
+          if (res <= nd_lanczos_tol * std::abs(lambda[k-1]) || k < m)
+            break;
+        }
+        return x;
+      }
+
+      /*
+       * Spectral bisection: split at the weighted median of the
+       * Fiedler vector, then refine the edge cut.
+       */
+      template<typename integer> std::vector<char>
+      spectral_bisection(const NDGraph<integer>& g, int task_depth) {
+        const integer n = g.n, tw = g.total_weight();
+        auto f = fiedler_vector(g);
+        std::vector<integer> idx(n);
+        std::iota(idx.begin(), idx.end(), 0);
+        std::sort(idx.begin(), idx.end(), [&f](integer a, integer b) {
+            return f[a] < f[b] || (f[a] == f[b] && a < b); });
+        std::vector<char> where(n, 1);
+        integer w0 = 0;
+        for (auto v : idx) {
+          if (2 * (w0 + g.vwgt(v)) > tw + g.vwgt(v)) break;
+          where[v] = 0;
+          w0 += g.vwgt(v);
+        }
+        refine(g, where, task_depth);
+        return where;
+      }
+
+      /*
+       * Derive a vertex separator from the edge separator: take the
+       * boundary vertices of the side with the smallest boundary, and
+       * move separator vertices back to one of the halves if they are
+       * not connected to the other half. Separator vertices get
+       * where[v] = 2.
+       */
+      template<typename integer> void
+      vertex_separator(const NDGraph<integer>& g, std::vector<char>& where) {
+        const integer n = g.n;
+        integer nb[2] = {0, 0}, pw[2] = {0, 0};
+        std::vector<char> bnd(n, 0);
+        for (integer v=0; v<n; v++) {
+          pw[int(where[v])]++;
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++)
+            if (where[g.ind[e]] != where[v]) {
+              bnd[v] = 1;
+              nb[int(where[v])]++;
+              break;
+            }
+        }
+        char d = (nb[0] <= nb[1]) ? 0 : 1;
+        std::vector<integer> sep;
+        for (integer v=0; v<n; v++)
+          if (bnd[v] && where[v] == d) {
+            where[v] = 2;
+            sep.push_back(v);
+          }
+        pw[int(d)] -= sep.size();
+        for (auto v : sep) {
+          bool has[2] = {false, false};
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++) {
+            auto w = where[g.ind[e]];
+            if (w != 2) has[int(w)] = true;
+          }
+          if (has[0] && has[1]) continue;
+          char p = has[0] ? 0 : (has[1] ? 1 : (pw[0] > pw[1] ? 1 : 0));
+          where[v] = p;
+          pw[int(p)]++;
+        }
+      }
+
+      template<typename integer> NDGraph<integer>
+      extract_part(const NDGraph<integer>& g, const std::vector<char>& where,
+                   char p, const std::vector<integer>& ids,
+                   std::vector<integer>& pids) {
+        std::vector<integer> lid(g.n, -1);
+        integer np = 0;
+        for (integer v=0; v<g.n; v++)
+          if (where[v] == p) lid[v] = np++;
+        NDGraph<integer> pg;
+        pg.n = np;
+        pg.ptr.resize(np+1);
+        pids.resize(np);
+        pg.ptr[0] = 0;
+        for (integer v=0; v<g.n; v++) {
+          if (where[v] != p) continue;
+          auto lv = lid[v];
+          pids[lv] = ids[v];
+          integer d = 0;
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++)
+            if (lid[g.ind[e]] != -1) d++;
+          pg.ptr[lv+1] = pg.ptr[lv] + d;
+        }
+        pg.ind.resize(pg.ptr[np]);
+        for (integer v=0; v<g.n; v++) {
+          if (where[v] != p) continue;
+          auto i = pg.ptr[lid[v]];
+          for (integer e=g.ptr[v]; e<g.ptr[v+1]; e++)
+            if (lid[g.ind[e]] != -1) pg.ind[i++] = lid[g.ind[e]];
+        }
+        return pg;
+      }
+
+      /*
+       * Returns the separator tree of g, in postorder, with sep_end
+       * relative to the start of this subgraph in iperm. The left
+       * half is ordered first, then the right half, then the
+       * separator.
+       */
+      template<typename integer> std::vector<Separator<integer>>
+      nd_rec(NDGraph<integer>&& g, std::vector<integer>&& ids,
+             integer* iperm, integer leaf, NDBisection method,
+             int task_depth) {
+        const integer n = g.n;
+        if (n <= leaf) {
+          std::copy(ids.begin(), ids.end(), iperm);
+          return {Separator<integer>(n, -1, -1, -1)};
+        }
+        auto where = (method == NDBisection::SPECTRAL) ?
+          spectral_bisection(g, task_depth) :
+          multilevel_bisection(g, task_depth);
+        vertex_separator(g, where);
+        integer n0 = std::count(where.begin(), where.end(), 0),
+          n1 = std::count(where.begin(), where.end(), 1);
+        if (!n0 || !n1) {
+          std::copy(ids.begin(), ids.end(), iperm);
+          return {Separator<integer>(n, -1, -1, -1)};
+        }
+        std::vector<integer> ids0, ids1;
+        auto g0 = extract_part(g, where, 0, ids, ids0);
+        auto g1 = extract_part(g, where, 1, ids, ids1);
+        for (integer v=0, i=n0+n1; v<n; v++)
+          if (where[v] == 2) iperm[i++] = ids[v];
+        g = NDGraph<integer>();
+        ids = std::vector<integer>();
+        where = std::vector<char>();
+        std::vector<Separator<integer>> t0, t1;
+#pragma omp task default(shared)                                        \
+  if(task_depth < params::task_recursion_cutoff_level)
+        t0 = nd_rec(std::move(g0), std::move(ids0), iperm,
+                    leaf, method, task_depth+1);
+#pragma omp task default(shared)                                        \
+  if(task_depth < params::task_recursion_cutoff_level)
+        t1 = nd_rec(std::move(g1), std::move(ids1), iperm+n0,
+                    leaf, method, task_depth+1);
+#pragma omp taskwait
+        integer L = t0.size(), R = t1.size(), root = L + R;
+        t0.back().pa = root;
+        t0.reserve(root + 1);
+        for (auto s : t1) {
+          s.sep_end += n0;
+          s.pa = (s.pa == -1) ? root : s.pa + L;
+          if (s.lch != -1) s.lch += L;
+          if (s.rch != -1) s.rch += L;
+          t0.push_back(s);
+        }
+        t0.emplace_back(n, -1, L-1, root-1);
+        return t0;
+      }
+
+    } // end anonymous namespace
+
+    template<typename integer> SeparatorTree<integer>
+    parallel_nd(integer n, const integer* xadj, const integer* adjncy,
+                integer* iperm, integer leaf_size, NDBisection method) {
+      if (n <= 0) return SeparatorTree<integer>();
+      NDGraph<integer> g;
+      g.n = n;
+      g.ptr.assign(xadj, xadj+n+1);
+      g.ind.assign(adjncy, adjncy+xadj[n]);
+      std::vector<integer> ids(n);
+      std::iota(ids.begin(), ids.end(), 0);
+      auto tree = nd_rec
+        (std::move(g), std::move(ids), iperm,
+         std::max(integer(1), leaf_size), method, 0);
+      return SeparatorTree<integer>(tree);
+    }
+
+    // explicit template instantiation
+    template SeparatorTree<int>
+    parallel_nd(int n, const int* xadj, const int* adjncy,
+                int* iperm, int leaf_size, NDBisection method);
+    template SeparatorTree<long int>
+    parallel_nd(long int n, const long int* xadj, const long int* adjncy,
+                long int* iperm, long int leaf_size, NDBisection method);
+    template SeparatorTree<long long int>
+    parallel_nd(long long int n, const long long int* xadj,
+                const long long int* adjncy, long long int* iperm,
+                long long int leaf_size, NDBisection method);
+
+  } // end namespace ordering
+} // end namespace strumpack
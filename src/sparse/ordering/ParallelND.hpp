@@ -0,0 +1,118 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_ORDERING_PARALLEL_ND_HPP
+#define STRUMPACK_ORDERING_PARALLEL_ND_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "sparse/SeparatorTree.hpp"
+#include "misc/Tools.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * Graph bisection method used in parallel_nd.
+     */
+    enum class NDBisection {
+      MULTILEVEL, /*!< coarsen, graph growing, refine              */
+      SPECTRAL    /*!< split by the Fiedler vector, refine         */
+    };
+
+    /**
+     * Nested dissection, using OpenMP tasks. With the MULTILEVEL
+     * method, each bisection coarsens the graph with a (parallel)
+     * heavy edge matching, bisects the coarsest graph by graph
+     * growing, and refines the bisection during uncoarsening. With
+     * the SPECTRAL method, the graph is split at the median of an
+     * approximate Fiedler vector of the graph Laplacian, computed
+     * with Lanczos, and this bisection is then refined. A vertex
+     * separator is derived from the edge cut, and both halves are
+     * ordered recursively, in parallel.
+     *
+     * This should be called from a single thread inside an OpenMP
+     * parallel region.
+     *
+     * \param n number of vertices
+     * \param xadj adjacency structure, should be symmetric, without
+     * self-edges
+     * \param adjncy adjacency structure
+     * \param iperm on output, iperm[i] is the vertex at position i
+     * in the new ordering
+     * \param leaf_size do not further split subgraphs with at most
+     * leaf_size vertices
+     * \param method bisection method
+     * \return the separator tree, in postorder
+     */
+    template<typename integer> SeparatorTree<integer>
+    parallel_nd(integer n, const integer* xadj, const integer* adjncy,
+                integer* iperm, integer leaf_size,
+                NDBisection method=NDBisection::MULTILEVEL);
+
+    template<typename integer_t> SeparatorTree<integer_t>
+    parallel_nd_reordering(integer_t n, const integer_t* ptr,
+                           const integer_t* ind,
+                           std::vector<integer_t>& perm,
+                           std::vector<integer_t>& iperm, int leaf_size,
+                           NDBisection method=NDBisection::MULTILEVEL) {
+      std::vector<integer_t> xadj(n+1), adjncy(ptr[n]);
+      integer_t e = 0;
+      for (integer_t j=0; j<n; j++) {
+        xadj[j] = e;
+        for (integer_t t=ptr[j]; t<ptr[j+1]; t++)
+          if (ind[t] != j) adjncy[e++] = ind[t];
+      }
+      xadj[n] = e;
+      if (e==0)
+        if (mpi_root())
+          std::cerr << "# WARNING: matrix seems to be diagonal!" << std::endl;
+      SeparatorTree<integer_t> stree;
+#pragma omp parallel
+#pragma omp single
+      stree = parallel_nd
+        (n, xadj.data(), adjncy.data(), iperm.data(),
+         integer_t(leaf_size), method);
+      for (integer_t i=0; i<n; i++)
+        perm[iperm[i]] = i;
+      return stree;
+    }
+
+    template<typename integer_t,typename G> SeparatorTree<integer_t>
+    parallel_nd_reordering(const G& A, std::vector<integer_t>& perm,
+                           std::vector<integer_t>& iperm, int leaf_size,
+                           NDBisection method=NDBisection::MULTILEVEL) {
+      return parallel_nd_reordering<integer_t>
+        (A.size(), A.ptr(), A.ind(), perm, iperm, leaf_size, method);
+    }
+
+  } // end namespace ordering
+} // end namespace strumpack
+
+#endif // STRUMPACK_ORDERING_PARALLEL_ND_HPP
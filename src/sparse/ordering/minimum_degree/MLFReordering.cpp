@@ -0,0 +1,212 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+
+#include "MLFReordering.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    namespace {
+
+      /*
+       * Binary min-heap of vertices, ordered by (score, degree,
+       * index). The position of each vertex is tracked, so a vertex
+       * can be moved after its score changed.
+       */
+      template<typename integer> class MLFHeap {
+      public:
+        MLFHeap(integer n, const double* score, const integer* deg)
+          : score_(score), deg_(deg), pos_(n, -1) { h_.reserve(n); }
+
+        integer top() const { return h_[0]; }
+        void push(integer v) {
+          pos_[v] = h_.size();
+          h_.push_back(v);
+          up(pos_[v]);
+        }
+        void pop() {
+          auto v = h_[0], last = h_.back();
+          h_.pop_back();
+          pos_[v] = -1;
+          if (last == v) return;
+          h_[0] = last;
+          pos_[last] = 0;
+          down(0);
+        }
+        void update(integer v) {
+          up(pos_[v]);
+          down(pos_[v]);
+        }
+
+      private:
+        const double* score_;
+        const integer* deg_;
+        std::vector<integer> h_, pos_;
+
+        bool less(integer a, integer b) const {
+          if (score_[a] != score_[b]) return score_[a] < score_[b];
+          if (deg_[a] != deg_[b]) return deg_[a] < deg_[b];
+          return a < b;
+        }
+        void swap(integer i, integer j) {
+          std::swap(h_[i], h_[j]);
+          pos_[h_[i]] = i;
+          pos_[h_[j]] = j;
+        }
+        void up(integer i) {
+          while (i > 0 && less(h_[i], h_[(i-1)/2])) {
+            swap(i, (i-1)/2);
+            i = (i-1)/2;
+          }
+        }
+        void down(integer i) {
+          const integer s = h_.size();
+          while (true) {
+            auto l = 2*i+1, r = l+1, m = i;
+            if (l < s && less(h_[l], h_[m])) m = l;
+            if (r < s && less(h_[r], h_[m])) m = r;
+            if (m == i) return;
+            swap(i, m);
+            i = m;
+          }
+        }
+      };
+
+      inline double approx_fill(double d, double c) {
+        return d * (d - 1) / 2 - c * (c - 1) / 2;
+      }
+
+    } // end anonymous namespace
+
+    /*
+     * Quotient graph: a vertex is either an uneliminated variable, an
+     * element (an eliminated vertex, representing the clique of its
+     * variables), or an element that was absorbed in another
+     * element. For a variable i, av[i] are the adjacent variables
+     * and ae[i] the adjacent elements, and for an element e, le[e]
+     * are the variables in e. Elements only contain variables, since
+     * all elements adjacent to the pivot are absorbed.
+     */
+    template<typename integer> void
+    mlf(integer n, const integer* xadj, const integer* adjncy,
+        integer* iperm) {
+      enum : char { VAR, ELEM, DEAD };
+      std::vector<char> st(n, VAR);
+      std::vector<std::vector<integer>> av(n), ae(n), le(n);
+      std::vector<integer> deg(n), w(n), wmark(n, -1), mark(n, -1);
+      std::vector<double> score(n);
+      for (integer i=0; i<n; i++) {
+        av[i].assign(adjncy+xadj[i], adjncy+xadj[i+1]);
+        deg[i] = av[i].size();
+        score[i] = approx_fill(deg[i], 0);
+      }
+      MLFHeap<integer> heap(n, score.data(), deg.data());
+      for (integer i=0; i<n; i++) heap.push(i);
+      for (integer k=0; k<n; k++) {
+        auto p = heap.top();
+        heap.pop();
+        iperm[k] = p;
+        // the variables of the new element p, absorb the adjacent
+        // elements
+        auto& lp = le[p];
+        mark[p] = p;
+        for (auto v : av[p])
+          if (st[v] == VAR && mark[v] != p) {
+            mark[v] = p;
+            lp.push_back(v);
+          }
+        for (auto e : ae[p]) {
+          if (st[e] != ELEM) continue;
+          for (auto v : le[e])
+            if (mark[v] != p) {
+              mark[v] = p;
+              lp.push_back(v);
+            }
+          st[e] = DEAD;
+          std::vector<integer>().swap(le[e]);
+        }
+        st[p] = ELEM;
+        std::vector<integer>().swap(av[p]);
+        std::vector<integer>().swap(ae[p]);
+        // w[e] = |le[e] \ lp| for the other elements adjacent to lp
+        for (auto i : lp)
+          for (auto e : ae[i]) {
+            if (st[e] != ELEM) continue;
+            if (wmark[e] != p) {
+              wmark[e] = p;
+              w[e] = le[e].size();
+            }
+            w[e]--;
+          }
+        // aggressive absorption, elements which are a subset of lp
+        for (auto i : lp)
+          for (auto e : ae[i])
+            if (st[e] == ELEM && w[e] == 0) {
+              st[e] = DEAD;
+              std::vector<integer>().swap(le[e]);
+            }
+        const integer lps = lp.size(),
+          nleft = std::max(n - k - 2, integer(0));
+        for (auto i : lp) {
+          integer d = lps - 1, c = lps - 1;
+          auto& aei = ae[i];
+          aei.erase(std::remove_if
+                    (aei.begin(), aei.end(),
+                     [&](integer e) { return st[e] != ELEM; }),
+                    aei.end());
+          for (auto e : aei) {
+            d += w[e];
+            c = std::max(c, integer(le[e].size()) - 1);
+          }
+          aei.push_back(p);
+          // variables in lp are now reached through element p
+          auto& avi = av[i];
+          avi.erase(std::remove_if
+                    (avi.begin(), avi.end(), [&](integer v) {
+                      return st[v] != VAR || mark[v] == p; }),
+                    avi.end());
+          d = std::min(d + integer(avi.size()), nleft);
+          deg[i] = d;
+          score[i] = approx_fill(d, std::min(c, d));
+          heap.update(i);
+        }
+      }
+    }
+
+    // explicit template instantiation
+    template void mlf(int n, const int* xadj, const int* adjncy,
+                      int* iperm);
+    template void mlf(long int n, const long int* xadj,
+                      const long int* adjncy, long int* iperm);
+    template void mlf(long long int n, const long long int* xadj,
+                      const long long int* adjncy, long long int* iperm);
+
+  } // end namespace ordering
+} // end namespace strumpack
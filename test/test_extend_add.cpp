@@ -0,0 +1,128 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+using namespace std;
+
+#include "sparse/fronts/FrontDense.hpp"
+#include "misc/TaskTimer.hpp"
+#include "misc/RandomWrapper.hpp"
+using namespace strumpack;
+
+/*
+ * Check the extend-add of a dense contribution block into the parent
+ * front against a simple element by element extend-add, and measure
+ * the bandwidth. The fronts mimic the top of the nested dissection
+ * of a k^3 grid: the parent separator is a k x k plane, the parent
+ * update indices are 2 other planes, and the child update indices
+ * are the parent separator and half of each of these planes, giving
+ * contiguous runs of k/2 indices in the parent.
+ */
+template<typename scalar_t> int run(int k, int reps) {
+  using F_t = FrontDense<scalar_t,int>;
+  using DenseM_t = DenseMatrix<scalar_t>;
+  const int cs = k*k, ps = k*k;
+  std::vector<int> pupd, cupd;
+  for (int i=0; i<2*k*k; i++) pupd.push_back(cs + ps + i);
+  for (int i=0; i<ps; i++) cupd.push_back(cs + i);
+  for (int p=0; p<2; p++)
+    for (int y=0; y<k; y++)
+      for (int x=0; x<k/2; x++)
+        cupd.push_back(cs + ps + p*k*k + y*k + x);
+  const int pdsep = ps, pdupd = pupd.size(), dupd = cupd.size();
+  F_t pa(1, cs, cs + ps, pupd);
+  auto ch = new F_t(0, 0, cs, cupd);
+  pa.set_lchild(std::unique_ptr<Front<scalar_t,int>>(ch));
+
+  DenseM_t CB(dupd, dupd), F11(pdsep, pdsep), F12(pdsep, pdupd),
+    F21(pdupd, pdsep), F22(pdupd, pdupd);
+  CB.random();
+  for (auto F : {&F11, &F12, &F21, &F22}) F->zero();
+  DenseM_t R11(F11), R12(F12), R21(F21), R22(F22);
+
+  // reference
+  std::size_t upd2sep;
+  auto I = ch->upd_to_parent(&pa, upd2sep);
+  for (int c=0; c<dupd; c++)
+    for (int r=0; r<dupd; r++) {
+      auto pr = I[r], pc = I[c];
+      if (pr < std::size_t(pdsep)) {
+        if (pc < std::size_t(pdsep)) R11(pr, pc) += CB(r, c);
+        else R12(pr, pc-pdsep) += CB(r, c);
+      } else {
+        if (pc < std::size_t(pdsep)) R21(pr-pdsep, pc) += CB(r, c);
+        else R22(pr-pdsep, pc-pdsep) += CB(r, c);
+      }
+    }
+
+  // without and with the stored relative index maps
+  for (int stored=0; stored<2; stored++) {
+    if (stored) pa.setup_parent_maps();
+    for (auto F : {&F11, &F12, &F21, &F22}) F->zero();
+    ch->extend_add(F11, F12, F21, F22, CB, &pa);
+    F11.scaled_add(scalar_t(-1.), R11);
+    F12.scaled_add(scalar_t(-1.), R12);
+    F21.scaled_add(scalar_t(-1.), R21);
+    F22.scaled_add(scalar_t(-1.), R22);
+    auto err = F11.normF() + F12.normF() + F21.normF() + F22.normF();
+    if (err != 0.) {
+      cout << "ERROR: extend-add does not match the reference, err = "
+           << err << endl;
+      return 1;
+    }
+    TaskTimer t("extend_add");
+    t.start();
+#pragma omp parallel
+#pragma omp single
+    for (int i=0; i<reps; i++)
+      ch->extend_add(F11, F12, F21, F22, CB, &pa);
+    t.stop();
+    // CB is read, the parent is read and written
+    double GB = 3. * sizeof(scalar_t) * double(dupd) * dupd * reps / 1e9;
+    cout << "# k = " << k << ", dim_upd = " << dupd
+         << (stored ? ", stored maps" : ", maps computed")
+         << ", time = " << t.elapsed() / reps
+         << " s, bandwidth = " << GB / t.elapsed() << " GB/s" << endl;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int k = 20, reps = 10;
+  if (argc > 1) k = std::atoi(argv[1]);
+  if (argc > 2) reps = std::atoi(argv[2]);
+  if (k < 2 || reps < 1) {
+    cout << "Usage: " << argv[0] << " k reps" << endl;
+    return 1;
+  }
+  if (run<double>(k, reps)) return 1;
+  if (run<std::complex<float>>(k, reps)) return 1;
+  return 0;
+}
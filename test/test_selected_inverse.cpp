@@ -0,0 +1,224 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <cmath>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "misc/RandomWrapper.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e-10
+
+/*
+ * Nonsymmetric 5-point stencil on a k x k grid, with random values.
+ */
+template<typename scalar_t,typename integer_t>
+CSRMatrix<scalar_t,integer_t> grid_matrix(int k) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = k * k;
+  vector<integer_t> ptr(N+1), ind;
+  vector<scalar_t> val;
+  auto rgen = random::make_default_random_generator<real_t>();
+  for (integer_t y=0; y<k; y++)
+    for (integer_t x=0; x<k; x++) {
+      integer_t i = x + k * y;
+      if (y > 0)   { ind.push_back(i-k); val.push_back(rgen->get()); }
+      if (x > 0)   { ind.push_back(i-1); val.push_back(rgen->get()); }
+      ind.push_back(i); val.push_back(scalar_t(4.) + rgen->get());
+      if (x < k-1) { ind.push_back(i+1); val.push_back(rgen->get()); }
+      if (y < k-1) { ind.push_back(i+k); val.push_back(rgen->get()); }
+      ptr[i+1] = ind.size();
+    }
+  return CSRMatrix<scalar_t,integer_t>
+    (N, ptr.data(), ind.data(), val.data());
+}
+
+/*
+ * Compare selected entries of the inverse, computed with
+ * selected_inverse, inverse_diagonal and solve_sparse, with the
+ * corresponding entries of the columns of the inverse, computed using
+ * solves with the columns of the identity matrix.
+ */
+template<typename scalar_t,typename integer_t>
+int test_selected_inverse(int argc, const char* const argv[], int k) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  auto A = grid_matrix<scalar_t,integer_t>(k);
+  integer_t N = A.size();
+  const integer_t *ptr = A.ptr(), *ind = A.ind();
+
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  if (spss.reorder(k, k) != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  // the pattern of A is symmetric, so the entries of the inverse
+  // corresponding to the nonzeros of A can be computed
+  vector<scalar_t> Ainv(A.nnz()), d(N);
+  if (spss.selected_inverse(N, ptr, ind, Ainv.data())
+      != ReturnCode::SUCCESS ||
+      spss.inverse_diagonal(d.data()) != ReturnCode::SUCCESS) {
+    cout << "problem during selected inversion." << endl;
+    return 1;
+  }
+  DenseMatrix<scalar_t> I(N, N), X(N, N);
+  I.eye();
+  spss.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  spss.solve(I, X);
+  real_t err(0.), nrm(0.);
+  for (integer_t i=0; i<N; i++) {
+    for (integer_t j=ptr[i]; j<ptr[i+1]; j++) {
+      err = std::max(err, std::abs(Ainv[j] - X(i, ind[j])));
+      nrm = std::max(nrm, std::abs(X(i, ind[j])));
+    }
+    err = std::max(err, std::abs(d[i] - X(i, i)));
+  }
+  cout << "# SELECTED INVERSE RELATIVE ERROR = " << err / nrm << endl;
+  if (err / nrm > ERROR_TOLERANCE) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+
+  // a few columns of the inverse, using a sparse right-hand side,
+  // and a few entries of those columns
+  vector<integer_t> b_rows = {0, N/2, N-1}, x_rows = {N-1, N/3, 1};
+  DenseMatrix<scalar_t> B(N, b_rows.size()), Y(N, b_rows.size());
+  B.zero();
+  for (size_t j=0; j<b_rows.size(); j++)
+    B(b_rows[j], j) = scalar_t(1.);
+  if (spss.solve_sparse(B, Y, b_rows, x_rows) != ReturnCode::SUCCESS) {
+    cout << "problem during sparse solve." << endl;
+    return 1;
+  }
+  err = real_t(0.);
+  for (size_t j=0; j<b_rows.size(); j++)
+    for (auto i : x_rows)
+      err = std::max(err, std::abs(Y(i, j) - X(i, b_rows[j])));
+  cout << "# SPARSE SOLVE RELATIVE ERROR = " << err / nrm << endl;
+  if (err / nrm > ERROR_TOLERANCE) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/*
+ * Compute the Schur complement S on the unknowns of the middle grid
+ * line of a k x k grid. Then, for a random x_S, solve
+ *   [A_II A_IS; A_SI A_SS] [x_I; x] = [0; S x_S],
+ * with the same solver, the solution should have x = x_S.
+ */
+template<typename scalar_t,typename integer_t>
+int test_schur_complement(int argc, const char* const argv[], int k) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  auto A = grid_matrix<scalar_t,integer_t>(k);
+  integer_t N = A.size();
+
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  vector<integer_t> schur;
+  for (integer_t y=k-1; y>=0; y--)
+    schur.push_back(k/2 + k * y);
+  spss.set_schur_indices(schur);
+  if (spss.reorder(k, k) != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  DenseMatrix<scalar_t> S;
+  if (spss.get_schur_complement(S) != ReturnCode::SUCCESS) {
+    cout << "problem computing the Schur complement." << endl;
+    return 1;
+  }
+  integer_t nS = schur.size();
+  DenseMatrix<scalar_t> xS(nS, 1), yS(nS, 1);
+  xS.random();
+  gemm(Trans::N, Trans::N, scalar_t(1.), S, xS, scalar_t(0.), yS);
+  DenseMatrix<scalar_t> b(N, 1), x(N, 1);
+  b.zero();
+  for (integer_t i=0; i<nS; i++)
+    b(schur[i], 0) = yS(i, 0);
+  spss.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  if (spss.solve(b, x) != ReturnCode::SUCCESS) {
+    cout << "problem during solve." << endl;
+    return 1;
+  }
+  real_t err(0.), nrm(0.);
+  for (integer_t i=0; i<nS; i++) {
+    err = std::max(err, std::abs(x(schur[i], 0) - xS(i, 0)));
+    nrm = std::max(nrm, std::abs(xS(i, 0)));
+  }
+  cout << "# SCHUR COMPLEMENT RELATIVE ERROR = " << err / nrm << endl;
+  if (err / nrm > ERROR_TOLERANCE) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename scalar_t,typename integer_t>
+int test(int argc, const char* const argv[], int k) {
+  int ierr = test_selected_inverse<scalar_t,integer_t>(argc, argv, k);
+  if (ierr) return ierr;
+  return test_schur_complement<scalar_t,integer_t>(argc, argv, k);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Compute selected entries of the inverse of a sparse matrix,\n"
+      << "and the Schur complement on the middle grid line,\n"
+      << "for a 5-point stencil on a k x k grid.\n\n"
+      << "Usage: \n\t./test_selected_inverse k" << endl;
+    return 1;
+  }
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+
+  int k = stoi(argv[1]);
+  int ierr = test<double,int>(argc, argv, k);
+  if (ierr) return ierr;
+  ierr = test<complex<double>,int>(argc, argv, k);
+  if (ierr) return ierr;
+  return test<double,long long int>(argc, argv, k);
+}
@@ -29,6 +29,9 @@
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <utility>
 using namespace std;
 
 #define ERROR_TOLERANCE 1e2
@@ -49,12 +52,77 @@ void abort_MPI(MPI_Comm *c, int *error, ...) {
   abort();
 }
 
+// read the file with the parallel matrix market reader, and read a
+// binary copy of A (on the root) with the parallel binary reader,
+// gather both and compare with A
+template<typename scalar_t,typename integer_t>
+int test_matrix_io(const string& f, const CSRMatrix<scalar_t,integer_t>& A) {
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  // CSRMatrixMPI stores the diagonal block of each row first, so the
+  // order within a row can differ from A
+  auto same = [&](const CSRMatrix<scalar_t,integer_t>& B) {
+    auto n = A.size();
+    if (B.size() != n || B.nnz() != A.nnz() ||
+        !std::equal(B.ptr(), B.ptr()+n+1, A.ptr()))
+      return false;
+    using E_t = std::pair<integer_t,scalar_t>;
+    auto less = [](const E_t& a, const E_t& b) { return a.first < b.first; };
+    std::vector<E_t> ra, rb;
+    for (integer_t r=0; r<n; r++) {
+      ra.clear();
+      rb.clear();
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++) {
+        ra.emplace_back(A.ind(j), A.val(j));
+        rb.emplace_back(B.ind(j), B.val(j));
+      }
+      std::sort(ra.begin(), ra.end(), less);
+      std::sort(rb.begin(), rb.end(), less);
+      if (ra != rb) return false;
+    }
+    return true;
+  };
+  CSRMatrixMPI<scalar_t,integer_t> Amm;
+  if (Amm.read_matrix_market(f)) {
+    if (!rank)
+      cout << "problem reading the matrix with MPI-IO." << endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  auto Bmm = Amm.gather();
+  if (!rank && !same(*Bmm)) {
+    cout << "parallel matrix market read does not match the input." << endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  string fname("test_sparse_mpi_matrix.bin");
+  if (!rank) A.print_binary(fname);
+  MPI_Barrier(MPI_COMM_WORLD);
+  CSRMatrixMPI<scalar_t,integer_t> Abin;
+  if (Abin.read_binary(fname)) {
+    if (!rank)
+      cout << "problem reading the binary matrix with MPI-IO." << endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  auto Bbin = Abin.gather();
+  if (!rank) {
+    if (!same(*Bbin)) {
+      cout << "parallel binary read does not match the input." << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    std::remove(fname.c_str());
+    cout << "# parallel matrix io OK" << endl;
+  }
+  return 0;
+}
+
 template<typename scalar_t,typename integer_t>
 int test_sparse_solver(int argc, const char* const argv[],
                        CSRMatrix<scalar_t,integer_t>& A) {
   using real_t = typename RealType<scalar_t>::value_type;
   int rank;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_matrix_io"))
+      test_matrix_io(argv[1], A);
   StrumpackSparseSolverMPIDist<scalar_t,integer_t> spss(MPI_COMM_WORLD);
   // spss.options().set_matching(MatchingJob::NONE);
   spss.options().set_from_command_line(argc, argv);
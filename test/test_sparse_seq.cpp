@@ -27,11 +27,16 @@
  *
  */
 #include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <cstring>
+#include <cstdio>
 using namespace std;
 
 #include "StrumpackSparseSolver.hpp"
 #include "sparse/CSRMatrix.hpp"
+#include "sparse/CSRMatrixMMap.hpp"
 #include "misc/RandomWrapper.hpp"
 
 using namespace strumpack;
@@ -39,10 +44,50 @@ using namespace strumpack;
 #define ERROR_TOLERANCE 1e2
 #define SOLVE_TOLERANCE 1e-12
 
+// write A in the binary format, read it back with read_binary and
+// with CSRMatrixMMap, and compare with A (from read_matrix_market)
+template<typename scalar_t,typename integer_t> int
+test_matrix_io(const CSRMatrix<scalar_t,integer_t>& A) {
+  string fname("test_sparse_seq_matrix.bin");
+  A.print_binary(fname);
+  auto n = A.size(), nnz = A.nnz();
+  auto same = [&](integer_t m, integer_t mnz, bool symm,
+                  const integer_t* ptr, const integer_t* ind,
+                  const scalar_t* val) {
+    return m == n && mnz == nnz && symm == A.symm_sparse() &&
+      std::equal(ptr, ptr+n+1, A.ptr()) &&
+      std::equal(ind, ind+nnz, A.ind()) &&
+      std::equal(val, val+nnz, A.val());
+  };
+  CSRMatrix<scalar_t,integer_t> B;
+  if (B.read_binary(fname) ||
+      !same(B.size(), B.nnz(), B.symm_sparse(), B.ptr(), B.ind(), B.val())) {
+    cout << "binary matrix does not match the input." << endl;
+    return 1;
+  }
+  try {
+    CSRMatrixMMap<scalar_t,integer_t> M(fname);
+    if (!same(M.size(), M.nnz(), M.symm_sparse(),
+              M.ptr(), M.ind(), M.val())) {
+      cout << "memory mapped matrix does not match the input." << endl;
+      return 1;
+    }
+  } catch (std::exception& e) {
+    cout << "problem mapping the binary matrix: " << e.what() << endl;
+    return 1;
+  }
+  std::remove(fname.c_str());
+  cout << "# binary matrix io OK" << endl;
+  return 0;
+}
+
 template<typename scalar_t,typename integer_t> int
 test_sparse_solver(int argc, const char* const argv[],
                    CSRMatrix<scalar_t,integer_t>& A) {
   using real_t = typename RealType<scalar_t>::value_type;
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_matrix_io") && test_matrix_io(A))
+      return 1;
   StrumpackSparseSolver<scalar_t,integer_t> spss;
   spss.options().set_from_command_line(argc, argv);
 
@@ -79,6 +124,54 @@ test_sparse_solver(int argc, const char* const argv[],
     cout << "RESIDUAL TOO LARGE!" << endl;
     return 1;
   }
+
+  // save the analysis (after factorization), and load it in a new
+  // solver, for the same sparsity pattern
+  bool analysis_io = false;
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_analysis_io")) analysis_io = true;
+  if (analysis_io) {
+    string fname("test_sparse_seq_analysis.bin"),
+      fname_bad("test_sparse_seq_analysis_truncated.bin");
+    if (spss.save_analysis(fname) != ReturnCode::SUCCESS) {
+      cout << "problem saving the analysis." << endl;
+      return 1;
+    }
+    {
+      // a truncated file should be rejected, without modifying the
+      // matrix, so the valid file can still be loaded afterwards
+      std::ifstream in(fname, std::ios::binary);
+      std::string data((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+      std::ofstream out(fname_bad, std::ios::binary);
+      out.write(data.data(), data.size() - data.size() / 4);
+    }
+    StrumpackSparseSolver<scalar_t,integer_t> spss2;
+    spss2.options().set_from_command_line(argc, argv);
+    spss2.set_matrix(A);
+    if (spss2.load_analysis(fname_bad) == ReturnCode::SUCCESS) {
+      cout << "loading a truncated analysis did not fail." << endl;
+      return 1;
+    }
+    std::remove(fname_bad.c_str());
+    if (spss2.load_analysis(fname) != ReturnCode::SUCCESS) {
+      cout << "problem loading the analysis." << endl;
+      return 1;
+    }
+    std::remove(fname.c_str());
+    if (spss2.factor() != ReturnCode::SUCCESS) {
+      cout << "problem during factorization of the matrix." << endl;
+      return 1;
+    }
+    spss2.solve(b.data(), x.data());
+    comp_scal_res = A.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (loaded analysis) = "
+         << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss2.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+  }
   return 0;
 }
 